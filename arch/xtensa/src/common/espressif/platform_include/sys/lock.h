@@ -43,9 +43,9 @@ struct __lock
 {
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-  int reserved[6];
+  int reserved[12];
 #  else
-  int reserved[9];
+  int reserved[10];
 #  endif
 #else
   int reserved[5];
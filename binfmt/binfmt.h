@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+
 #include <nuttx/binfmt/binfmt.h>
 
 /****************************************************************************
@@ -293,6 +295,52 @@ int elf_initialize(void);
  ****************************************************************************/
 
 void elf_uninitialize(void);
+
+#ifdef CONFIG_ELF_PRELINK
+/****************************************************************************
+ * Name: elf_prelink_load
+ *
+ * Description:
+ *   Load a program from the cache of relocated images.
+ *
+ * Returned Value:
+ *   0 (OK) on a hit; -ENOENT or -EBUSY if the program must be loaded from
+ *   the file; any other negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int elf_prelink_load(FAR struct binary_s *binp, FAR const char *filename,
+                     FAR const struct symtab_s *exports, int nexports);
+
+/****************************************************************************
+ * Name: elf_prelink_insert
+ *
+ * Description:
+ *   Add a freshly loaded and relocated program image to the cache.  Must be
+ *   called before the program starts.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void elf_prelink_insert(FAR struct binary_s *binp, FAR const char *filename,
+                        FAR const struct symtab_s *exports, int nexports,
+                        size_t datasize);
+
+/****************************************************************************
+ * Name: elf_prelink_release
+ *
+ * Description:
+ *   Return a program image to the cache when the program is unloaded.
+ *
+ * Returned Value:
+ *   true if the image is owned by the cache and must not be freed.
+ *
+ ****************************************************************************/
+
+bool elf_prelink_release(FAR struct binary_s *binp);
+#endif
 #endif
 
 #ifdef CONFIG_NXFLAT
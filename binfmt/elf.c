@@ -102,6 +102,16 @@ static int elf_loadbinary(FAR struct binary_s *binp,
 
   binfo("Loading file: %s\n", filename);
 
+#ifdef CONFIG_ELF_PRELINK
+  /* Reuse the relocated image from an earlier exec if there is one */
+
+  ret = elf_prelink_load(binp, filename, exports, nexports);
+  if (ret != -ENOENT && ret != -EBUSY)
+    {
+      return ret;
+    }
+#endif
+
   /* Initialize the ELF library to load the program binary. */
 
   ret = libelf_initialize(filename, &loadinfo);
@@ -235,6 +245,10 @@ static int elf_loadbinary(FAR struct binary_s *binp,
     }
 #endif
 
+#ifdef CONFIG_ELF_PRELINK
+  elf_prelink_insert(binp, filename, exports, nexports, loadinfo.datasize);
+#endif
+
   libelf_uninitialize(&loadinfo);
   return OK;
 
@@ -256,6 +270,14 @@ errout_with_init:
 static int elf_unloadbinary(FAR struct binary_s *binp)
 {
   binfo("Unloading %p\n", binp);
+
+#ifdef CONFIG_ELF_PRELINK
+  if (elf_prelink_release(binp))
+    {
+      return OK;
+    }
+#endif
+
   libelf_uninit(&binp->mod);
 
   return OK;
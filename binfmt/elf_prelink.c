@@ -0,0 +1,418 @@
+/****************************************************************************
+ * binfmt/elf_prelink.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <nuttx/debug.h>
+
+#include <nuttx/fs/fs.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/sched.h>
+#include <nuttx/binfmt/binfmt.h>
+
+#include "binfmt.h"
+
+#ifdef CONFIG_ELF_PRELINK
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One relocated program image.  The text (and the GOT, if any) are used
+ * in place by every exec of the same file.  The data region is also reused
+ * but has to be restored from the pristine copy first, so an image can
+ * only back one running instance at a time.
+ */
+
+struct elf_prelink_s
+{
+  FAR char *path;                      /* Path used to exec the file */
+  ino_t ino;                           /* File identity ... */
+  off_t size;
+  struct timespec mtime;               /* ... and version */
+  FAR const struct symtab_s *exports;  /* Symbol table the image was bound */
+  int nexports;                        /* against */
+  struct module_s mod;                 /* Text/data and fini array */
+  main_t entrypt;                      /* Program entry point */
+#ifdef CONFIG_PIC
+  FAR void *gotaddr;                   /* D-Space region */
+#endif
+  FAR void *data;                      /* Pristine copy of the data */
+  size_t datasize;                     /* Size of data */
+  uint32_t lastuse;                    /* For LRU replacement */
+  bool busy;                           /* An instance is running */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct elf_prelink_s g_prelink[CONFIG_ELF_PRELINK_NENTRIES];
+static mutex_t g_prelink_lock = NXMUTEX_INITIALIZER;
+static uint32_t g_prelink_clock;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_prelink_match
+ ****************************************************************************/
+
+static bool elf_prelink_match(FAR const struct elf_prelink_s *entry,
+                              FAR const char *filename,
+                              FAR const struct stat *buf,
+                              FAR const struct symtab_s *exports,
+                              int nexports)
+{
+  return entry->path != NULL &&
+         entry->ino == buf->st_ino &&
+         entry->size == buf->st_size &&
+         entry->mtime.tv_sec == buf->st_mtim.tv_sec &&
+         entry->mtime.tv_nsec == buf->st_mtim.tv_nsec &&
+         entry->exports == exports &&
+         entry->nexports == nexports &&
+         strcmp(entry->path, filename) == 0;
+}
+
+/****************************************************************************
+ * Name: elf_prelink_evict
+ *
+ * Description:
+ *   Release the image held by an idle cache entry.
+ *
+ ****************************************************************************/
+
+static void elf_prelink_evict(FAR struct elf_prelink_s *entry)
+{
+  DEBUGASSERT(!entry->busy);
+
+  if (entry->path != NULL)
+    {
+      /* The destructors already ran when the last instance was unloaded */
+
+      entry->mod.nfini = 0;
+      libelf_uninit(&entry->mod);
+
+      kmm_free(entry->data);
+      kmm_free(entry->path);
+    }
+
+  memset(entry, 0, sizeof(struct elf_prelink_s));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: elf_prelink_load
+ *
+ * Description:
+ *   Try to satisfy a load from the cache.  On a hit the cached image is
+ *   reset to its state right after relocation and handed to binp, so that
+ *   neither the file nor the symbol tables have to be read again.
+ *
+ * Returned Value:
+ *   0 (OK) on a hit.  -ENOENT if the file is not cached (or has changed),
+ *   -EBUSY if the cached image is in use by a running instance.  Any other
+ *   negated errno value is a failure the caller should report.
+ *
+ ****************************************************************************/
+
+int elf_prelink_load(FAR struct binary_s *binp, FAR const char *filename,
+                     FAR const struct symtab_s *exports, int nexports)
+{
+  FAR struct elf_prelink_s *entry = NULL;
+  struct stat buf;
+  int ret;
+  int i;
+
+  ret = nx_stat(filename, &buf, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = nxmutex_lock(&g_prelink_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (i = 0; i < CONFIG_ELF_PRELINK_NENTRIES; i++)
+    {
+      if (g_prelink[i].path != NULL &&
+          strcmp(g_prelink[i].path, filename) == 0)
+        {
+          entry = &g_prelink[i];
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      ret = -ENOENT;
+      goto errout_with_lock;
+    }
+
+  if (entry->busy)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  if (!elf_prelink_match(entry, filename, &buf, exports, nexports))
+    {
+      /* The file was replaced or the symbol table changed */
+
+      binfo("Discarding stale image of %s\n", filename);
+      elf_prelink_evict(entry);
+      ret = -ENOENT;
+      goto errout_with_lock;
+    }
+
+#ifdef CONFIG_SCHED_USER_IDENTITY
+  binp->uid  = buf.st_uid;
+  binp->gid  = buf.st_gid;
+  binp->mode = buf.st_mode;
+
+  ret = binfmt_checkexecperm(binp);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
+#ifdef CONFIG_PIC
+  if (entry->gotaddr != NULL)
+    {
+      FAR struct dspace_s *dspaces = kmm_zalloc(sizeof(struct dspace_s));
+
+      if (dspaces == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_lock;
+        }
+
+      dspaces->region = entry->gotaddr;
+      dspaces->crefs  = 1;
+      binp->picbase   = (FAR void *)dspaces;
+    }
+#endif
+
+  /* Restore the data as it was right after relocation */
+
+  if (entry->datasize > 0)
+    {
+      memcpy(entry->mod.dataalloc, entry->data, entry->datasize);
+    }
+
+  memcpy(&binp->mod, &entry->mod, sizeof(struct module_s));
+  binp->entrypt   = entry->entrypt;
+  binp->stacksize = CONFIG_ELF_STACKSIZE;
+
+  entry->busy     = true;
+  entry->lastuse  = ++g_prelink_clock;
+
+  binfo("Using prelinked image of %s\n", filename);
+
+errout_with_lock:
+  nxmutex_unlock(&g_prelink_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: elf_prelink_insert
+ *
+ * Description:
+ *   Hand a freshly loaded and relocated image over to the cache.  This must
+ *   be called before the program runs, since the current content of the
+ *   data region becomes the pristine copy.  The image is marked busy; it
+ *   is released by elf_prelink_release() when the program is unloaded.
+ *
+ *   Failing to insert is not an error, the image just stays private to
+ *   binp and is freed normally.
+ *
+ ****************************************************************************/
+
+void elf_prelink_insert(FAR struct binary_s *binp, FAR const char *filename,
+                        FAR const struct symtab_s *exports, int nexports,
+                        size_t datasize)
+{
+  FAR struct elf_prelink_s *entry = NULL;
+  struct stat buf;
+  int i;
+
+#if CONFIG_LIBC_ELF_MAXDEPEND > 0
+  /* The image refers to symbols of installed modules, which may be removed
+   * while the image is idle in the cache.
+   */
+
+  if (binp->mod.dependencies[0] != NULL)
+    {
+      return;
+    }
+#endif
+
+  if (nx_stat(filename, &buf, 1) < 0 ||
+      nxmutex_lock(&g_prelink_lock) < 0)
+    {
+      return;
+    }
+
+  /* Pick an empty entry, or else the least recently used idle one.  Don't
+   * cache a second copy of a file that is already cached and running.
+   */
+
+  for (i = 0; i < CONFIG_ELF_PRELINK_NENTRIES; i++)
+    {
+      FAR struct elf_prelink_s *tmp = &g_prelink[i];
+
+      if (tmp->path != NULL && strcmp(tmp->path, filename) == 0)
+        {
+          entry = tmp->busy ? NULL : tmp;
+          break;
+        }
+
+      if (tmp->busy)
+        {
+          continue;
+        }
+
+      if (entry == NULL || (entry->path != NULL &&
+          (tmp->path == NULL || tmp->lastuse < entry->lastuse)))
+        {
+          entry = tmp;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      goto out_with_lock;
+    }
+
+  elf_prelink_evict(entry);
+
+  entry->path = kmm_malloc(strlen(filename) + 1);
+  entry->data = datasize > 0 ? kmm_malloc(datasize) : NULL;
+  if (entry->path == NULL || (datasize > 0 && entry->data == NULL))
+    {
+      kmm_free(entry->path);
+      kmm_free(entry->data);
+      entry->path = NULL;
+      entry->data = NULL;
+      goto out_with_lock;
+    }
+
+  strcpy(entry->path, filename);
+  if (datasize > 0)
+    {
+      memcpy(entry->data, binp->mod.dataalloc, datasize);
+    }
+
+  entry->ino       = buf.st_ino;
+  entry->size      = buf.st_size;
+  entry->mtime     = buf.st_mtim;
+  entry->exports   = exports;
+  entry->nexports  = nexports;
+  entry->entrypt   = binp->entrypt;
+  entry->datasize  = datasize;
+#ifdef CONFIG_PIC
+  entry->gotaddr   = binp->picbase != NULL ?
+                     ((FAR struct dspace_s *)binp->picbase)->region : NULL;
+#endif
+  entry->busy      = true;
+  entry->lastuse   = ++g_prelink_clock;
+  memcpy(&entry->mod, &binp->mod, sizeof(struct module_s));
+
+  binfo("Cached prelinked image of %s\n", filename);
+
+out_with_lock:
+  nxmutex_unlock(&g_prelink_lock);
+}
+
+/****************************************************************************
+ * Name: elf_prelink_release
+ *
+ * Description:
+ *   Called when a program is unloaded.  If its image belongs to the cache,
+ *   run the destructors and mark the image idle instead of freeing it.
+ *
+ * Returned Value:
+ *   true if the image is owned by the cache; false if the caller has to
+ *   free it.
+ *
+ ****************************************************************************/
+
+bool elf_prelink_release(FAR struct binary_s *binp)
+{
+  FAR struct elf_prelink_s *entry = NULL;
+  FAR void (**array)(void);
+  int i;
+
+  nxmutex_lock(&g_prelink_lock);
+
+  for (i = 0; i < CONFIG_ELF_PRELINK_NENTRIES; i++)
+    {
+      if (g_prelink[i].busy &&
+          g_prelink[i].mod.textalloc == binp->mod.textalloc &&
+          g_prelink[i].mod.dataalloc == binp->mod.dataalloc)
+        {
+          entry = &g_prelink[i];
+          break;
+        }
+    }
+
+  nxmutex_unlock(&g_prelink_lock);
+
+  if (entry == NULL)
+    {
+      return false;
+    }
+
+  /* A busy entry is never evicted, so the destructors can run without
+   * holding the lock.
+   */
+
+  array = (FAR void (**)(void))binp->mod.finiarr;
+  for (i = 0; i < binp->mod.nfini; i++)
+    {
+      array[i]();
+    }
+
+  nxmutex_lock(&g_prelink_lock);
+  entry->busy = false;
+  nxmutex_unlock(&g_prelink_lock);
+  return true;
+}
+
+#endif /* CONFIG_ELF_PRELINK */
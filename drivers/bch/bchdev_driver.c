@@ -41,6 +41,7 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
+#include <nuttx/sched.h>
 #include <nuttx/drivers/drivers.h>
 
 #include "bch.h"
@@ -297,6 +298,7 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR struct inode *inode = filep->f_inode;
   FAR struct bchlib_s *bch;
   ssize_t ret;
+  bool iowait;
 
   DEBUGASSERT(inode->i_private);
   bch = inode->i_private;
@@ -307,7 +309,9 @@ static ssize_t bch_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
+  iowait = nxsched_iowait_begin();
   ret = bchlib_read(bch, buffer, filep->f_pos, len);
+  nxsched_iowait_end(iowait);
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -327,6 +331,7 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode = filep->f_inode;
   FAR struct bchlib_s *bch;
   ssize_t ret = -EACCES;
+  bool iowait;
 
   DEBUGASSERT(inode->i_private);
   bch = inode->i_private;
@@ -339,7 +344,9 @@ static ssize_t bch_write(FAR struct file *filep, FAR const char *buffer,
           return ret;
         }
 
+      iowait = nxsched_iowait_begin();
       ret = bchlib_write(bch, buffer, filep->f_pos, len);
+      nxsched_iowait_end(iowait);
       if (ret > 0)
         {
           filep->f_pos += ret;
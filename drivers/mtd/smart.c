@@ -127,6 +127,18 @@
 
 #define SMART_MAX_ALLOCS        10
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+#  define SMART_CP_VERSION      1
+#  define SMART_CP_MAGIC        "SMCP"
+
+#  define SMART_CP_DISABLED     0     /* No usable checkpoint area */
+#  define SMART_CP_STALE        1     /* FLASH copy is unusable */
+#  define SMART_CP_VALID        2     /* FLASH copy plus journal match RAM */
+#else
+#  define smart_checkpoint_invalidate(d)
+#  define smart_checkpoint_journal(d, b)
+#endif
+
 #ifndef CONFIG_MTD_SMART_ALLOC_DEBUG
 #define smart_malloc(d, b, n)   kmm_malloc(b)
 #define smart_zalloc(d, b, n)   kmm_zalloc(b)
@@ -299,8 +311,51 @@ struct smart_struct_s
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR uint8_t          *cpbuffer;         /* One MTD block for checkpoint I/O */
+  FAR uint8_t          *cpjmap;           /* Erase blocks in the journal */
+  uint32_t              cpblock;          /* First erase block of the area */
+  uint32_t              cpjstart;         /* Byte address of the journal */
+  uint32_t              cpentries;        /* Capacity of the journal */
+  uint32_t              cpnext;           /* Next free journal entry */
+  uint8_t               cpstate;          /* See SMART_CP_* */
+#endif
+};
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+/* Map checkpoint header.  It occupies the first MTD block of the
+ * checkpoint area, the sector map with the release and free counts follows
+ * in the next MTD block and the journal starts on the MTD block after the
+ * map.
+ */
+
+struct smart_checkpoint_s
+{
+  uint8_t               state;            /* Erased while usable */
+  uint8_t               version;          /* SMART_CP_VERSION */
+  uint8_t               formatversion;    /* Format version on the device */
+  uint8_t               namesize;         /* Length of filenames */
+  uint8_t               magic[4];         /* SMART_CP_MAGIC */
+  uint16_t              sectorsize;       /* Sector size on device */
+  uint16_t              totalsectors;     /* Total number of sectors */
+  uint16_t              neraseblocks;     /* Number of erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint16_t              journal;          /* MTD block offset of the journal */
+  uint32_t              crc;              /* CRC-32 of the above and the map */
 };
 
+/* Journal entry.  An erase block is recorded once, before the first
+ * change to it after the checkpoint reaches the FLASH.
+ */
+
+struct smart_cpentry_s
+{
+  uint16_t              block;            /* Erase block number */
+  uint16_t              check;            /* One's complement of block */
+};
+#endif
+
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
 struct smart_multiroot_device_s
 {
@@ -452,6 +507,14 @@ static int     smart_relocate_sector(FAR struct smart_struct_s *dev,
 static int     smart_fsck(FAR struct smart_struct_s *dev);
 #endif
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int     smart_checkpoint_write(FAR struct smart_struct_s *dev);
+static int     smart_checkpoint_sync(FAR struct smart_struct_s *dev);
+static void    smart_checkpoint_invalidate(FAR struct smart_struct_s *dev);
+static void    smart_checkpoint_journal(FAR struct smart_struct_s *dev,
+                                        uint16_t block);
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                                size_t buflen);
@@ -514,6 +577,13 @@ static int smart_open(FAR struct inode *inode)
 static int smart_close(FAR struct inode *inode)
 {
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Leave a fresh checkpoint behind on a clean unmount */
+
+  smart_checkpoint_sync(inode->i_private);
+#endif
+
   return OK;
 }
 
@@ -951,6 +1021,10 @@ static ssize_t smart_write(FAR struct inode *inode,
 
   /* I think maybe we need to lock on a mutex here */
 
+  /* Raw writes bypass the sector map, the journal can't describe them */
+
+  smart_checkpoint_invalidate(dev);
+
   /* Get the aligned block.  Here it is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -2617,6 +2691,768 @@ err_out:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_checkpoint_isset
+ *
+ * Description:  Tests if an erase block is set in a journal bitmap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static inline bool smart_checkpoint_isset(FAR const uint8_t *map,
+                                          uint16_t block)
+{
+  return (map[block >> 3] & (1 << (block & 0x07))) != 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_crc
+ *
+ * Description:  Calculates the CRC of a checkpoint header and the sector
+ *               map.  The state byte is programmed when the checkpoint goes
+ *               stale, so it is left out.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static uint32_t smart_checkpoint_crc(FAR const struct smart_checkpoint_s *cp,
+                                     FAR const uint8_t *map, size_t mapsize)
+{
+  uint32_t crc;
+
+  crc = crc32((FAR const uint8_t *)cp + 1,
+              offsetof(struct smart_checkpoint_s, crc) - 1);
+  return crc32part(map, mapsize, crc);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_program
+ *
+ * Description:  Programs a few bytes within one MTD block of the checkpoint
+ *               area.  This is smart_bytewrite() with a private buffer, as
+ *               the journal is written while dev->rwbuffer holds the sector
+ *               that is about to be written.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_program(FAR struct smart_struct_s *dev,
+                                    size_t offset, FAR const void *buffer,
+                                    size_t nbytes)
+{
+  uint32_t block;
+  ssize_t  ret;
+
+#ifdef CONFIG_MTD_BYTE_WRITE
+  if (dev->mtd->write != NULL)
+    {
+      ret = dev->mtd->write(dev->mtd, offset, nbytes, buffer);
+      return ret < 0 ? ret : OK;
+    }
+#endif
+
+  block = offset / dev->geo.blocksize;
+  ret = MTD_BREAD(dev->mtd, block, 1, dev->cpbuffer);
+  if (ret != 1)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  memcpy(&dev->cpbuffer[offset - block * dev->geo.blocksize], buffer,
+         nbytes);
+
+  ret = MTD_BWRITE(dev->mtd, block, 1, dev->cpbuffer);
+  if (ret != 1)
+    {
+      return ret < 0 ? ret : -EIO;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_invalidate
+ *
+ * Description:  Marks the checkpoint on the FLASH as stale.  Called before
+ *               any change the journal can't describe.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_checkpoint_invalidate(FAR struct smart_struct_s *dev)
+{
+  uint8_t state = (uint8_t)~CONFIG_SMARTFS_ERASEDSTATE;
+  int     ret;
+
+  if (dev->cpstate != SMART_CP_VALID)
+    {
+      return;
+    }
+
+  dev->cpstate = SMART_CP_STALE;
+
+  ret = smart_checkpoint_program(dev, dev->cpblock * dev->geo.erasesize,
+                                 &state, 1);
+  if (ret < 0)
+    {
+      /* Erasing the area is just as good */
+
+      ret = MTD_ERASE(dev->mtd, dev->cpblock,
+                      CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS);
+      if (ret < 0)
+        {
+          ferr("ERROR: Unable to invalidate the map checkpoint: %d\n", ret);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_journal
+ *
+ * Description:  Records an erase block in the checkpoint journal.  Must be
+ *               called before the erase block is written or erased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_checkpoint_journal(FAR struct smart_struct_s *dev,
+                                     uint16_t block)
+{
+  struct smart_cpentry_s entry;
+
+  if (dev->cpstate != SMART_CP_VALID ||
+      smart_checkpoint_isset(dev->cpjmap, block))
+    {
+      return;
+    }
+
+  if (dev->cpnext < dev->cpentries)
+    {
+      entry.block = block;
+      entry.check = ~block;
+
+      if (smart_checkpoint_program(dev, dev->cpjstart +
+                                   dev->cpnext * sizeof(entry),
+                                   &entry, sizeof(entry)) == OK)
+        {
+          dev->cpjmap[block >> 3] |= 1 << (block & 0x07);
+          dev->cpnext++;
+          return;
+        }
+    }
+
+  /* The journal is full or can't be written.  Fall back to the full scan
+   * until the next checkpoint is written.
+   */
+
+  smart_checkpoint_invalidate(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_write
+ *
+ * Description:  Writes the sector map to the checkpoint area and starts a
+ *               new, empty journal.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_write(FAR struct smart_struct_s *dev)
+{
+  FAR struct smart_checkpoint_s *cp;
+  FAR const uint8_t *map;
+  uint32_t blocksize = dev->geo.blocksize;
+  uint32_t areablocks;
+  uint32_t mapblocks;
+  uint32_t mapsize;
+  uint32_t start;
+  ssize_t  ret;
+
+  if (dev->cpstate == SMART_CP_DISABLED ||
+      dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+  /* Sectors that are allocated but not yet written only exist in RAM */
+
+  if (dev->allocsector != NULL)
+    {
+      return -EBUSY;
+    }
+#endif
+
+  map        = (FAR const uint8_t *)dev->smap;
+  mapsize    = dev->totalsectors * sizeof(uint16_t) + 2 * dev->neraseblocks;
+  mapblocks  = (mapsize + blocksize - 1) / blocksize;
+  areablocks = CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS *
+               (dev->geo.erasesize / blocksize);
+  start      = dev->cpblock * (dev->geo.erasesize / blocksize);
+
+  if (1 + mapblocks >= areablocks)
+    {
+      ferr("ERROR: Checkpoint area too small for %" PRIu32 " map bytes\n",
+           mapsize);
+      smart_checkpoint_invalidate(dev);
+      dev->cpstate = SMART_CP_DISABLED;
+      return -ENOSPC;
+    }
+
+  /* Make sure an interrupted update can never look valid */
+
+  smart_checkpoint_invalidate(dev);
+
+  ret = MTD_ERASE(dev->mtd, dev->cpblock,
+                  CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Write the map.  A partial last MTD block goes through cpbuffer. */
+
+  if (mapsize / blocksize > 0)
+    {
+      ret = MTD_BWRITE(dev->mtd, start + 1, mapsize / blocksize, map);
+      if (ret != mapsize / blocksize)
+        {
+          goto errout;
+        }
+    }
+
+  if (mapsize % blocksize != 0)
+    {
+      memset(dev->cpbuffer, CONFIG_SMARTFS_ERASEDSTATE, blocksize);
+      memcpy(dev->cpbuffer, &map[mapsize - mapsize % blocksize],
+             mapsize % blocksize);
+
+      ret = MTD_BWRITE(dev->mtd, start + mapblocks, 1, dev->cpbuffer);
+      if (ret != 1)
+        {
+          goto errout;
+        }
+    }
+
+  /* The header goes last, it is what makes the checkpoint valid */
+
+  memset(dev->cpbuffer, CONFIG_SMARTFS_ERASEDSTATE, blocksize);
+  cp = (FAR struct smart_checkpoint_s *)dev->cpbuffer;
+  cp->version        = SMART_CP_VERSION;
+  cp->formatversion  = dev->formatversion;
+  cp->namesize       = dev->namesize;
+  memcpy(cp->magic, SMART_CP_MAGIC, sizeof(cp->magic));
+  cp->sectorsize     = dev->sectorsize;
+  cp->totalsectors   = dev->totalsectors;
+  cp->neraseblocks   = dev->neraseblocks;
+  cp->freesectors    = dev->freesectors;
+  cp->releasesectors = dev->releasesectors;
+  cp->journal        = 1 + mapblocks;
+  cp->crc            = smart_checkpoint_crc(cp, map, mapsize);
+
+  ret = MTD_BWRITE(dev->mtd, start, 1, dev->cpbuffer);
+  if (ret != 1)
+    {
+      goto errout;
+    }
+
+  dev->cpjstart  = (start + 1 + mapblocks) * blocksize;
+  dev->cpentries = (areablocks - 1 - mapblocks) * blocksize /
+                   sizeof(struct smart_cpentry_s);
+  dev->cpnext    = 0;
+  dev->cpstate   = SMART_CP_VALID;
+  memset(dev->cpjmap, 0, (dev->neraseblocks + 7) >> 3);
+
+  finfo("Map checkpoint written, %" PRIu32 " journal entries\n",
+        dev->cpentries);
+  return OK;
+
+errout:
+  ferr("ERROR: Writing the map checkpoint failed: %zd\n", ret);
+
+  /* The area is erased or has no valid header.  Don't retry on every
+   * request.
+   */
+
+  dev->cpstate = SMART_CP_DISABLED;
+  return ret < 0 ? ret : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_sync
+ *
+ * Description:  Rewrites the checkpoint if anything changed since it was
+ *               written.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_sync(FAR struct smart_struct_s *dev)
+{
+  if (dev->cpstate == SMART_CP_STALE ||
+      (dev->cpstate == SMART_CP_VALID && dev->cpnext > 0))
+    {
+      return smart_checkpoint_write(dev);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_update
+ *
+ * Description:  Called between requests.  Rewrites the checkpoint if it is
+ *               stale or the journal passed the threshold.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_checkpoint_update(FAR struct smart_struct_s *dev)
+{
+  if (dev->cpstate == SMART_CP_STALE ||
+      (dev->cpstate == SMART_CP_VALID &&
+       dev->cpnext * 100 >=
+       (uint32_t)dev->neraseblocks * CONFIG_MTD_SMART_CHECKPOINT_THRESHOLD))
+    {
+      smart_checkpoint_write(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_seq
+ *
+ * Description:  Returns the sequence number of a sector header and the
+ *               value above which it is considered about to wrap.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static uint16_t smart_checkpoint_seq(FAR struct smart_sect_header_s *header,
+                                     FAR uint16_t *seqwrap)
+{
+#if SMART_STATUS_VERSION == 1
+  if ((header->status & SMART_STATUS_CRC) !=
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_CRC))
+    {
+      *seqwrap = 0xf0;
+      return header->seq;
+    }
+
+  *seqwrap = 0xfff0;
+  return *((FAR uint16_t *)&header->seq);
+#else
+  *seqwrap = 0xf0;
+  return header->seq;
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_rescan
+ *
+ * Description:  Reads back the header of one physical sector on top of the
+ *               loaded checkpoint.  This is the body of the smart_scan()
+ *               loop, including resolving duplicate logical sectors.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_rescan(FAR struct smart_struct_s *dev,
+                                   uint16_t sector)
+{
+  struct smart_sect_header_s header;
+  uint32_t readaddress;
+  uint16_t logicalsector;
+  uint16_t winner;
+  uint16_t loser;
+  uint16_t seq1;
+  uint16_t seq2;
+  uint16_t seqwrap;
+  ssize_t  ret;
+
+  readaddress = sector * dev->mtdblkspersector * dev->geo.blocksize;
+  ret = MTD_READ(dev->mtd, readaddress, sizeof(struct smart_sect_header_s),
+                 (FAR uint8_t *)&header);
+  if (ret != sizeof(struct smart_sect_header_s))
+    {
+      return -EIO;
+    }
+
+  logicalsector = *((FAR uint16_t *)header.logicalsector);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+  if (logicalsector == 0)
+    {
+      logicalsector = -1;
+    }
+#endif
+
+  if ((header.status & SMART_STATUS_COMMITTED) ==
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+    {
+      return OK;
+    }
+
+  dev->freecount[sector / dev->sectorsperblk]--;
+  dev->freesectors--;
+
+  if ((header.status & SMART_STATUS_RELEASED) !=
+          (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+    {
+      dev->releasecount[sector / dev->sectorsperblk]++;
+      dev->releasesectors++;
+      return OK;
+    }
+
+  if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION ||
+      logicalsector >= dev->totalsectors)
+    {
+      return OK;
+    }
+
+  winner = sector;
+  loser  = dev->smap[logicalsector];
+
+  if (loser != 0xffff)
+    {
+      /* Two physical sectors claim this logical sector, an update was
+       * interrupted.  The higher sequence number wins.
+       */
+
+      seq2 = smart_checkpoint_seq(&header, &seqwrap);
+
+      readaddress = loser * dev->mtdblkspersector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddress,
+                     sizeof(struct smart_sect_header_s),
+                     (FAR uint8_t *)&header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          return -EIO;
+        }
+
+      seq1 = smart_checkpoint_seq(&header, &seqwrap);
+      if (!((seq1 > seqwrap && seq2 < 10) || seq2 > seq1))
+        {
+          winner = loser;
+          loser  = sector;
+        }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+      ret = MTD_BREAD(dev->mtd, winner * dev->mtdblkspersector,
+                      dev->mtdblkspersector, (FAR uint8_t *)dev->rwbuffer);
+      if (ret == dev->mtdblkspersector)
+        {
+          ret = smart_validate_crc(dev);
+        }
+
+      if (ret != OK)
+        {
+          /* The winner has a CRC error, keep the other copy */
+
+          loser  = winner;
+          winner = loser == sector ? dev->smap[logicalsector] : sector;
+        }
+#endif
+
+      finfo("Duplicate Sector winner=%d, loser=%d\n", winner, loser);
+
+      /* Release the loser */
+
+      readaddress = loser * dev->mtdblkspersector * dev->geo.blocksize;
+      ret = MTD_READ(dev->mtd, readaddress,
+                     sizeof(struct smart_sect_header_s),
+                     (FAR uint8_t *)&header);
+      if (ret != sizeof(struct smart_sect_header_s))
+        {
+          return -EIO;
+        }
+
+#if CONFIG_SMARTFS_ERASEDSTATE == 0xff
+      header.status &= ~SMART_STATUS_RELEASED;
+#else
+      header.status |= SMART_STATUS_RELEASED;
+#endif
+
+      smart_checkpoint_journal(dev, loser / dev->sectorsperblk);
+      ret = smart_bytewrite(dev, readaddress +
+                            offsetof(struct smart_sect_header_s, status),
+                            1, &header.status);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      dev->releasecount[loser / dev->sectorsperblk]++;
+      dev->releasesectors++;
+    }
+
+  dev->smap[logicalsector] = winner;
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_replay
+ *
+ * Description:  Reads back the sector headers of the erase blocks in the
+ *               journal on top of the loaded checkpoint.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_replay(FAR struct smart_struct_s *dev)
+{
+  FAR uint8_t *pending;
+  size_t       mapbytes = (dev->neraseblocks + 7) >> 3;
+  uint16_t     prerelease;
+  uint16_t     block;
+  int          sector;
+  int          ret = OK;
+
+  if (dev->cpnext == 0)
+    {
+      return OK;
+    }
+
+  /* Releasing a duplicate sector journals its erase block, so work from a
+   * copy of the erase blocks journaled before the boot.
+   */
+
+  pending = (FAR uint8_t *)smart_malloc(dev, mapbytes, "Replay");
+  if (pending == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(pending, dev->cpjmap, mapbytes);
+
+  /* Forget all mappings into those erase blocks */
+
+  for (sector = 0; sector < dev->totalsectors; sector++)
+    {
+      if (dev->smap[sector] != 0xffff &&
+          smart_checkpoint_isset(pending,
+                                 dev->smap[sector] / dev->sectorsperblk))
+        {
+          dev->smap[sector] = 0xffff;
+        }
+    }
+
+  for (block = 0; block < dev->neraseblocks && ret >= 0; block++)
+    {
+      if (!smart_checkpoint_isset(pending, block))
+        {
+          continue;
+        }
+
+      if (block == dev->neraseblocks - 1 && dev->totalsectors == 65534)
+        {
+          prerelease = 2;
+        }
+      else
+        {
+          prerelease = 0;
+        }
+
+      /* Back out the checkpointed counts of the block */
+
+      dev->freesectors    += dev->availsectperblk - prerelease -
+                             dev->freecount[block];
+      dev->releasesectors -= dev->releasecount[block] - prerelease;
+      dev->freecount[block]    = dev->availsectperblk - prerelease;
+      dev->releasecount[block] = prerelease;
+
+      for (sector = block * dev->sectorsperblk;
+           sector < (block + 1) * dev->sectorsperblk &&
+           sector < dev->totalsectors; sector++)
+        {
+          ret = smart_checkpoint_rescan(dev, sector);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+    }
+
+  smart_free(dev, pending);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_checkpoint_load
+ *
+ * Description:  Loads the sector map from the checkpoint area and replays
+ *               the journal.  This replaces smart_scan() at boot.  If there
+ *               is no usable checkpoint, a negated errno is returned and
+ *               the caller has to do the full scan.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_checkpoint_load(FAR struct smart_struct_s *dev)
+{
+  FAR struct smart_cpentry_s *entry;
+  struct smart_checkpoint_s cp;
+  FAR uint8_t *map;
+  uint32_t blocksize = dev->geo.blocksize;
+  uint32_t perblock = blocksize / sizeof(struct smart_cpentry_s);
+  uint32_t areablocks;
+  uint32_t mapblocks;
+  uint32_t mapsize;
+  uint32_t start;
+  ssize_t  ret;
+
+  if (dev->cpstate == SMART_CP_DISABLED)
+    {
+      return -ENOSYS;
+    }
+
+  areablocks = CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS *
+               (dev->geo.erasesize / blocksize);
+  start      = dev->cpblock * (dev->geo.erasesize / blocksize);
+
+  ret = MTD_BREAD(dev->mtd, start, 1, dev->cpbuffer);
+  if (ret != 1)
+    {
+      return -EIO;
+    }
+
+  memcpy(&cp, dev->cpbuffer, sizeof(cp));
+  if (cp.state != CONFIG_SMARTFS_ERASEDSTATE ||
+      memcmp(cp.magic, SMART_CP_MAGIC, sizeof(cp.magic)) != 0 ||
+      cp.version != SMART_CP_VERSION ||
+      cp.neraseblocks != dev->geo.neraseblocks)
+    {
+      finfo("No map checkpoint\n");
+      return -ENOENT;
+    }
+
+  /* The FLASH holds a checkpoint from here on.  Any failure must
+   * invalidate it, as the full scan may change the device.
+   */
+
+  dev->cpstate = SMART_CP_VALID;
+
+  ret = smart_setsectorsize(dev, cp.sectorsize);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  map       = (FAR uint8_t *)dev->smap;
+  mapsize   = dev->totalsectors * sizeof(uint16_t) + 2 * dev->neraseblocks;
+  mapblocks = (mapsize + blocksize - 1) / blocksize;
+
+  if (cp.totalsectors != dev->totalsectors || cp.journal != 1 + mapblocks ||
+      1 + mapblocks >= areablocks)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  if (mapsize / blocksize > 0)
+    {
+      ret = MTD_BREAD(dev->mtd, start + 1, mapsize / blocksize, map);
+      if (ret != mapsize / blocksize)
+        {
+          ret = -EIO;
+          goto errout;
+        }
+    }
+
+  if (mapsize % blocksize != 0)
+    {
+      ret = MTD_BREAD(dev->mtd, start + mapblocks, 1, dev->cpbuffer);
+      if (ret != 1)
+        {
+          ret = -EIO;
+          goto errout;
+        }
+
+      memcpy(&map[mapsize - mapsize % blocksize], dev->cpbuffer,
+             mapsize % blocksize);
+    }
+
+  if (smart_checkpoint_crc(&cp, map, mapsize) != cp.crc)
+    {
+      ferr("ERROR: Map checkpoint CRC mismatch\n");
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  dev->formatstatus   = SMART_FMT_STAT_FORMATTED;
+  dev->formatversion  = cp.formatversion;
+  dev->namesize       = cp.namesize;
+  dev->freesectors    = cp.freesectors;
+  dev->releasesectors = cp.releasesectors;
+
+  /* Collect the erase blocks recorded in the journal.  It ends at the
+   * first entry that is erased or was only partly programmed.
+   */
+
+  dev->cpjstart  = (start + cp.journal) * blocksize;
+  dev->cpentries = (areablocks - cp.journal) * perblock;
+  dev->cpnext    = 0;
+  memset(dev->cpjmap, 0, (dev->neraseblocks + 7) >> 3);
+
+  while (dev->cpnext < dev->cpentries)
+    {
+      if (dev->cpnext % perblock == 0)
+        {
+          ret = MTD_BREAD(dev->mtd, start + cp.journal +
+                          dev->cpnext / perblock, 1, dev->cpbuffer);
+          if (ret != 1)
+            {
+              ret = -EIO;
+              goto errout;
+            }
+        }
+
+      entry = (FAR struct smart_cpentry_s *)dev->cpbuffer +
+              dev->cpnext % perblock;
+      if (entry->check != (uint16_t)~entry->block ||
+          entry->block >= dev->neraseblocks)
+        {
+          break;
+        }
+
+      dev->cpjmap[entry->block >> 3] |= 1 << (entry->block & 0x07);
+      dev->cpnext++;
+    }
+
+  finfo("Map checkpoint loaded, %" PRIu32 " erase blocks journaled\n",
+        dev->cpnext);
+
+  ret = smart_checkpoint_replay(dev);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+#ifdef CONFIG_MTD_SMART_FSCK
+  smart_fsck(dev);
+#endif
+#ifdef CONFIG_MTD_SMART_WEAR_LEVEL
+  smart_read_wearstatus(dev);
+#endif
+
+  return OK;
+
+errout:
+  ferr("ERROR: Map checkpoint not usable: %zd\n", ret);
+  smart_checkpoint_invalidate(dev);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_getformat
  *
@@ -2724,6 +3560,7 @@ static void smart_erase_block_if_empty(FAR struct smart_struct_s *dev,
       dev->unusedsectors += freecount;
       dev->blockerases++;
 #endif
+      smart_checkpoint_journal(dev, block);
       MTD_ERASE(dev->mtd, block, 1);
 
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
@@ -3162,6 +3999,7 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev,
 
   /* Erase the MTD device */
 
+  smart_checkpoint_invalidate(dev);
   ret = MTD_IOCTL(dev->mtd, MTDIOC_BULKERASE, 0);
   if (ret < 0)
     {
@@ -3347,6 +4185,9 @@ static int smart_relocate_sector(FAR struct smart_struct_s *dev,
 
   header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
 
+  smart_checkpoint_journal(dev, newsector / dev->sectorsperblk);
+  smart_checkpoint_journal(dev, oldsector / dev->sectorsperblk);
+
   /* Increment the sequence number and clear the "commit" flag */
 
 #if SMART_STATUS_VERSION == 1
@@ -3540,6 +4381,8 @@ static int smart_relocate_block(FAR struct smart_struct_s *dev,
   dev->freecount[block] = 0;
 #endif
 
+  smart_checkpoint_journal(dev, block);
+
   /* Next move all live data in the block to a new home. */
 
   for (x = block * dev->sectorsperblk; x <
@@ -3993,6 +4836,7 @@ retry:
 
           if (1 == dev->availsectperblk)
             {
+              smart_checkpoint_journal(dev, allocblock);
               MTD_ERASE(dev->mtd, allocblock, 1);
               physicalsector = i;
               dev->lastallocblock = allocblock;
@@ -4436,6 +5280,8 @@ static int smart_write_alloc_sector(FAR struct smart_struct_s *dev,
   uint8_t sectsize;
   FAR struct smart_sect_header_s *header;
 
+  smart_checkpoint_journal(dev, physical / dev->sectorsperblk);
+
   memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->sectorsize);
   header = (FAR struct smart_sect_header_s *)dev->rwbuffer;
   *((FAR uint16_t *) header->logicalsector) = logical;
@@ -4838,6 +5684,9 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
 
   if (needsrelocate)
     {
+      smart_checkpoint_journal(dev, physsector / dev->sectorsperblk);
+      smart_checkpoint_journal(dev, oldphyssector / dev->sectorsperblk);
+
       /* Write the entire sector to the new physical location, uncommitted. */
 
       ret = MTD_BWRITE(dev->mtd, physsector * dev->mtdblkspersector,
@@ -5441,6 +6290,7 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
 
   /* Write the status back to the device */
 
+  smart_checkpoint_journal(dev, physsector / dev->sectorsperblk);
   offset = readaddr + offsetof(struct smart_sect_header_s, status);
   ret = smart_bytewrite(dev, offset, 1, &header.status);
   if (ret != 1)
@@ -5521,6 +6371,20 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 #endif
       goto ok_out;
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+    case BIOC_FLUSH:
+
+      /* Write a fresh checkpoint, then let the MTD flush as well */
+
+      ret = smart_checkpoint_sync(dev);
+      if (ret < 0)
+        {
+          goto ok_out;
+        }
+
+      break;
+#endif
+
     case BIOC_READSECT:
 
       /* Do a logical sector read and return the data */
@@ -5641,6 +6505,10 @@ static int smart_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
     }
 
 ok_out:
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_checkpoint_update(dev);
+#endif
+
   return ret;
 }
 
@@ -6199,6 +7067,27 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Reserve the checkpoint area at the end of the device */
+
+      if (dev->geo.neraseblocks > CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS)
+        {
+          dev->geo.neraseblocks -= CONFIG_MTD_SMART_CHECKPOINT_NBLOCKS;
+          dev->cpblock  = dev->geo.neraseblocks;
+          dev->cpstate  = SMART_CP_STALE;
+          dev->cpbuffer = (FAR uint8_t *)
+            smart_malloc(dev, dev->geo.blocksize, "Checkpoint buffer");
+          dev->cpjmap   = (FAR uint8_t *)
+            smart_zalloc(dev, (dev->geo.neraseblocks + 7) >> 3,
+                         "Checkpoint journal");
+          if (dev->cpbuffer == NULL || dev->cpjmap == NULL)
+            {
+              ret = -ENOMEM;
+              goto errout;
+            }
+        }
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
@@ -6245,9 +7134,18 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd,
       dev->minor = minor;
 #endif
 
-      /* Do a scan of the device */
+      /* Do a scan of the device, unless the map checkpoint can be used */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      ret = smart_checkpoint_load(dev);
+      if (ret < 0)
+        {
+          ret = smart_scan(dev);
+        }
+#else
       ret = smart_scan(dev);
+#endif
+
       if (ret < 0)
         {
           ferr("ERROR: smart_scan failed: %d\n", -ret);
@@ -6325,6 +7223,10 @@ errout:
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   smart_free(dev, dev->erasecounts);
 #endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_free(dev, dev->cpbuffer);
+  smart_free(dev, dev->cpjmap);
+#endif
 #ifdef CONFIG_SMARTFS_MULTI_ROOT_DIRS
   if (rootdirdev)
     {
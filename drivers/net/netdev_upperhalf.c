@@ -732,6 +732,17 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
       pkt_input(dev);
 #endif
 
+#ifdef CONFIG_NETDEV_GRO
+      /* Hold back in-order TCP segments to merge them with the following
+       * ones from the same batch.
+       */
+
+      if (netdev_gro_receive(dev, eth_input))
+        {
+          continue;
+        }
+#endif
+
       switch (dev->d_lltype)
         {
 #ifdef CONFIG_NET_LOOPBACK
@@ -765,6 +776,10 @@ static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
         }
     }
 
+#ifdef CONFIG_NETDEV_GRO
+  netdev_gro_flush(dev, eth_input);
+#endif
+
   netdev_unlock(dev);
 }
 
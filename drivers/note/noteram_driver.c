@@ -35,7 +35,10 @@
 #include <string.h>
 #include <inttypes.h>
 #include <poll.h>
+#include <sys/param.h>
 
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched.h>
 #include <nuttx/sched_note.h>
@@ -63,6 +66,17 @@
 
 #define NCPUS CONFIG_SMP_NCPUS
 
+/* With per-CPU buffers, each CPU gets a buffer of the configured size */
+
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+#  if (CONFIG_DRIVERS_NOTERAM_BUFSIZE & (CONFIG_DRIVERS_NOTERAM_BUFSIZE - 1))
+#    error "CONFIG_DRIVERS_NOTERAM_BUFSIZE must be a power of two"
+#  endif
+#  define NOTERAM_BUFSIZE (CONFIG_DRIVERS_NOTERAM_BUFSIZE * NCPUS)
+#else
+#  define NOTERAM_BUFSIZE CONFIG_DRIVERS_NOTERAM_BUFSIZE
+#endif
+
 /* Renumber idle task PIDs
  *  In NuttX, PID number less than NCPUS are idle tasks.
  *  In Linux, there is only one idle task of PID 0.
@@ -83,6 +97,22 @@
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+/* The circular buffer of one CPU.  The positions run freely and are masked
+ * with the size of the buffer.  Only the CPU that owns the buffer moves
+ * head and tail, so adding a note needs no lock.  The readers move read
+ * and clear under the driver lock.
+ */
+
+struct noteram_cpu_s
+{
+  atomic_t head;               /* Position of the next note to add */
+  atomic_t tail;               /* Position of the oldest note */
+  atomic_t read;               /* Position of the next note to read */
+  atomic_t clear;              /* Position of the last NOTERAM_CLEAR */
+};
+#endif
+
 struct noteram_driver_s
 {
   struct note_driver_s driver;
@@ -90,9 +120,13 @@ struct noteram_driver_s
   size_t ni_bufsize;
   unsigned int ni_overwrite;
   unsigned int threshold;
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  struct noteram_cpu_s ni_cpu[NCPUS];
+#else
   volatile unsigned int ni_head;
   volatile unsigned int ni_tail;
   volatile unsigned int ni_read;
+#endif
   spinlock_t lock;
   FAR struct pollfd *pfd;
   struct notifier_block nb;
@@ -156,7 +190,7 @@ static
 #ifdef DRIVERS_NOTERAM_SECTION
 locate_data(DRIVERS_NOTERAM_SECTION)
 #endif
-uint8_t g_ramnote_buffer[CONFIG_DRIVERS_NOTERAM_BUFSIZE];
+uint8_t g_ramnote_buffer[NOTERAM_BUFSIZE];
 
 static const struct note_driver_ops_s g_noteram_ops =
 {
@@ -196,6 +230,7 @@ struct noteram_driver_s g_noteram_driver =
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_DRIVERS_NOTERAM_PERCPU
 /****************************************************************************
  * Name: noteram_buffer_clear
  *
@@ -429,6 +464,268 @@ static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
   return notelen;
 }
 
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
+/****************************************************************************
+ * Name: noteram_cpu_buffer
+ *
+ * Description:
+ *   Return the circular buffer of the specified CPU.
+ *
+ ****************************************************************************/
+
+static inline FAR uint8_t *
+noteram_cpu_buffer(FAR struct noteram_driver_s *drv, int cpu)
+{
+  return drv->ni_buffer + cpu * drv->ni_bufsize;
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_copy
+ *
+ * Description:
+ *   Copy data out of the circular buffer of a CPU, handling wraparound.
+ *
+ ****************************************************************************/
+
+static void noteram_cpu_copy(FAR struct noteram_driver_s *drv, int cpu,
+                             uint32_t pos, FAR void *dest, size_t len)
+{
+  FAR const uint8_t *buffer = noteram_cpu_buffer(drv, cpu);
+  unsigned int index = pos & (drv->ni_bufsize - 1);
+  size_t space = MIN(drv->ni_bufsize - index, len);
+
+  memcpy(dest, buffer + index, space);
+  memcpy((FAR uint8_t *)dest + space, buffer, len - space);
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_start
+ *
+ * Description:
+ *   Return pos if it still lies between the tail and the head of the
+ *   circular buffer, otherwise the tail.
+ *
+ ****************************************************************************/
+
+static inline uint32_t noteram_cpu_start(uint32_t pos, uint32_t tail,
+                                         uint32_t head)
+{
+  return pos - tail <= head - tail ? pos : tail;
+}
+
+/****************************************************************************
+ * Name: noteram_buffer_clear
+ *
+ * Description:
+ *   Clear all contents of the circular buffers.  The notes are not removed,
+ *   but skipped by the readers, and reclaimed when the buffers are full.
+ *
+ * Assumptions:
+ *   The driver lock is held.
+ *
+ ****************************************************************************/
+
+static void noteram_buffer_clear(FAR struct noteram_driver_s *drv)
+{
+  FAR struct noteram_cpu_s *nc;
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      nc = &drv->ni_cpu[cpu];
+      atomic_set(&nc->clear, atomic_read_acquire(&nc->head));
+      atomic_set(&nc->read, atomic_read(&nc->clear));
+    }
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_DISABLE;
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_rewind
+ *
+ * Description:
+ *   Move the read positions back to the oldest notes after the last clear.
+ *
+ ****************************************************************************/
+
+static void noteram_rewind(FAR struct noteram_driver_s *drv)
+{
+  FAR struct noteram_cpu_s *nc;
+  uint32_t tail;
+  uint32_t head;
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      nc   = &drv->ni_cpu[cpu];
+      tail = atomic_read_acquire(&nc->tail);
+      head = atomic_read_acquire(&nc->head);
+      atomic_set(&nc->read,
+                 noteram_cpu_start(atomic_read(&nc->clear), tail, head));
+    }
+}
+
+/****************************************************************************
+ * Name: noteram_unread_length
+ *
+ * Description:
+ *   Length of unread data currently in all circular buffers.
+ *
+ ****************************************************************************/
+
+static unsigned int noteram_unread_length(FAR struct noteram_driver_s *drv)
+{
+  FAR struct noteram_cpu_s *nc;
+  unsigned int length = 0;
+  uint32_t tail;
+  uint32_t head;
+  int cpu;
+
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      nc      = &drv->ni_cpu[cpu];
+      tail    = atomic_read_acquire(&nc->tail);
+      head    = atomic_read_acquire(&nc->head);
+      length += head - noteram_cpu_start(atomic_read(&nc->read), tail, head);
+    }
+
+  return length;
+}
+
+/****************************************************************************
+ * Name: noteram_cpu_peek
+ *
+ * Description:
+ *   Get the common part of the next unread note of a CPU without removing
+ *   it.
+ *
+ * Returned Value:
+ *   True and the position of the note in pos, if there is an unread note.
+ *
+ ****************************************************************************/
+
+static bool noteram_cpu_peek(FAR struct noteram_driver_s *drv, int cpu,
+                             FAR struct note_common_s *note,
+                             FAR uint32_t *pos)
+{
+  FAR struct noteram_cpu_s *nc = &drv->ni_cpu[cpu];
+  uint32_t read;
+  uint32_t tail;
+  uint32_t head;
+
+  do
+    {
+      tail = atomic_read_acquire(&nc->tail);
+      head = atomic_read_acquire(&nc->head);
+      read = noteram_cpu_start(atomic_read(&nc->read), tail, head);
+      if (read == head)
+        {
+          return false;
+        }
+
+      noteram_cpu_copy(drv, cpu, read, note, sizeof(*note));
+
+      /* The CPU moves the tail before it overwrites old notes.  If the tail
+       * has not passed the note after the copy, the copy is intact.
+       */
+
+      SMP_RMB();
+    }
+  while ((int32_t)(atomic_read(&nc->tail) - read) > 0);
+
+  *pos = read;
+  return true;
+}
+
+/****************************************************************************
+ * Name: noteram_get
+ *
+ * Description:
+ *   Get the oldest of the next notes of all CPUs, so that the notes of the
+ *   CPUs are returned merged in time order.
+ *
+ * Input Parameters:
+ *   buffer - Location to return the next note
+ *   buflen - The length of the user provided buffer.
+ *
+ * Returned Value:
+ *   On success, the positive, non-zero length of the return note is
+ *   provided.  Zero is returned only if the circular buffers are empty.  A
+ *   negated errno value is returned in the event of any failure.
+ *
+ * Assumptions:
+ *   The driver lock is held.
+ *
+ ****************************************************************************/
+
+static ssize_t noteram_get(FAR struct noteram_driver_s *drv,
+                           FAR uint8_t *buffer, size_t buflen)
+{
+  struct note_common_s oldest;
+  struct note_common_s note;
+  FAR struct noteram_cpu_s *nc;
+  ssize_t notelen;
+  uint32_t read = 0;
+  uint32_t pos;
+  int found;
+  int cpu;
+
+  DEBUGASSERT(buffer != NULL);
+
+retry:
+  found = -1;
+  for (cpu = 0; cpu < NCPUS; cpu++)
+    {
+      if (noteram_cpu_peek(drv, cpu, &note, &pos) &&
+          (found < 0 || note.nc_systime < oldest.nc_systime))
+        {
+          oldest = note;
+          found  = cpu;
+          read   = pos;
+        }
+    }
+
+  if (found < 0)
+    {
+      return 0;
+    }
+
+  nc      = &drv->ni_cpu[found];
+  notelen = oldest.nc_length;
+  DEBUGASSERT(notelen >= sizeof(struct note_common_s));
+
+  /* Is the user buffer large enough to hold the note? */
+
+  if (buflen < notelen)
+    {
+      /* Skip the large note so that we do not get constipated. */
+
+      atomic_set(&nc->read, read + NOTE_ALIGN(notelen));
+
+      /* and return an error */
+
+      return -EFBIG;
+    }
+
+  noteram_cpu_copy(drv, found, read, buffer, notelen);
+
+  /* Start over if the note was overwritten while it was copied */
+
+  SMP_RMB();
+  if ((int32_t)(atomic_read(&nc->tail) - read) > 0)
+    {
+      goto retry;
+    }
+
+  atomic_set(&nc->read, read + NOTE_ALIGN(notelen));
+  return notelen;
+}
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_open
  ****************************************************************************/
@@ -441,7 +738,11 @@ static int noteram_open(FAR struct file *filep)
 
   /* Reset the read index of the circular buffer */
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  noteram_rewind(drv);
+#else
   drv->ni_read = drv->ni_tail;
+#endif
   ctx = kmm_zalloc(sizeof(*ctx));
   if (ctx == NULL)
     {
@@ -699,6 +1000,7 @@ errout:
   return ret;
 }
 
+#ifndef CONFIG_DRIVERS_NOTERAM_PERCPU
 /****************************************************************************
  * Name: noteram_add
  *
@@ -774,6 +1076,105 @@ static void noteram_add(FAR struct note_driver_s *driver,
     }
 }
 
+#else /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
+/****************************************************************************
+ * Name: noteram_add
+ *
+ * Description:
+ *   Add the variable length note to the circular buffer of this CPU
+ *
+ * Input Parameters:
+ *   note    - The note buffer
+ *   notelen - The buffer length
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void noteram_add(FAR struct note_driver_s *driver,
+                        FAR const void *note, size_t notelen)
+{
+  FAR const uint8_t *buf = note;
+  FAR struct noteram_driver_s *drv = (FAR struct noteram_driver_s *)driver;
+  FAR struct noteram_cpu_s *nc;
+  FAR uint8_t *buffer;
+  size_t length = NOTE_ALIGN(notelen);
+  unsigned int index;
+  unsigned int space;
+  uint32_t head;
+  uint32_t tail;
+  irqstate_t flags;
+  int cpu;
+
+  if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_OVERFLOW)
+    {
+      return;
+    }
+
+  DEBUGASSERT(note != NULL && length < drv->ni_bufsize);
+
+  /* No other CPU adds notes to the buffer of this CPU, so it is enough to
+   * keep the interrupt handlers of this CPU out.
+   */
+
+  flags  = up_irq_save();
+  cpu    = this_cpu();
+  nc     = &drv->ni_cpu[cpu];
+  buffer = noteram_cpu_buffer(drv, cpu);
+  head   = atomic_read(&nc->head);
+  tail   = atomic_read(&nc->tail);
+
+  if (head + length - tail > drv->ni_bufsize)
+    {
+      if (drv->ni_overwrite == NOTERAM_MODE_OVERWRITE_DISABLE)
+        {
+          /* Only the notes before the last clear may be reclaimed */
+
+          tail = noteram_cpu_start(atomic_read(&nc->clear), tail, head);
+          if (head + length - tail > drv->ni_bufsize)
+            {
+              /* Stop recording if not in overwrite mode */
+
+              drv->ni_overwrite = NOTERAM_MODE_OVERWRITE_OVERFLOW;
+              up_irq_restore(flags);
+              return;
+            }
+        }
+      else
+        {
+          /* Remove the notes at the tail, make sure there is enough
+           * space
+           */
+
+          do
+            {
+              tail += NOTE_ALIGN(buffer[tail & (drv->ni_bufsize - 1)]);
+            }
+          while (head + length - tail > drv->ni_bufsize);
+        }
+
+      /* Let the readers know before the old notes are overwritten */
+
+      atomic_set(&nc->tail, tail);
+      SMP_WMB();
+    }
+
+  index = head & (drv->ni_bufsize - 1);
+  space = MIN(drv->ni_bufsize - index, notelen);
+  memcpy(buffer + index, buf, space);
+  memcpy(buffer, buf + space, notelen - space);
+  atomic_set_release(&nc->head, head + length);
+  up_irq_restore(flags);
+
+  if (drv->pfd && (noteram_unread_length(drv) >= drv->threshold))
+    {
+      poll_notify(&drv->pfd, 1, POLLIN);
+    }
+}
+#endif /* CONFIG_DRIVERS_NOTERAM_PERCPU */
+
 /****************************************************************************
  * Name: noteram_dump_init_context
  ****************************************************************************/
@@ -1372,7 +1773,8 @@ int noteram_register(void)
  *
  * Input Parameters:
  *  devpath: The path of the Noteram device
- *  bufsize: The size of the circular buffer
+ *  bufsize: The size of the circular buffer, or of the buffer of each CPU
+ *           if CONFIG_DRIVERS_NOTERAM_PERCPU is enabled
  *  overwrite: The overwrite mode
  *
  * Returned Value:
@@ -1392,7 +1794,18 @@ noteram_initialize(FAR const char *devpath, size_t bufsize,
 #endif
   int ret;
 
+#ifdef CONFIG_DRIVERS_NOTERAM_PERCPU
+  /* bufsize is the size of the buffer of each CPU */
+
+  if ((bufsize & (bufsize - 1)) != 0)
+    {
+      return NULL;
+    }
+
+  drv = kmm_zalloc(sizeof(*drv) + len + bufsize * NCPUS);
+#else
   drv = kmm_malloc(sizeof(*drv) + len + bufsize);
+#endif
   if (drv == NULL)
     {
       return NULL;
@@ -1421,9 +1834,11 @@ noteram_initialize(FAR const char *devpath, size_t bufsize,
   drv->ni_bufsize = bufsize;
   drv->ni_buffer = (FAR uint8_t *)(drv + 1) + len;
   drv->ni_overwrite = overwrite;
+#ifndef CONFIG_DRIVERS_NOTERAM_PERCPU
   drv->ni_head = 0;
   drv->ni_tail = 0;
   drv->ni_read = 0;
+#endif
   drv->pfd = NULL;
 
   ret = note_driver_register(&drv->driver);
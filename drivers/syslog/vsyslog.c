@@ -34,6 +34,7 @@
 #include <nuttx/init.h>
 #include <nuttx/clock.h>
 #include <nuttx/streams.h>
+#include <nuttx/sched_note.h>
 #include <nuttx/syslog/syslog.h>
 
 #include "syslog.h"
@@ -96,6 +97,19 @@ int nx_vsyslog(int priority, FAR const IPTR char *fmt, FAR va_list *ap)
 #  endif
 #endif
 
+#ifdef CONFIG_SYSLOG_BINARY
+  /* Only record the format string and the arguments, the host formats
+   * them later with the ELF file.
+   */
+
+  if (LOG_PRI(priority) > CONFIG_SYSLOG_BINARY_TEXT_UPTO)
+    {
+      sched_note_vprintf_ip(NOTE_TAG_LOG + LOG_PRI(priority),
+                            (uintptr_t)return_address(0), fmt, 0, ap);
+      return 0;
+    }
+#endif
+
   /* Wrap the low-level output in a stream object and let lib_vsprintf
    * do the work.
    */
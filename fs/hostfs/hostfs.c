@@ -38,6 +38,7 @@
 #include <errno.h>
 #include <nuttx/debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -63,6 +64,12 @@ struct hostfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  FAR struct hostfs_dlist_s *list;  /* Listing being read or built */
+  FAR char *path;                   /* Host path, set while building */
+  size_t pos;                       /* Read offset in a cached listing */
+  uint32_t gen;                     /* Mount generation at opendir */
+#endif
 };
 
 /****************************************************************************
@@ -240,6 +247,360 @@ static void hostfs_mkpath(FAR struct hostfs_mountpt_s  *fs,
     }
 }
 
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+/****************************************************************************
+ * Name: hostfs_attr_get
+ *
+ * Description: Return a cached stat() result if it is still valid.
+ *
+ ****************************************************************************/
+
+static bool hostfs_attr_get(FAR struct hostfs_mountpt_s *fs,
+                            FAR const struct hostfs_attr_s *attr,
+                            FAR struct stat *buf, FAR int *result)
+{
+  if (attr->gen != fs->fs_gen ||
+      clock_systime_ticks() - attr->stamp >=
+      MSEC2TICK(CONFIG_FS_HOSTFS_ATTR_TIMEOUT))
+    {
+      return false;
+    }
+
+  memcpy(buf, &attr->buf, sizeof(*buf));
+  *result = attr->result;
+  return true;
+}
+
+/****************************************************************************
+ * Name: hostfs_attr_set
+ ****************************************************************************/
+
+static void hostfs_attr_set(FAR struct hostfs_mountpt_s *fs,
+                            FAR struct hostfs_attr_s *attr,
+                            FAR const struct stat *buf, int result)
+{
+  memcpy(&attr->buf, buf, sizeof(*buf));
+  attr->result = result;
+  attr->gen    = fs->fs_gen;
+  attr->stamp  = clock_systime_ticks();
+}
+
+/****************************************************************************
+ * Name: hostfs_attr_lookup
+ *
+ * Description: Find the cache entry of a host path.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_attr_s *
+hostfs_attr_lookup(FAR struct hostfs_mountpt_s *fs, FAR const char *path)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_ATTR_NCACHE; i++)
+    {
+      if (fs->fs_attr[i].path != NULL &&
+          strcmp(fs->fs_attr[i].path, path) == 0)
+        {
+          return &fs->fs_attr[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_attr_insert
+ *
+ * Description: Cache the stat() result of a host path, replacing the
+ *   oldest entry if the path is not cached yet.
+ *
+ ****************************************************************************/
+
+static void hostfs_attr_insert(FAR struct hostfs_mountpt_s *fs,
+                               FAR const char *path,
+                               FAR const struct stat *buf, int result)
+{
+  FAR struct hostfs_attr_s *attr;
+
+  attr = hostfs_attr_lookup(fs, path);
+  if (attr == NULL)
+    {
+      attr = &fs->fs_attr[fs->fs_attrnext];
+      fs->fs_attrnext = (fs->fs_attrnext + 1) %
+                        CONFIG_FS_HOSTFS_ATTR_NCACHE;
+
+      fs_heap_free(attr->path);
+      attr->path = fs_heap_strdup(path);
+      if (attr->path == NULL)
+        {
+          return;
+        }
+    }
+
+  hostfs_attr_set(fs, attr, buf, result);
+}
+
+/****************************************************************************
+ * Name: hostfs_invalidate
+ *
+ * Description: Drop all cached attributes and directory listings after a
+ *   change made through this mount.
+ *
+ ****************************************************************************/
+
+static void hostfs_invalidate(FAR struct hostfs_mountpt_s *fs)
+{
+  /* Entries are only valid for the generation they were cached in.  Skip
+   * the generation that zeroed, never used entries belong to.
+   */
+
+  if (++fs->fs_gen == 0)
+    {
+      fs->fs_gen++;
+    }
+}
+#else
+#  define hostfs_invalidate(fs)
+#endif
+
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+/****************************************************************************
+ * Name: hostfs_dlist_release
+ ****************************************************************************/
+
+static void hostfs_dlist_release(FAR struct hostfs_dlist_s *list)
+{
+  if (list != NULL && --list->crefs <= 0)
+    {
+      fs_heap_free(list);
+    }
+}
+
+/****************************************************************************
+ * Name: hostfs_dlist_append
+ *
+ * Description: Add one entry to a listing that is being built.  The
+ *   listing is dropped if it grows beyond CONFIG_FS_HOSTFS_DIR_MAXSIZE.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_dlist_s *
+hostfs_dlist_append(FAR struct hostfs_dlist_s *list,
+                    FAR const struct dirent *entry)
+{
+  FAR struct hostfs_dlist_s *newlist;
+  size_t len = strlen(entry->d_name) + 2;
+  size_t alloc;
+
+  if (list->size + len > list->alloc)
+    {
+      alloc = list->alloc * 2;
+      while (alloc < list->size + len)
+        {
+          alloc *= 2;
+        }
+
+      if (alloc > CONFIG_FS_HOSTFS_DIR_MAXSIZE)
+        {
+          alloc = CONFIG_FS_HOSTFS_DIR_MAXSIZE;
+        }
+
+      if (list->size + len > alloc)
+        {
+          fs_heap_free(list);
+          return NULL;
+        }
+
+      newlist = fs_heap_realloc(list, sizeof(*list) + alloc);
+      if (newlist == NULL)
+        {
+          fs_heap_free(list);
+          return NULL;
+        }
+
+      list = newlist;
+      list->alloc = alloc;
+    }
+
+  list->data[list->size] = entry->d_type;
+  memcpy(&list->data[list->size + 1], entry->d_name, len - 1);
+  list->size += len;
+  return list;
+}
+
+/****************************************************************************
+ * Name: hostfs_dcache_lookup
+ *
+ * Description: Return a valid cached listing of a host directory.
+ *
+ ****************************************************************************/
+
+static FAR struct hostfs_dlist_s *
+hostfs_dcache_lookup(FAR struct hostfs_mountpt_s *fs, FAR const char *path)
+{
+  FAR struct hostfs_dcache_s *dc;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_DIR_NCACHE; i++)
+    {
+      dc = &fs->fs_dcache[i];
+      if (dc->path != NULL && dc->gen == fs->fs_gen &&
+          clock_systime_ticks() - dc->stamp <
+          MSEC2TICK(CONFIG_FS_HOSTFS_ATTR_TIMEOUT) &&
+          strcmp(dc->path, path) == 0)
+        {
+          return dc->list;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: hostfs_dcache_insert
+ *
+ * Description: Hand a complete listing over to the cache.
+ *
+ ****************************************************************************/
+
+static void hostfs_dcache_insert(FAR struct hostfs_mountpt_s *fs,
+                                 FAR char *path,
+                                 FAR struct hostfs_dlist_s *list)
+{
+  FAR struct hostfs_dcache_s *dc;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_HOSTFS_DIR_NCACHE; i++)
+    {
+      if (fs->fs_dcache[i].path != NULL &&
+          strcmp(fs->fs_dcache[i].path, path) == 0)
+        {
+          break;
+        }
+    }
+
+  if (i == CONFIG_FS_HOSTFS_DIR_NCACHE)
+    {
+      i = fs->fs_dcachenext;
+      fs->fs_dcachenext = (i + 1) % CONFIG_FS_HOSTFS_DIR_NCACHE;
+    }
+
+  dc = &fs->fs_dcache[i];
+  fs_heap_free(dc->path);
+  hostfs_dlist_release(dc->list);
+
+  dc->path  = path;
+  dc->list  = list;
+  dc->gen   = fs->fs_gen;
+  dc->stamp = clock_systime_ticks();
+}
+#endif
+
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+/****************************************************************************
+ * Name: hostfs_ra_drop
+ *
+ * Description: Discard the read-ahead data of a file and move the host
+ *   file position back to f_pos, where the rest of the code expects it.
+ *
+ ****************************************************************************/
+
+static int hostfs_ra_drop(FAR struct hostfs_ofile_s *hf,
+                          FAR struct file *filep)
+{
+  off_t hostpos = hf->rapos + hf->ralen;
+  off_t ret;
+
+  if (hf->ralen == 0)
+    {
+      return OK;
+    }
+
+  hf->ralen = 0;
+  if (hostpos == filep->f_pos)
+    {
+      return OK;
+    }
+
+  ret = host_lseek(hf->fd, hostpos, filep->f_pos, SEEK_SET);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: hostfs_ra_read
+ *
+ * Description: Read through the read-ahead buffer.  Reads at least as
+ *   large as the buffer bypass it.
+ *
+ ****************************************************************************/
+
+static ssize_t hostfs_ra_read(FAR struct hostfs_ofile_s *hf,
+                              FAR struct file *filep,
+                              FAR char *buffer, size_t buflen)
+{
+  ssize_t nread = 0;
+  ssize_t ret = 0;
+  size_t off;
+  size_t n;
+
+  while (buflen > 0)
+    {
+      if (hf->ralen > 0 && filep->f_pos >= hf->rapos &&
+          filep->f_pos < hf->rapos + hf->ralen)
+        {
+          off = filep->f_pos - hf->rapos;
+          n   = hf->ralen - off;
+          if (n > buflen)
+            {
+              n = buflen;
+            }
+
+          memcpy(buffer, hf->rabuf + off, n);
+          filep->f_pos += n;
+          buffer       += n;
+          buflen       -= n;
+          nread        += n;
+          continue;
+        }
+
+      ret = hostfs_ra_drop(hf, filep);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (hf->rabuf == NULL && buflen < CONFIG_FS_HOSTFS_READAHEAD)
+        {
+          hf->rabuf = fs_heap_malloc(CONFIG_FS_HOSTFS_READAHEAD);
+        }
+
+      if (hf->rabuf == NULL || buflen >= CONFIG_FS_HOSTFS_READAHEAD)
+        {
+          ret = host_read(hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              filep->f_pos += ret;
+              nread        += ret;
+            }
+
+          break;
+        }
+
+      ret = host_read(hf->fd, hf->rabuf, CONFIG_FS_HOSTFS_READAHEAD);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->rapos = filep->f_pos;
+      hf->ralen = ret;
+    }
+
+  return nread > 0 ? nread : ret;
+}
+#endif
+
 /****************************************************************************
  * Name: hostfs_open
  ****************************************************************************/
@@ -300,6 +661,20 @@ static int hostfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  hf->attr.path = NULL;
+  hf->attr.gen  = 0;
+#endif
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  hf->rabuf = NULL;
+  hf->ralen = 0;
+#endif
+
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      hostfs_invalidate(fs);
+    }
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -427,6 +802,9 @@ static int hostfs_close(FAR struct file *filep)
   /* Close the host file */
 
   host_close(hf->fd);
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  fs_heap_free(hf->rabuf);
+#endif
 
   /* Now free the pointer */
 
@@ -472,11 +850,15 @@ static ssize_t hostfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  ret = hostfs_ra_read(hf, filep, buffer, buflen);
+#else
   ret = host_read(hf->fd, buffer, buflen);
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -522,12 +904,21 @@ static ssize_t hostfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  ret = hostfs_ra_drop(hf, filep);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the write */
 
   ret = host_write(hf->fd, buffer, buflen);
   if (ret > 0)
     {
       filep->f_pos += ret;
+      hostfs_invalidate(fs);
     }
 
 errout_with_lock:
@@ -566,6 +957,37 @@ static off_t hostfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  /* While there is read-ahead data the host position does not matter, so
+   * absolute and relative seeks need no host call.
+   */
+
+  if (hf->ralen > 0 && (whence == SEEK_SET || whence == SEEK_CUR))
+    {
+      ret = whence == SEEK_SET ? offset : filep->f_pos + offset;
+      if (ret < 0)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          filep->f_pos = ret;
+        }
+
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+
+  /* Any other seek is done by the host, starting from f_pos */
+
+  ret = hostfs_ra_drop(hf, filep);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = host_lseek(hf->fd, filep->f_pos, offset, whence);
@@ -609,6 +1031,10 @@ static int hostfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  hostfs_ra_drop(hf, filep);
+#endif
+
   /* Call our internal routine to perform the ioctl */
 
   ret = host_ioctl(hf->fd, cmd, arg);
@@ -747,7 +1173,15 @@ static int hostfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Call the host to perform the read */
 
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  if (!hostfs_attr_get(fs, &hf->attr, buf, &ret))
+    {
+      ret = host_fstat(hf->fd, buf);
+      hostfs_attr_set(fs, &hf->attr, buf, ret);
+    }
+#else
   ret = host_fstat(hf->fd, buf);
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -794,6 +1228,7 @@ static int hostfs_fchstat(FAR const struct file *filep,
   /* Call the host to perform the change */
 
   ret = host_fchstat(hf->fd, buf, flags);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -834,7 +1269,17 @@ static int hostfs_ftruncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  ret = hostfs_ra_drop(hf, filep);
+  if (ret < 0)
+    {
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   ret = host_ftruncate(hf->fd, length);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -880,6 +1325,19 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
 
   hostfs_mkpath(fs, relpath, path, sizeof(path));
 
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  /* Serve the directory from a cached listing if there is one */
+
+  hdir->list = hostfs_dcache_lookup(fs, path);
+  if (hdir->list != NULL)
+    {
+      hdir->list->crefs++;
+      *dir = (FAR struct fs_dirent_s *)hdir;
+      nxmutex_unlock(&g_lock);
+      return OK;
+    }
+#endif
+
   /* Call the host's opendir function */
 
   hdir->dir = host_opendir(path);
@@ -889,6 +1347,29 @@ static int hostfs_opendir(FAR struct inode *mountpt, FAR const char *relpath,
       goto errout_with_lock;
     }
 
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  /* Record the listing while it is read, so it can be cached once the
+   * end is reached.  Caching is simply skipped if this fails.
+   */
+
+  hdir->gen  = fs->fs_gen;
+  hdir->path = fs_heap_strdup(path);
+  hdir->list = fs_heap_malloc(sizeof(struct hostfs_dlist_s) + 256);
+  if (hdir->path == NULL || hdir->list == NULL)
+    {
+      fs_heap_free(hdir->path);
+      fs_heap_free(hdir->list);
+      hdir->path = NULL;
+      hdir->list = NULL;
+    }
+  else
+    {
+      hdir->list->crefs = 1;
+      hdir->list->size  = 0;
+      hdir->list->alloc = 256;
+    }
+#endif
+
   *dir = (FAR struct fs_dirent_s *)hdir;
   nxmutex_unlock(&g_lock);
   return OK;
@@ -932,7 +1413,15 @@ static int hostfs_closedir(FAR struct inode *mountpt,
 
   /* Call the host's closedir function */
 
-  host_closedir(hdir->dir);
+  if (hdir->dir != NULL)
+    {
+      host_closedir(hdir->dir);
+    }
+
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  hostfs_dlist_release(hdir->list);
+  fs_heap_free(hdir->path);
+#endif
 
   nxmutex_unlock(&g_lock);
   fs_heap_free(hdir);
@@ -969,10 +1458,52 @@ static int hostfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  if (hdir->dir == NULL)
+    {
+      /* Reading from a cached listing */
+
+      if (hdir->pos >= hdir->list->size)
+        {
+          ret = -ENOENT;
+        }
+      else
+        {
+          entry->d_type = (uint8_t)hdir->list->data[hdir->pos];
+          strlcpy(entry->d_name, &hdir->list->data[hdir->pos + 1],
+                  sizeof(entry->d_name));
+          hdir->pos += strlen(&hdir->list->data[hdir->pos + 1]) + 2;
+        }
+
+      nxmutex_unlock(&g_lock);
+      return ret;
+    }
+#endif
+
   /* Call the host OS's readdir function */
 
   ret = host_readdir(hdir->dir, entry);
 
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  if (hdir->list != NULL)
+    {
+      FAR struct hostfs_mountpt_s *fs = mountpt->i_private;
+
+      if (ret >= 0)
+        {
+          hdir->list = hostfs_dlist_append(hdir->list, entry);
+        }
+      else if (ret == -ENOENT && hdir->gen == fs->fs_gen)
+        {
+          /* Complete and unchanged: the cache takes over the listing */
+
+          hostfs_dcache_insert(fs, hdir->path, hdir->list);
+          hdir->path = NULL;
+          hdir->list = NULL;
+        }
+    }
+#endif
+
   nxmutex_unlock(&g_lock);
   return ret;
 }
@@ -1006,6 +1537,20 @@ static int hostfs_rewinddir(FAR struct inode *mountpt,
       return ret;
     }
 
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  hdir->pos = 0;
+  if (hdir->dir == NULL)
+    {
+      nxmutex_unlock(&g_lock);
+      return OK;
+    }
+
+  if (hdir->list != NULL)
+    {
+      hdir->list->size = 0;
+    }
+#endif
+
   /* Call the host and let it do all the work */
 
   host_rewinddir(hdir->dir);
@@ -1091,6 +1636,9 @@ static int hostfs_bind(FAR struct inode *blkdriver, FAR const void *data,
    */
 
   fs->fs_head = NULL;
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  fs->fs_gen  = 1;
+#endif
 
   /* Now perform the mount.  */
 
@@ -1154,9 +1702,24 @@ static int hostfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return (flags != 0) ? -ENOSYS : -EBUSY;
     }
 
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  for (ret = 0; ret < CONFIG_FS_HOSTFS_ATTR_NCACHE; ret++)
+    {
+      fs_heap_free(fs->fs_attr[ret].path);
+    }
+#endif
+
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  for (ret = 0; ret < CONFIG_FS_HOSTFS_DIR_NCACHE; ret++)
+    {
+      fs_heap_free(fs->fs_dcache[ret].path);
+      hostfs_dlist_release(fs->fs_dcache[ret].list);
+    }
+#endif
+
   nxmutex_unlock(&g_lock);
   fs_heap_free(fs);
-  return ret;
+  return OK;
 }
 
 /****************************************************************************
@@ -1228,6 +1791,7 @@ static int hostfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = host_unlink(path);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1268,6 +1832,7 @@ static int hostfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_mkdir(path, mode);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1309,6 +1874,7 @@ int hostfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = host_rmdir(path);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1353,6 +1919,7 @@ int hostfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = host_rename(oldpath, newpath);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1369,6 +1936,9 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                        FAR struct stat *buf)
 {
   FAR struct hostfs_mountpt_s *fs;
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  FAR struct hostfs_attr_s *attr;
+#endif
   char path[HOSTFS_MAX_PATH];
   int ret;
 
@@ -1392,7 +1962,16 @@ static int hostfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  attr = hostfs_attr_lookup(fs, path);
+  if (attr == NULL || !hostfs_attr_get(fs, attr, buf, &ret))
+    {
+      ret = host_stat(path, buf);
+      hostfs_attr_insert(fs, path, buf, ret);
+    }
+#else
   ret = host_stat(path, buf);
+#endif
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -1433,6 +2012,7 @@ static int hostfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the chstat operation */
 
   ret = host_chstat(path, buf, flags);
+  hostfs_invalidate(fs);
 
   nxmutex_unlock(&g_lock);
   return ret;
@@ -30,6 +30,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -43,6 +44,44 @@
  * Public Types
  ****************************************************************************/
 
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+/* One cached stat() or fstat() result.  Negative results are cached too,
+ * so repeated lookups of missing files do not go to the host either.
+ */
+
+struct hostfs_attr_s
+{
+  FAR char                 *path;    /* Host path, NULL for fstat() */
+  uint32_t                  gen;     /* Mount generation when cached */
+  clock_t                   stamp;   /* Time when cached */
+  int                       result;  /* Host return value */
+  struct stat               buf;
+};
+#endif
+
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+/* A directory listing.  Each entry is stored as the d_type byte followed
+ * by the NUL terminated name.  A listing is shared by the cache and the
+ * directories reading from it.
+ */
+
+struct hostfs_dlist_s
+{
+  int                       crefs;   /* Reference count */
+  size_t                    size;    /* Bytes used in data[] */
+  size_t                    alloc;   /* Bytes allocated for data[] */
+  char                      data[1];
+};
+
+struct hostfs_dcache_s
+{
+  FAR char                 *path;    /* Host path, NULL if unused */
+  uint32_t                  gen;     /* Mount generation when cached */
+  clock_t                   stamp;   /* Time when cached */
+  FAR struct hostfs_dlist_s *list;
+};
+#endif
+
 /* This structure describes the state of one open file.  This structure
  * is protected by the volume semaphore.
  */
@@ -53,6 +92,14 @@ struct hostfs_ofile_s
   int16_t                   crefs;   /* Reference count */
   mode_t                    oflags;  /* Open mode */
   int                       fd;
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  struct hostfs_attr_s      attr;    /* Cached fstat() */
+#endif
+#if CONFIG_FS_HOSTFS_READAHEAD > 0
+  FAR char                 *rabuf;   /* Read-ahead buffer */
+  off_t                     rapos;   /* File offset of rabuf[0] */
+  size_t                    ralen;   /* Valid bytes in rabuf */
+#endif
   char                      relpath[1];
 };
 
@@ -65,6 +112,15 @@ struct hostfs_mountpt_s
 {
   FAR struct hostfs_ofile_s *fs_head;      /* A singly-linked list of open files */
   char                       fs_root[HOSTFS_MAX_PATH];
+#if CONFIG_FS_HOSTFS_ATTR_TIMEOUT > 0
+  uint32_t                   fs_gen;       /* Bumped by local changes */
+  struct hostfs_attr_s       fs_attr[CONFIG_FS_HOSTFS_ATTR_NCACHE];
+  int                        fs_attrnext;  /* Next entry to replace */
+#endif
+#if CONFIG_FS_HOSTFS_DIR_NCACHE > 0
+  struct hostfs_dcache_s     fs_dcache[CONFIG_FS_HOSTFS_DIR_NCACHE];
+  int                        fs_dcachenext; /* Next entry to replace */
+#endif
 };
 
 /****************************************************************************
@@ -30,6 +30,7 @@
 #include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -69,6 +70,10 @@ struct littlefs_file_s
 {
   struct lfs_file       file;
   int                   refs;
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+  struct lfs_file_config cfg;         /* Must outlive the open file */
+  int                   cacheslot;    /* Index into the cache pool or -1 */
+#endif
 };
 
 /* This structure represents the overall mountpoint state. An instance of
@@ -84,6 +89,10 @@ struct littlefs_mountpt_s
   struct lfs_config     cfg;
   struct lfs            lfs;
   bool                  readonly;
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+  FAR uint8_t          *cachepool;    /* Pre-allocated per-file caches */
+  uint32_t              cachefree;    /* Bitmap of free cache slots */
+#endif
 };
 
 /* NuttX specific file attributes.
@@ -525,6 +534,28 @@ static int littlefs_check_parentperm_locked(
 
 #endif /* CONFIG_FS_PERMISSION && CONFIG_FS_LITTLEFS_ATTR_UPDATE */
 
+/****************************************************************************
+ * Name: littlefs_putcache
+ *
+ * Description:
+ *   Return the file cache of a closed file to the pool.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+static void littlefs_putcache(FAR struct littlefs_mountpt_s *fs,
+                              FAR struct littlefs_file_s *priv)
+{
+  if (priv->cacheslot >= 0)
+    {
+      fs->cachefree  |= 1u << priv->cacheslot;
+      priv->cacheslot = -1;
+    }
+}
+#else
+#  define littlefs_putcache(fs, priv)
+#endif
+
 /****************************************************************************
  * Name: littlefs_open
  ****************************************************************************/
@@ -556,6 +587,9 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
     }
 
   priv->refs = 1;
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+  priv->cacheslot = -1;
+#endif
 
   /* Lock */
 
@@ -599,8 +633,27 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
         }
     }
 
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+  /* Take a file cache from the pool if one is free.  Otherwise littlefs
+   * allocates one from the heap as usual.
+   */
+
+  memset(&priv->cfg, 0, sizeof(priv->cfg));
+  if (fs->cachefree != 0)
+    {
+      priv->cacheslot  = ffs(fs->cachefree) - 1;
+      priv->cfg.buffer = fs->cachepool +
+                         priv->cacheslot * fs->cfg.cache_size;
+      fs->cachefree   &= ~(1u << priv->cacheslot);
+    }
+
+  ret = littlefs_convert_result(lfs_file_opencfg(&fs->lfs, &priv->file,
+                                                 relpath, oflags,
+                                                 &priv->cfg));
+#else
   ret = littlefs_convert_result(lfs_file_open(&fs->lfs, &priv->file,
                                               relpath, oflags));
+#endif
   if (ret < 0)
     {
       /* Error opening file */
@@ -682,6 +735,7 @@ static int littlefs_open(FAR struct file *filep, FAR const char *relpath,
 errout_with_file:
   lfs_file_close(&fs->lfs, &priv->file);
 errout:
+  littlefs_putcache(fs, priv);
   nxmutex_unlock(&fs->lock);
 errlock:
   fs_heap_free(priv);
@@ -716,6 +770,7 @@ static int littlefs_close(FAR struct file *filep)
   if (--priv->refs <= 0)
     {
       ret = littlefs_convert_result(lfs_file_close(&fs->lfs, &priv->file));
+      littlefs_putcache(fs, priv);
     }
 
   nxmutex_unlock(&fs->lock);
@@ -1693,7 +1748,15 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.cache_size     = fs->geo.blocksize *
                            CONFIG_FS_LITTLEFS_CACHE_SIZE_FACTOR;
 
-#if CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE == 0
+#if CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE == 0 && \
+    defined(CONFIG_FS_LITTLEFS_LOOKAHEAD_WHOLE)
+  /* Track every block so that a single traversal finds all free blocks
+   * and allocation does not have to rescan the filesystem until all of
+   * them are used up.
+   */
+
+  fs->cfg.lookahead_size = lfs_alignup(fs->cfg.block_count, 64) / 8;
+#elif CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE == 0
   fs->cfg.lookahead_size = lfs_min(lfs_alignup(fs->cfg.block_count, 64) / 8,
                                    fs->cfg.read_size);
 #else
@@ -1704,6 +1767,20 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   fs->cfg.disk_version   = CONFIG_FS_LITTLEFS_DISK_VERSION;
 #endif
 
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+  /* Allocate the per-file caches once instead of on every open */
+
+  fs->cachepool = fs_heap_malloc(fs->cfg.cache_size *
+                                 CONFIG_FS_LITTLEFS_FILE_CACHE_POOL);
+  if (fs->cachepool == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_fs;
+    }
+
+  fs->cachefree = (1ull << CONFIG_FS_LITTLEFS_FILE_CACHE_POOL) - 1;
+#endif
+
   /* Then get information about the littlefs filesystem on the devices
    * managed by this driver.
    */
@@ -1753,6 +1830,9 @@ static int littlefs_bind(FAR struct inode *driver, FAR const void *data,
   return OK;
 
 errout_with_fs:
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+  fs_heap_free(fs->cachepool);
+#endif
   nxmutex_destroy(&fs->lock);
   fs_heap_free(fs);
 errout_with_block:
@@ -1812,6 +1892,9 @@ static int littlefs_unbind(FAR void *handle, FAR struct inode **driver,
 
       /* Release the mountpoint private data */
 
+#if CONFIG_FS_LITTLEFS_FILE_CACHE_POOL > 0
+      fs_heap_free(fs->cachepool);
+#endif
       nxmutex_destroy(&fs->lock);
       fs_heap_free(fs);
     }
@@ -1033,6 +1033,7 @@ static int mnemofs_bind(FAR struct inode *driver, FAR const void *data,
   list_initialize(&sb->ofiles);
   * handle = sb;
   mnemofs_unlock(sb);
+  mfs_procfs_register(sb);
   return OK;
 
 errout_with_lock:
@@ -1098,6 +1099,10 @@ static int mnemofs_unbind(FAR void *handle, FAR struct inode **driver,
   * driver = sb->driver;
   mfs_alloc_uninit(sb);
   mnemofs_unlock(sb);
+#ifdef CONFIG_FS_MNEMOFS_GC
+  mfs_gc_uninit(sb);
+#endif
+  mfs_procfs_unregister(sb);
   kmm_free(sb->rwbuf);
   nxmutex_destroy(&sb->lock);
   kmm_free(sb);
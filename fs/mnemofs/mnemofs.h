@@ -57,6 +57,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
 #include <assert.h>
 #include <dirent.h>
 #include <debug.h>
@@ -65,6 +67,7 @@
 #include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/mtd/mtd.h>
+#include <nuttx/wqueue.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -142,6 +145,13 @@ struct mfs_dirloc_s
   mfs_t offset;
 };
 
+struct mfs_gcstat_s
+{
+  uint32_t bgerase;   /* Blocks erased by the background worker */
+  uint32_t fgerase;   /* Blocks erased inline by a writer */
+  uint32_t runs;      /* Background passes that erased blocks */
+};
+
 struct mfs_sb_s
 {
   FAR struct inode      *driver;
@@ -155,6 +165,18 @@ struct mfs_sb_s
   FAR uint8_t           *freepages;
   FAR uint8_t           *delpages;
   size_t                 bitmapsize;
+  mfs_t                  nfreepages;
+  mfs_t                  ndelpages;
+  struct mfs_gcstat_s    gcstat;
+#ifdef CONFIG_FS_MNEMOFS_GC
+  struct work_s          gcwork;
+  clock_t                gclast;
+  mfs_t                  gcnext;
+  bool                   gcactive;
+#endif
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS)
+  struct list_node       node;
+#endif
   mfs_t                  nextpage;
   mfs_t                  pagesperblk;
   mfs_t                  superblock;
@@ -227,6 +249,17 @@ int mfs_alloc_block(FAR struct mfs_sb_s *sb, FAR mfs_t *block);
 int mfs_release_page(FAR struct mfs_sb_s *sb, mfs_t page);
 int mfs_report_page_deleted(FAR struct mfs_sb_s *sb, mfs_t page);
 int mfs_report_block_deleted(FAR struct mfs_sb_s *sb, mfs_t block);
+#ifdef CONFIG_FS_MNEMOFS_GC
+void mfs_gc_uninit(FAR struct mfs_sb_s *sb);
+#endif
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS)
+void mfs_procfs_register(FAR struct mfs_sb_s *sb);
+void mfs_procfs_unregister(FAR struct mfs_sb_s *sb);
+#else
+#  define mfs_procfs_register(sb)
+#  define mfs_procfs_unregister(sb)
+#endif
 
 mfs_t mfs_ctz_unit_data_area(FAR struct mfs_sb_s *sb, mfs_t index);
 int mfs_ctz_traverse(FAR struct mfs_sb_s *sb, mfs_t startidx,
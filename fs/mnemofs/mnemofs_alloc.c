@@ -54,6 +54,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 
 #include <errno.h>
@@ -63,6 +64,23 @@
 #include "fs_heap.h"
 #include "mnemofs.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_MNEMOFS_GC
+#  if CONFIG_FS_MNEMOFS_GC_LOW_WATERMARK >= \
+      CONFIG_FS_MNEMOFS_GC_HIGH_WATERMARK
+#    error "FS_MNEMOFS_GC_LOW_WATERMARK must be below the high watermark"
+#  endif
+
+#  define MFS_GC_LOWPAGES(sb) \
+     (CONFIG_FS_MNEMOFS_GC_LOW_WATERMARK * MFS_PAGES_PER_BLOCK(sb))
+#  define MFS_GC_HIGHPAGES(sb) \
+     (CONFIG_FS_MNEMOFS_GC_HIGH_WATERMARK * MFS_PAGES_PER_BLOCK(sb))
+#  define MFS_GC_IDLE MSEC2TICK(CONFIG_FS_MNEMOFS_GC_IDLE_MS)
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -89,6 +107,7 @@ static bool mfs_alloc_block_is_free(FAR const struct mfs_sb_s *sb,
                                     mfs_t block);
 static bool mfs_alloc_block_is_deleted(FAR const struct mfs_sb_s *sb,
                                        mfs_t block);
+static int mfs_alloc_erase_block(FAR struct mfs_sb_s *sb, mfs_t block);
 static int mfs_alloc_reclaim_block(FAR struct mfs_sb_s *sb, mfs_t block);
 static int mfs_alloc_page_erased(FAR struct mfs_sb_s *sb, mfs_t page,
                                  FAR bool *erased);
@@ -97,6 +116,12 @@ static FAR char *mfs_alloc_child_path(FAR const char *parent,
 static int mfs_alloc_reserve_live_tree(FAR struct mfs_sb_s *sb,
                                        FAR const char *relpath);
 static int mfs_alloc_choose_start_page(FAR struct mfs_sb_s *sb);
+#ifdef CONFIG_FS_MNEMOFS_GC
+static bool mfs_gc_find(FAR struct mfs_sb_s *sb, FAR mfs_t *block);
+static int mfs_gc_reclaim_one(FAR struct mfs_sb_s *sb);
+static void mfs_gc_worker(FAR void *arg);
+static void mfs_gc_kick(FAR struct mfs_sb_s *sb);
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -403,6 +428,8 @@ static int mfs_alloc_validate_page(FAR const struct mfs_sb_s *sb, mfs_t page)
 
 static void mfs_alloc_mark_page_used(FAR struct mfs_sb_s *sb, mfs_t page)
 {
+  sb->nfreepages -= mfs_bitmap_get(sb->freepages, page);
+  sb->ndelpages  -= mfs_bitmap_get(sb->delpages, page);
   mfs_bitmap_clear(sb->freepages, page);
   mfs_bitmap_clear(sb->delpages, page);
 }
@@ -424,6 +451,8 @@ static void mfs_alloc_mark_page_used(FAR struct mfs_sb_s *sb, mfs_t page)
 
 static void mfs_alloc_mark_page_free(FAR struct mfs_sb_s *sb, mfs_t page)
 {
+  sb->nfreepages += !mfs_bitmap_get(sb->freepages, page);
+  sb->ndelpages  -= mfs_bitmap_get(sb->delpages, page);
   mfs_bitmap_set(sb->freepages, page);
   mfs_bitmap_clear(sb->delpages, page);
 }
@@ -445,6 +474,8 @@ static void mfs_alloc_mark_page_free(FAR struct mfs_sb_s *sb, mfs_t page)
 
 static void mfs_alloc_mark_page_deleted(FAR struct mfs_sb_s *sb, mfs_t page)
 {
+  sb->nfreepages -= mfs_bitmap_get(sb->freepages, page);
+  sb->ndelpages  += !mfs_bitmap_get(sb->delpages, page);
   mfs_bitmap_clear(sb->freepages, page);
   mfs_bitmap_set(sb->delpages, page);
 }
@@ -604,12 +635,51 @@ static bool mfs_alloc_block_is_deleted(FAR const struct mfs_sb_s *sb,
   return true;
 }
 
+/****************************************************************************
+ * Name: mfs_alloc_erase_block
+ *
+ * Description:
+ * Erase one block whose pages have all been marked deleted and return it
+ * to the free bitmap.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *   block - The block number to erase.
+ *
+ * Returned Value:
+ * Zero (OK) is returned on success. A negated errno value is returned on
+ * erase failure.
+ *
+ ****************************************************************************/
+
+static int mfs_alloc_erase_block(FAR struct mfs_sb_s *sb, mfs_t block)
+{
+  int ret;
+
+  ret = mfs_erase_blocks(sb, block, 1);
+  if (ret < 0)
+    {
+      ferr("mfs_erase_blocks failed: %d\n", ret);
+      return ret;
+    }
+
+  if (ret != 1)
+    {
+      ferr("short erase: %d\n", ret);
+      return -EIO;
+    }
+
+  mfs_alloc_mark_block_free(sb, block);
+  return OK;
+}
+
 /****************************************************************************
  * Name: mfs_alloc_reclaim_block
  *
  * Description:
  * Erase one block if every page in it has been marked deleted, then
- * return it to the free bitmap.
+ * return it to the free bitmap. With CONFIG_FS_MNEMOFS_GC the erase is
+ * left to the background worker as long as enough free pages remain.
  *
  * Input Parameters:
  *   sb - The mounted file system instance.
@@ -637,21 +707,21 @@ static int mfs_alloc_reclaim_block(FAR struct mfs_sb_s *sb, mfs_t block)
       return OK;
     }
 
-  ret = mfs_erase_blocks(sb, block, 1);
-  if (ret < 0)
+#ifdef CONFIG_FS_MNEMOFS_GC
+  if (sb->nfreepages >= MFS_GC_LOWPAGES(sb))
     {
-      ferr("mfs_erase_blocks failed: %d\n", ret);
-      return ret;
+      mfs_gc_kick(sb);
+      return OK;
     }
+#endif
 
-  if (ret != 1)
+  ret = mfs_alloc_erase_block(sb, block);
+  if (ret >= 0)
     {
-      ferr("short erase: %d\n", ret);
-      return -EIO;
+      sb->gcstat.fgerase++;
     }
 
-  mfs_alloc_mark_block_free(sb, block);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -929,6 +999,196 @@ static int mfs_alloc_choose_start_page(FAR struct mfs_sb_s *sb)
   return -ENOSPC;
 }
 
+#ifdef CONFIG_FS_MNEMOFS_GC
+
+/****************************************************************************
+ * Name: mfs_gc_find
+ *
+ * Description:
+ * Find the next block whose pages have all been marked deleted. The scan
+ * resumes where the previous one stopped so that reclaimed blocks are
+ * spread over the device.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *   block - The location to receive the block number.
+ *
+ * Returned Value:
+ * true is returned if such a block was found. false is returned
+ * otherwise.
+ *
+ ****************************************************************************/
+
+static bool mfs_gc_find(FAR struct mfs_sb_s *sb, FAR mfs_t *block)
+{
+  mfs_t firstblock;
+  mfs_t candidate;
+  mfs_t nblocks;
+  mfs_t i;
+
+  firstblock = mfs_first_data_block(sb);
+  if (firstblock == MFS_LOCATION_INVALID ||
+      sb->ndelpages < MFS_PAGES_PER_BLOCK(sb))
+    {
+      return false;
+    }
+
+  nblocks   = MFS_BLOCK_COUNT(sb) - firstblock;
+  candidate = sb->gcnext < firstblock ? firstblock : sb->gcnext;
+  for (i = 0; i < nblocks; i++)
+    {
+      if (mfs_alloc_block_is_deleted(sb, candidate))
+        {
+          * block = candidate;
+          sb->gcnext = mfs_next_data_block(sb, candidate);
+          return true;
+        }
+
+      candidate = mfs_next_data_block(sb, candidate);
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: mfs_gc_reclaim_one
+ *
+ * Description:
+ * Erase one block that is still waiting for the background worker. This
+ * is the fallback used by the allocator when it runs out of free pages
+ * before the worker got to run.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *
+ * Returned Value:
+ * Zero (OK) is returned if a block was reclaimed. -ENOSPC is returned if
+ * there was nothing to reclaim. A negated errno value is returned on
+ * erase failure.
+ *
+ ****************************************************************************/
+
+static int mfs_gc_reclaim_one(FAR struct mfs_sb_s *sb)
+{
+  mfs_t block;
+  int ret;
+
+  if (!mfs_gc_find(sb, &block))
+    {
+      return -ENOSPC;
+    }
+
+  ret = mfs_alloc_erase_block(sb, block);
+  if (ret >= 0)
+    {
+      sb->gcstat.fgerase++;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mfs_gc_worker
+ *
+ * Description:
+ * Background reclamation worker. It waits until the file system has been
+ * idle for CONFIG_FS_MNEMOFS_GC_IDLE_MS (unless free pages are already
+ * below the low watermark), then erases deleted blocks one at a time
+ * until the high watermark is reached. The lock is dropped after every
+ * erase so a writer never waits for more than one erase. Each pass that
+ * erases at least one block is counted in gcstat.runs.
+ *
+ * Input Parameters:
+ *   arg - The mounted file system instance.
+ *
+ * Returned Value:
+ * None.
+ *
+ ****************************************************************************/
+
+static void mfs_gc_worker(FAR void *arg)
+{
+  FAR struct mfs_sb_s *sb = arg;
+  bool again = false;
+  clock_t elapsed;
+  mfs_t block;
+
+  if (nxmutex_lock(&sb->lock) < 0)
+    {
+      return;
+    }
+
+  if (sb->freepages == NULL || sb->nfreepages >= MFS_GC_HIGHPAGES(sb))
+    {
+      goto out;
+    }
+
+  elapsed = clock_systime_ticks() - sb->gclast;
+  if (sb->nfreepages >= MFS_GC_LOWPAGES(sb) && elapsed < MFS_GC_IDLE)
+    {
+      work_queue(LPWORK, &sb->gcwork, mfs_gc_worker, sb,
+                 MFS_GC_IDLE - elapsed);
+      again = true;
+      goto out;
+    }
+
+  if (mfs_gc_find(sb, &block) && mfs_alloc_erase_block(sb, block) >= 0)
+    {
+      sb->gcstat.bgerase++;
+      if (!sb->gcactive)
+        {
+          sb->gcstat.runs++;
+          sb->gcactive = true;
+        }
+
+      if (sb->nfreepages < MFS_GC_HIGHPAGES(sb))
+        {
+          work_queue(LPWORK, &sb->gcwork, mfs_gc_worker, sb, 0);
+          again = true;
+        }
+    }
+
+out:
+
+  /* The pass ends when the worker is not queued again */
+
+  if (!again)
+    {
+      sb->gcactive = false;
+    }
+
+  nxmutex_unlock(&sb->lock);
+}
+
+/****************************************************************************
+ * Name: mfs_gc_kick
+ *
+ * Description:
+ * Record file system activity and schedule the background worker if
+ * there is something for it to do. Called with the mount lock held.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *
+ * Returned Value:
+ * None.
+ *
+ ****************************************************************************/
+
+static void mfs_gc_kick(FAR struct mfs_sb_s *sb)
+{
+  sb->gclast = clock_systime_ticks();
+  if (sb->ndelpages >= MFS_PAGES_PER_BLOCK(sb) &&
+      sb->nfreepages < MFS_GC_HIGHPAGES(sb) &&
+      work_available(&sb->gcwork))
+    {
+      work_queue(LPWORK, &sb->gcwork, mfs_gc_worker, sb,
+                 sb->nfreepages < MFS_GC_LOWPAGES(sb) ? 0 : MFS_GC_IDLE);
+    }
+}
+
+#endif /* CONFIG_FS_MNEMOFS_GC */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -976,6 +1236,11 @@ int mfs_alloc_init(FAR struct mfs_sb_s *sb)
 
   sb->bitmapsize = (MFS_PAGE_COUNT(sb) + 7) / 8;
   sb->nextpage   = MFS_LOCATION_INVALID;
+  sb->nfreepages = 0;
+  sb->ndelpages  = 0;
+#ifdef CONFIG_FS_MNEMOFS_GC
+  sb->gcnext     = firstblock;
+#endif
   sb->freepages  = kmm_zalloc(sb->bitmapsize);
   if (sb->freepages == NULL)
     {
@@ -1075,6 +1340,8 @@ void mfs_alloc_uninit(FAR struct mfs_sb_s *sb)
   sb->delpages   = NULL;
   sb->bitmapsize = 0;
   sb->nextpage   = MFS_LOCATION_INVALID;
+  sb->nfreepages = 0;
+  sb->ndelpages  = 0;
 }
 
 /****************************************************************************
@@ -1133,12 +1400,22 @@ int mfs_alloc_page(FAR struct mfs_sb_s *sb, FAR mfs_t *page)
           mfs_alloc_mark_page_used(sb, candidate);
           * page = candidate;
           sb->nextpage = mfs_next_data_page(sb, candidate);
+#ifdef CONFIG_FS_MNEMOFS_GC
+          mfs_gc_kick(sb);
+#endif
           return OK;
         }
 
       candidate = mfs_next_data_page(sb, candidate);
     }
 
+#ifdef CONFIG_FS_MNEMOFS_GC
+  if (mfs_gc_reclaim_one(sb) == OK)
+    {
+      return mfs_alloc_page(sb, page);
+    }
+#endif
+
   ferr("no free page\n");
   return -ENOSPC;
 }
@@ -1211,12 +1488,22 @@ int mfs_alloc_block(FAR struct mfs_sb_s *sb, FAR mfs_t *block)
           sb->nextpage = MFS_BLOCK_TO_PAGE(sb,
                                            mfs_next_data_block(sb,
                                                                candidate));
+#ifdef CONFIG_FS_MNEMOFS_GC
+          mfs_gc_kick(sb);
+#endif
           return OK;
         }
 
       candidate = mfs_next_data_block(sb, candidate);
     }
 
+#ifdef CONFIG_FS_MNEMOFS_GC
+  if (mfs_gc_reclaim_one(sb) == OK)
+    {
+      return mfs_alloc_block(sb, block);
+    }
+#endif
+
   ferr("no free block\n");
   return -ENOSPC;
 }
@@ -1341,3 +1628,28 @@ int mfs_report_block_deleted(FAR struct mfs_sb_s *sb, mfs_t block)
 
   return ret;
 }
+
+#ifdef CONFIG_FS_MNEMOFS_GC
+
+/****************************************************************************
+ * Name: mfs_gc_uninit
+ *
+ * Description:
+ * Wait for the background worker to finish. Must be called without the
+ * mount lock held and after mfs_alloc_uninit(), so that a worker that is
+ * already running finds nothing to do.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *
+ * Returned Value:
+ * None.
+ *
+ ****************************************************************************/
+
+void mfs_gc_uninit(FAR struct mfs_sb_s *sb)
+{
+  work_cancel_sync(LPWORK, &sb->gcwork);
+}
+
+#endif /* CONFIG_FS_MNEMOFS_GC */
@@ -0,0 +1,292 @@
+/****************************************************************************
+ * fs/mnemofs/mnemofs_procfs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/procfs.h>
+
+#include "mnemofs.h"
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define MFS_PROCFS_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct mfs_procfs_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  char line[MFS_PROCFS_LINELEN];     /* Pre-allocated buffer for lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     mfs_procfs_open(FAR struct file *filep,
+                               FAR const char *relpath, int oflags,
+                               mode_t mode);
+static int     mfs_procfs_close(FAR struct file *filep);
+static ssize_t mfs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen);
+static int     mfs_procfs_dup(FAR const struct file *oldp,
+                              FAR struct file *newp);
+static int     mfs_procfs_stat(FAR const char *relpath,
+                               FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct list_node g_mfs_mounts = LIST_INITIAL_VALUE(g_mfs_mounts);
+static mutex_t g_mfs_mounts_lock = NXMUTEX_INITIALIZER;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct procfs_operations g_mnemofs_procfs_operations =
+{
+  mfs_procfs_open,   /* open */
+  mfs_procfs_close,  /* close */
+  mfs_procfs_read,   /* read */
+  NULL,              /* write */
+  NULL,              /* poll */
+  mfs_procfs_dup,    /* dup */
+  NULL,              /* opendir */
+  NULL,              /* closedir */
+  NULL,              /* readdir */
+  NULL,              /* rewinddir */
+  mfs_procfs_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mfs_procfs_open
+ ****************************************************************************/
+
+static int mfs_procfs_open(FAR struct file *filep, FAR const char *relpath,
+                           int oflags, mode_t mode)
+{
+  FAR struct mfs_procfs_file_s *procfile;
+
+  /* PROCFS is read-only */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  procfile = kmm_zalloc(sizeof(struct mfs_procfs_file_s));
+  if (procfile == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mfs_procfs_close
+ ****************************************************************************/
+
+static int mfs_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mfs_procfs_read
+ *
+ * Description:
+ *   Print one line per mounted volume with the page allocator state and
+ *   the block reclamation counters.  The values are read without taking
+ *   the mount lock, so they are a best-effort snapshot.
+ *
+ ****************************************************************************/
+
+static ssize_t mfs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                               size_t buflen)
+{
+  FAR struct mfs_procfs_file_s *procfile;
+  FAR struct mfs_sb_s *sb;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  offset    = filep->f_pos;
+  procfile  = filep->f_priv;
+  linesize  = procfs_snprintf(procfile->line, MFS_PROCFS_LINELEN,
+                              "%-12s%10s%10s%10s%10s%10s%10s\n", "device",
+                              "pages", "free", "deleted", "bgerase",
+                              "fgerase", "gcruns");
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  nxmutex_lock(&g_mfs_mounts_lock);
+  list_for_every_entry(&g_mfs_mounts, sb, struct mfs_sb_s, node)
+    {
+      if (totalsize >= buflen)
+        {
+          break;
+        }
+
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = procfs_snprintf(procfile->line, MFS_PROCFS_LINELEN,
+                                   "%-12s%10lu%10lu%10lu%10lu%10lu%10lu\n",
+                                   sb->driver->i_name,
+                                   (unsigned long)MFS_PAGE_COUNT(sb),
+                                   (unsigned long)sb->nfreepages,
+                                   (unsigned long)sb->ndelpages,
+                                   (unsigned long)sb->gcstat.bgerase,
+                                   (unsigned long)sb->gcstat.fgerase,
+                                   (unsigned long)sb->gcstat.runs);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  nxmutex_unlock(&g_mfs_mounts_lock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: mfs_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int mfs_procfs_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct mfs_procfs_file_s *oldattr;
+  FAR struct mfs_procfs_file_s *newattr;
+
+  oldattr = oldp->f_priv;
+  newattr = kmm_malloc(sizeof(struct mfs_procfs_file_s));
+  if (newattr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memcpy(newattr, oldattr, sizeof(struct mfs_procfs_file_s));
+  newp->f_priv = newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: mfs_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int mfs_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mfs_procfs_register
+ *
+ * Description:
+ * Make a mounted volume visible in /proc/fs/mnemofs.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *
+ * Returned Value:
+ * None.
+ *
+ ****************************************************************************/
+
+void mfs_procfs_register(FAR struct mfs_sb_s *sb)
+{
+  nxmutex_lock(&g_mfs_mounts_lock);
+  list_add_tail(&g_mfs_mounts, &sb->node);
+  nxmutex_unlock(&g_mfs_mounts_lock);
+}
+
+/****************************************************************************
+ * Name: mfs_procfs_unregister
+ *
+ * Description:
+ * Remove a volume from /proc/fs/mnemofs before it is unmounted.
+ *
+ * Input Parameters:
+ *   sb - The mounted file system instance.
+ *
+ * Returned Value:
+ * None.
+ *
+ ****************************************************************************/
+
+void mfs_procfs_unregister(FAR struct mfs_sb_s *sb)
+{
+  nxmutex_lock(&g_mfs_mounts_lock);
+  list_delete(&sb->node);
+  nxmutex_unlock(&g_mfs_mounts_lock);
+}
+
+#endif /* CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS */
@@ -97,6 +97,7 @@ static int nxmq_file_poll(FAR struct file *filep,
   FAR struct mqueue_inode_s *msgq = inode->i_private;
   pollevent_t eventset = 0;
   irqstate_t flags;
+  int nmsgs;
   int ret = 0;
   int i;
 
@@ -127,12 +128,20 @@ static int nxmq_file_poll(FAR struct file *filep,
 
       /* Immediately notify on any of the requested events */
 
-      if (msgq->nmsgs < msgq->maxmsgs)
+      nmsgs = msgq->nmsgs;
+#ifdef CONFIG_MQ_RING
+      if (msgq->ring != NULL)
+        {
+          nmsgs = nxmq_ring_count(msgq);
+        }
+#endif
+
+      if (nmsgs < msgq->maxmsgs)
         {
           eventset |= POLLOUT;
         }
 
-      if (msgq->nmsgs > 0)
+      if (nmsgs > 0)
         {
           eventset |= POLLIN;
         }
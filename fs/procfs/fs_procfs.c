@@ -69,6 +69,7 @@ extern const struct procfs_operations g_mempool_operations;
 extern const struct procfs_operations g_module_operations;
 extern const struct procfs_operations g_pm_operations;
 extern const struct procfs_operations g_proc_operations;
+extern const struct procfs_operations g_schedlat_operations;
 extern const struct procfs_operations g_tcbinfo_operations;
 extern const struct procfs_operations g_thermal_operations;
 extern const struct procfs_operations g_uptime_operations;
@@ -88,6 +89,7 @@ extern const struct procfs_operations g_mount_operations;
 extern const struct procfs_operations g_net_operations;
 extern const struct procfs_operations g_netroute_operations;
 extern const struct procfs_operations g_part_operations;
+extern const struct procfs_operations g_mnemofs_procfs_operations;
 extern const struct procfs_operations g_smartfs_procfs_operations;
 
 /****************************************************************************
@@ -132,6 +134,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/blocks",    &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_FS_MNEMOFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MNEMOFS)
+  { "fs/mnemofs",   &g_mnemofs_procfs_operations, PROCFS_FILE_TYPE },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_MOUNT
   { "fs/mount",     &g_mount_operations,    PROCFS_FILE_TYPE   },
 #endif
@@ -190,6 +196,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "pressure/**",  &g_pressure_operations, PROCFS_FILE_TYPE   },
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+  { "schedlat",     &g_schedlat_operations, PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_PROCESS
   { "self",         &g_proc_operations,     PROCFS_DIR_TYPE    },
   { "self/**",      &g_proc_operations,     PROCFS_UNKOWN_TYPE },
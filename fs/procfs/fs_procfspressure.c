@@ -28,18 +28,61 @@
 #include <errno.h>
 #include <poll.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/param.h>
 #include <sys/stat.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/fs/procfs.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 #include <nuttx/queue.h>
+#include <nuttx/sched.h>
 #include <nuttx/spinlock.h>
 
 #include "fs_heap.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Resources, the index of the file name in g_pressure_names */
+
+#define PRESSURE_MEMORY      0
+#define PRESSURE_CPU         1
+#define PRESSURE_IO          2
+
+#ifdef CONFIG_SCHED_PRESSURE
+
+/* Stall states, the bit numbers of the PRESSURE_xxx_SOME/FULL flags.  The
+ * "some" state of a resource is followed by its "full" state.
+ */
+
+#define PRESSURE_NSTATES     4
+#define PRESSURE_STATE(r)    (((r) - PRESSURE_CPU) * 2)
+
+/* The averages are updated every two seconds, with the fixed point format
+ * and the decay factors (1 / exp(2s / 10s) etc.) of the Linux PSI.
+ */
+
+#define PRESSURE_PERIOD      (2 * USEC_PER_SEC)
+#define PRESSURE_FSHIFT      11
+#define PRESSURE_FIXED_1     (1 << PRESSURE_FSHIFT)
+#define PRESSURE_NAVGS       3
+
+#define PRESSURE_INT(x)      ((unsigned long)(x) >> PRESSURE_FSHIFT)
+#define PRESSURE_FRAC(x) \
+  PRESSURE_INT(((x) & (PRESSURE_FIXED_1 - 1)) * 100)
+
+/* Limits of the trigger window in us */
+
+#define PRESSURE_MIN_WINDOW  (500 * USEC_PER_MSEC)
+#define PRESSURE_MAX_WINDOW  (10 * USEC_PER_SEC)
+
+#endif /* CONFIG_SCHED_PRESSURE */
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -52,8 +95,32 @@ struct pressure_file_s
   size_t threshold;                 /* Memory notification threshold */
   clock_t lasttick;                 /* Last time notified */
   clock_t interval;                 /* Notification interval in us */
+#ifdef CONFIG_SCHED_PRESSURE
+  uint8_t resource;                 /* PRESSURE_MEMORY, _CPU or _IO */
+  uint8_t state;                    /* Stall state of the trigger */
+  bool fired;                       /* Trigger fired in this window */
+  bool pending;                     /* Fired while nobody was polling */
+  uint64_t winstart;                /* Start time of the trigger window */
+  uint64_t winstall;                /* Stall time at winstart */
+#endif
+};
+
+#ifdef CONFIG_SCHED_PRESSURE
+
+/* Accounting of one stall state.  For CPU and I/O triggers, threshold and
+ * interval of struct pressure_file_s hold the stall time and the window
+ * length in us.
+ */
+
+struct pressure_stall_s
+{
+  uint64_t total;                   /* Accumulated stall time in us */
+  uint64_t lasttotal;               /* total at the start of the period */
+  uint32_t avg[PRESSURE_NAVGS];     /* Fixed point stall percentages */
 };
 
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -63,6 +130,27 @@ static spinlock_t g_pressure_lock;
 static size_t g_remaining;
 static size_t g_largest;
 
+static FAR const char * const g_pressure_names[] =
+{
+  "memory",
+#ifdef CONFIG_SCHED_PRESSURE
+  "cpu",
+  "io",
+#endif
+};
+
+#ifdef CONFIG_SCHED_PRESSURE
+static dq_queue_t g_pressure_stall_queue;
+static struct pressure_stall_s g_pressure_stall[PRESSURE_NSTATES];
+static uint64_t g_pressure_clock;   /* Sampled time in us */
+static uint64_t g_pressure_period;  /* Start of the averaging period */
+
+static const uint16_t g_pressure_exp[PRESSURE_NAVGS] =
+{
+  1677, 1981, 2034
+};
+#endif
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -109,6 +197,191 @@ const struct procfs_operations g_pressure_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: pressure_find
+ *
+ * Description:
+ *   Return the resource of a pressure file, or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int pressure_find(FAR const char *relpath)
+{
+  int i;
+
+  if (strncmp(relpath, "pressure/", 9) == 0)
+    {
+      for (i = 0; i < nitems(g_pressure_names); i++)
+        {
+          if (strcmp(relpath + 9, g_pressure_names[i]) == 0)
+            {
+              return i;
+            }
+        }
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: pressure_queue
+ ****************************************************************************/
+
+static FAR dq_queue_t *pressure_queue(FAR struct pressure_file_s *priv)
+{
+#ifdef CONFIG_SCHED_PRESSURE
+  if (priv->resource != PRESSURE_MEMORY)
+    {
+      return &g_pressure_stall_queue;
+    }
+#endif
+
+  return &g_pressure_memory_queue;
+}
+
+#ifdef CONFIG_SCHED_PRESSURE
+
+/****************************************************************************
+ * Name: pressure_update_averages
+ *
+ * Description:
+ *   Fold the stall time of the last period into the running averages.
+ *
+ ****************************************************************************/
+
+static void pressure_update_averages(uint64_t period)
+{
+  FAR struct pressure_stall_s *stall;
+  uint32_t pct;
+  int i;
+  int j;
+
+  for (i = 0; i < PRESSURE_NSTATES; i++)
+    {
+      stall = &g_pressure_stall[i];
+      pct   = MIN((stall->total - stall->lasttotal) * 100 / period, 100);
+      pct  *= PRESSURE_FIXED_1;
+
+      for (j = 0; j < PRESSURE_NAVGS; j++)
+        {
+          stall->avg[j] = (stall->avg[j] * g_pressure_exp[j] +
+                           pct * (PRESSURE_FIXED_1 - g_pressure_exp[j]) +
+                           PRESSURE_FIXED_1 / 2) >> PRESSURE_FSHIFT;
+        }
+
+      stall->lasttotal = stall->total;
+    }
+}
+
+/****************************************************************************
+ * Name: pressure_read_stall
+ *
+ * Description:
+ *   Print the "some" and "full" lines of a CPU or I/O pressure file.
+ *
+ ****************************************************************************/
+
+static ssize_t pressure_read_stall(FAR struct file *filep,
+                                   FAR char *buffer, size_t buflen)
+{
+  FAR struct pressure_file_s *priv = filep->f_priv;
+  struct pressure_stall_s stall[2];
+  char buf[160];
+  uint32_t flags;
+  size_t len = 0;
+  off_t offset;
+  ssize_t ret;
+  int i;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  memcpy(stall, &g_pressure_stall[PRESSURE_STATE(priv->resource)],
+         sizeof(stall));
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+
+  for (i = 0; i < 2; i++)
+    {
+      len += procfs_snprintf(buf + len, sizeof(buf) - len,
+                             "%s avg10=%lu.%02lu avg60=%lu.%02lu "
+                             "avg300=%lu.%02lu total=%llu\n",
+                             i == 0 ? "some" : "full",
+                             PRESSURE_INT(stall[i].avg[0]),
+                             PRESSURE_FRAC(stall[i].avg[0]),
+                             PRESSURE_INT(stall[i].avg[1]),
+                             PRESSURE_FRAC(stall[i].avg[1]),
+                             PRESSURE_INT(stall[i].avg[2]),
+                             PRESSURE_FRAC(stall[i].avg[2]),
+                             (unsigned long long)stall[i].total);
+    }
+
+  offset = filep->f_pos;
+  ret    = procfs_memcpy(buf, len, buffer, buflen, &offset);
+
+  filep->f_pos += ret;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pressure_write_stall
+ *
+ * Description:
+ *   Set up the trigger of a CPU or I/O pressure file.  The format is
+ *   "some|full <stall us> <window us>", the file becomes readable for
+ *   POLLPRI once per window if the stall time within the window reaches
+ *   the threshold.
+ *
+ ****************************************************************************/
+
+static ssize_t pressure_write_stall(FAR struct file *filep,
+                                    FAR const char *buffer, size_t buflen)
+{
+  FAR struct pressure_file_s *priv = filep->f_priv;
+  FAR char *endptr;
+  unsigned long threshold;
+  unsigned long window;
+  uint8_t state;
+  uint32_t flags;
+  char buf[64];
+
+  if (buflen >= sizeof(buf))
+    {
+      return -EINVAL;
+    }
+
+  memcpy(buf, buffer, buflen);
+  buf[buflen] = '\0';
+
+  state = PRESSURE_STATE(priv->resource);
+  if (strncmp(buf, "full ", 5) == 0)
+    {
+      state++;
+    }
+  else if (strncmp(buf, "some ", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  threshold = strtoul(buf + 5, &endptr, 0);
+  window    = strtoul(endptr, NULL, 0);
+  if (window < PRESSURE_MIN_WINDOW || window > PRESSURE_MAX_WINDOW ||
+      threshold == 0 || threshold > window)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  priv->state     = state;
+  priv->threshold = threshold;
+  priv->interval  = window;
+  priv->winstart  = g_pressure_clock;
+  priv->winstall  = g_pressure_stall[state].total;
+  priv->fired     = false;
+  priv->pending   = false;
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+  return buflen;
+}
+
+#endif /* CONFIG_SCHED_PRESSURE */
+
 /****************************************************************************
  * Name: pressure_open
  ****************************************************************************/
@@ -118,11 +391,13 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct pressure_file_s *priv;
   uint32_t flags;
+  int resource;
 
-  if (strcmp(relpath, "pressure/memory") != 0)
+  resource = pressure_find(relpath);
+  if (resource < 0)
     {
       ferr("ERROR: relpath is invalid: %s\n", relpath);
-      return -ENOENT;
+      return resource;
     }
 
   priv = fs_heap_zalloc(sizeof(struct pressure_file_s));
@@ -131,10 +406,14 @@ static int pressure_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#ifdef CONFIG_SCHED_PRESSURE
+  priv->resource = resource;
+#endif
+
   flags = spin_lock_irqsave(&g_pressure_lock);
   priv->interval = CLOCK_MAX;
   filep->f_priv = priv;
-  dq_addfirst(&priv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   return OK;
 }
@@ -149,7 +428,7 @@ static int pressure_close(FAR struct file *filep)
   uint32_t flags;
 
   flags = spin_lock_irqsave(&g_pressure_lock);
-  dq_rem(&priv->entry, &g_pressure_memory_queue);
+  dq_rem(&priv->entry, pressure_queue(priv));
   spin_unlock_irqrestore(&g_pressure_lock, flags);
   fs_heap_free(priv);
   return OK;
@@ -169,6 +448,14 @@ static ssize_t pressure_read(FAR struct file *filep, FAR char *buffer,
   off_t offset;
   ssize_t ret;
 
+#ifdef CONFIG_SCHED_PRESSURE
+  if (((FAR struct pressure_file_s *)filep->f_priv)->resource !=
+      PRESSURE_MEMORY)
+    {
+      return pressure_read_stall(filep, buffer, buflen);
+    }
+#endif
+
   flags   = spin_lock_irqsave(&g_pressure_lock);
   remain  = g_remaining;
   largest = g_largest;
@@ -207,6 +494,13 @@ static ssize_t pressure_write(FAR struct file *filep, FAR const char *buffer,
       return -EINVAL;
     }
 
+#ifdef CONFIG_SCHED_PRESSURE
+  if (priv->resource != PRESSURE_MEMORY)
+    {
+      return pressure_write_stall(filep, buffer, buflen);
+    }
+#endif
+
   threshold = strtoul(buffer, &endptr, 0);
   if (threshold == 0)
     {
@@ -256,6 +550,22 @@ static int pressure_poll(FAR struct file *filep, FAR struct pollfd *fds,
           priv->fds = fds;
           fds->priv = &priv->fds;
 
+#ifdef CONFIG_SCHED_PRESSURE
+          /* Report a trigger that fired while nobody was polling */
+
+          if (priv->resource != PRESSURE_MEMORY)
+            {
+              if (priv->pending)
+                {
+                  priv->pending = false;
+                  spin_unlock_irqrestore(&g_pressure_lock, flags);
+                  poll_notify(&priv->fds, 1, POLLPRI);
+                  return OK;
+                }
+            }
+          else
+#endif
+
           /* If the remaining memory is less than the threshold and
            * lasttick is CLOCK_MAX, it means the event is triggered for
            * the first time and we should always send a notification.
@@ -304,7 +614,7 @@ static int pressure_dup(FAR const struct file *oldp, FAR struct file *newp)
 
   flags = spin_lock_irqsave(&g_pressure_lock);
   memcpy(newpriv, oldpriv, sizeof(struct pressure_file_s));
-  dq_addfirst(&newpriv->entry, &g_pressure_memory_queue);
+  dq_addfirst(&newpriv->entry, pressure_queue(newpriv));
   newpriv->fds = NULL;
   newp->f_priv = newpriv;
   spin_unlock_irqrestore(&g_pressure_lock, flags);
@@ -330,7 +640,7 @@ static int pressure_opendir(FAR const char *relpath,
     }
 
   level->level    = 1;
-  level->nentries = 1;
+  level->nentries = nitems(g_pressure_names);
 
   *dir = (FAR struct fs_dirent_s *)level;
   return OK;
@@ -365,7 +675,8 @@ static int pressure_readdir(FAR struct fs_dirent_s *dir,
     }
 
   entry->d_type = DTYPE_FILE;
-  strncpy(entry->d_name, "memory", sizeof(entry->d_name));
+  strlcpy(entry->d_name, g_pressure_names[level->index],
+          sizeof(entry->d_name));
   level->index++;
   return OK;
 }
@@ -396,7 +707,7 @@ static int pressure_stat(const char *relpath, struct stat *buf)
     {
       buf->st_mode = S_IFDIR | S_IROTH | S_IRGRP | S_IRUSR;
     }
-  else if (strcmp(relpath, "pressure/memory") == 0)
+  else if (pressure_find(relpath) >= 0)
     {
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWOTH |
                      S_IWGRP | S_IWUSR;
@@ -471,3 +782,95 @@ void mm_notify_pressure(size_t remaining, size_t largest)
   spin_unlock_irqrestore(&g_pressure_lock, flags);
 }
 
+#ifdef CONFIG_SCHED_PRESSURE
+
+/****************************************************************************
+ * Name: nxsched_notify_pressure
+ *
+ * Description:
+ *   Account a sample of the CPU and I/O stall state and fire the triggers
+ *   whose threshold is reached.  This is called by the scheduler with the
+ *   CPU load clock.
+ *
+ * Input Parameters:
+ *   elapsed - The time since the last sample in us
+ *   stalled - The PRESSURE_xxx flags of the stall states found
+ *
+ ****************************************************************************/
+
+void nxsched_notify_pressure(uint32_t elapsed, unsigned int stalled)
+{
+  FAR struct pressure_stall_s *stall;
+  FAR dq_entry_t *entry;
+  FAR dq_entry_t *tmp;
+  uint32_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_pressure_lock);
+  g_pressure_clock += elapsed;
+
+  for (i = 0; i < PRESSURE_NSTATES; i++)
+    {
+      if ((stalled & (1 << i)) != 0)
+        {
+          g_pressure_stall[i].total += elapsed;
+        }
+    }
+
+  if (g_pressure_clock - g_pressure_period >= PRESSURE_PERIOD)
+    {
+      pressure_update_averages(g_pressure_clock - g_pressure_period);
+      g_pressure_period = g_pressure_clock;
+    }
+
+  dq_for_every_safe(&g_pressure_stall_queue, entry, tmp)
+    {
+      FAR struct pressure_file_s *pressure =
+          container_of(entry, struct pressure_file_s, entry);
+
+      /* Skip the files without a trigger */
+
+      if (pressure->threshold == 0)
+        {
+          continue;
+        }
+
+      /* Start a new window once the current one is over */
+
+      stall = &g_pressure_stall[pressure->state];
+      if (g_pressure_clock - pressure->winstart >= pressure->interval)
+        {
+          pressure->winstart = g_pressure_clock;
+          pressure->winstall = stall->total;
+          pressure->fired    = false;
+        }
+
+      /* Fire at most once per window */
+
+      if (pressure->fired ||
+          stall->total - pressure->winstall < pressure->threshold)
+        {
+          continue;
+        }
+
+      pressure->fired = true;
+
+      /* If fds is NULL, it means no one is listening for the event and
+       * we should delay sending the notification.
+       */
+
+      if (pressure->fds == NULL)
+        {
+          pressure->pending = true;
+          continue;
+        }
+
+      spin_unlock_irqrestore(&g_pressure_lock, flags);
+      poll_notify(&pressure->fds, 1, POLLPRI);
+      flags = spin_lock_irqsave(&g_pressure_lock);
+    }
+
+  spin_unlock_irqrestore(&g_pressure_lock, flags);
+}
+
+#endif /* CONFIG_SCHED_PRESSURE */
@@ -99,6 +99,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  PROC_SCHEDLAT,                      /* Wakeup latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -190,6 +193,14 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+static ssize_t proc_schedlat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+static ssize_t proc_schedlat_write(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR const char *buffer,
+                 size_t buflen, off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -302,6 +313,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_LATENCY
+static const struct proc_node_s g_schedlat =
+{
+  "schedlat",     "schedlat", (uint8_t)PROC_SCHEDLAT,    DTYPE_FILE        /* Wakeup latency histogram */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -356,6 +374,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  &g_schedlat,     /* Wakeup latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -385,6 +406,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+  &g_schedlat,     /* Wakeup latency histogram */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -944,6 +968,82 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedlat
+ *
+ * Description:
+ *   Print the wakeup latency histogram of the thread, one line per bucket
+ *   with the upper bound of the bucket in microseconds.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+static ssize_t proc_schedlat(FAR struct proc_file_s *procfile,
+                             FAR struct tcb_s *tcb, FAR char *buffer,
+                             size_t buflen, off_t offset)
+{
+  size_t remaining = buflen;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize = 0;
+  char label[16];
+  int i;
+
+  /* Show the longest latency */
+
+  linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                               "%-12s%" PRIu32 "\n", "MaxUs:",
+                               tcb->latency.max);
+  copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                             &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  /* Show the count of each bucket */
+
+  for (i = 0; i < CONFIG_SCHED_LATENCY_NBUCKETS && totalsize < buflen; i++)
+    {
+      if (i < CONFIG_SCHED_LATENCY_NBUCKETS - 1)
+        {
+          snprintf(label, sizeof(label), "<%lu:", 1ul << i);
+        }
+      else
+        {
+          snprintf(label, sizeof(label), ">=%lu:", 1ul << (i - 1));
+        }
+
+      linesize   = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                                   "%-12s%" PRIu32 "\n", label,
+                                   tcb->latency.count[i]);
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer,
+                                 remaining, &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  return totalsize;
+}
+
+static ssize_t proc_schedlat_write(FAR struct proc_file_s *procfile,
+                                   FAR struct tcb_s *tcb,
+                                   FAR const char *buffer,
+                                   size_t buflen, off_t offset)
+{
+  irqstate_t flags;
+
+  /* Any write resets the histogram */
+
+  flags = enter_critical_section();
+  memset(&tcb->latency, 0, sizeof(tcb->latency));
+  leave_critical_section(flags);
+  return buflen;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1692,6 +1792,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+    case PROC_SCHEDLAT: /* Wakeup latency histogram */
+      ret = proc_schedlat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -1772,6 +1877,12 @@ static ssize_t proc_write(FAR struct file *filep, FAR const char *buffer,
                                    filep->f_pos);
         break;
 #endif
+#ifdef CONFIG_SCHED_LATENCY
+      case PROC_SCHEDLAT:
+        ret = proc_schedlat_write(procfile, tcb, buffer, buflen,
+                                  filep->f_pos);
+        break;
+#endif
 
       default:
         ret = -EINVAL;
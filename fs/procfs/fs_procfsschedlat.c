@@ -0,0 +1,368 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsschedlat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <nuttx/debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+#include <nuttx/sched.h>
+
+#include "fs_heap.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+     defined(CONFIG_SCHED_LATENCY)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest field generated by this logic.
+ */
+
+#define SCHEDLAT_LINELEN 32
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct schedlat_file_s
+{
+  struct procfs_file_s  base;   /* Base open file structure */
+  char line[SCHEDLAT_LINELEN];  /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     schedlat_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     schedlat_close(FAR struct file *filep);
+static ssize_t schedlat_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static ssize_t schedlat_write(FAR struct file *filep,
+                 FAR const char *buffer, size_t buflen);
+static int     schedlat_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     schedlat_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_schedlat_operations =
+{
+  schedlat_open,      /* open */
+  schedlat_close,     /* close */
+  schedlat_read,      /* read */
+  schedlat_write,     /* write */
+  NULL,               /* poll */
+
+  schedlat_dup,       /* dup */
+
+  NULL,               /* opendir */
+  NULL,               /* closedir */
+  NULL,               /* readdir */
+  NULL,               /* rewinddir */
+
+  schedlat_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedlat_open
+ ****************************************************************************/
+
+static int schedlat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct schedlat_file_s *attr;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  attr = fs_heap_zalloc(sizeof(struct schedlat_file_s));
+  if (!attr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)attr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_close
+ ****************************************************************************/
+
+static int schedlat_close(FAR struct file *filep)
+{
+  FAR struct schedlat_file_s *attr;
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct schedlat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  /* Release the file attributes structure */
+
+  fs_heap_free(attr);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_read_row
+ *
+ * Description:
+ *   Generate one row of the table: the label of the row followed by one
+ *   column per CPU.  The bucket index selects the row; the last row shows
+ *   the longest latency of each CPU.
+ *
+ ****************************************************************************/
+
+static size_t schedlat_read_row(FAR struct schedlat_file_s *attr,
+                                FAR char *buffer, size_t buflen,
+                                FAR off_t *offset, int bucket)
+{
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  char label[16];
+  uint32_t value;
+  int cpu;
+
+  if (bucket == CONFIG_SCHED_LATENCY_NBUCKETS)
+    {
+      strlcpy(label, "MaxUs", sizeof(label));
+    }
+  else if (bucket < CONFIG_SCHED_LATENCY_NBUCKETS - 1)
+    {
+      snprintf(label, sizeof(label), "<%lu", 1ul << bucket);
+    }
+  else
+    {
+      snprintf(label, sizeof(label), ">=%lu", 1ul << (bucket - 1));
+    }
+
+  linesize  = procfs_snprintf(attr->line, SCHEDLAT_LINELEN, "%-12s",
+                              label);
+  copysize  = procfs_memcpy(attr->line, linesize, buffer, buflen, offset);
+  totalsize = copysize;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+    {
+      if (bucket == CONFIG_SCHED_LATENCY_NBUCKETS)
+        {
+          value = g_cpu_schedlat[cpu].max;
+        }
+      else
+        {
+          value = g_cpu_schedlat[cpu].count[bucket];
+        }
+
+      linesize   = procfs_snprintf(attr->line, SCHEDLAT_LINELEN,
+                                   " %10" PRIu32, value);
+      copysize   = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, offset);
+      totalsize += copysize;
+    }
+
+  if (totalsize < buflen)
+    {
+      linesize   = procfs_snprintf(attr->line, SCHEDLAT_LINELEN, "\n");
+      copysize   = procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, offset);
+      totalsize += copysize;
+    }
+
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: schedlat_read
+ ****************************************************************************/
+
+static ssize_t schedlat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct schedlat_file_s *attr;
+  size_t linesize;
+  size_t totalsize;
+  off_t offset;
+  int cpu;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  attr = (FAR struct schedlat_file_s *)filep->f_priv;
+  DEBUGASSERT(attr);
+
+  offset = filep->f_pos;
+
+  /* Generate the header with one column per CPU */
+
+  linesize  = procfs_snprintf(attr->line, SCHEDLAT_LINELEN, "%-12s", "Us");
+  totalsize = procfs_memcpy(attr->line, linesize, buffer, buflen, &offset);
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+    {
+      linesize   = procfs_snprintf(attr->line, SCHEDLAT_LINELEN,
+                                   "       CPU%d", cpu);
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  if (totalsize < buflen)
+    {
+      linesize   = procfs_snprintf(attr->line, SCHEDLAT_LINELEN, "\n");
+      totalsize += procfs_memcpy(attr->line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  /* Then one row per bucket, and the longest latency */
+
+  for (i = 0; i <= CONFIG_SCHED_LATENCY_NBUCKETS && totalsize < buflen; i++)
+    {
+      totalsize += schedlat_read_row(attr, buffer + totalsize,
+                                     buflen - totalsize, &offset, i);
+    }
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: schedlat_write
+ *
+ * Description:
+ *   Any write resets the histograms of all CPUs.
+ *
+ ****************************************************************************/
+
+static ssize_t schedlat_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  memset(g_cpu_schedlat, 0, sizeof(g_cpu_schedlat));
+  leave_critical_section(flags);
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: schedlat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int schedlat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct schedlat_file_s *oldattr;
+  FAR struct schedlat_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct schedlat_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = fs_heap_malloc(sizeof(struct schedlat_file_s));
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct schedlat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int schedlat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "schedlat" is the name for a read/write file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS && CONFIG_SCHED_LATENCY */
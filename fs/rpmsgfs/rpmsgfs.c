@@ -38,6 +38,7 @@
 #include <nuttx/debug.h>
 #include <limits.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
@@ -61,6 +62,22 @@ struct rpmsgfs_dir_s
 {
   struct fs_dirent_s base;
   FAR void *dir;
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  size_t pos;                          /* Next entry in entries */
+  size_t len;                          /* Valid bytes in entries */
+  char entries[RPMSGFS_READDIRS_SIZE]; /* Batch from the server */
+#endif
+};
+
+/* A cached stat() or fstat() result */
+
+struct rpmsgfs_attr_s
+{
+  FAR char                   *path;    /* Host path, NULL for fstat() */
+  bool                       valid;
+  uint32_t                   gen;      /* Client generation when cached */
+  clock_t                    stamp;    /* Time when cached */
+  struct stat                buf;
 };
 
 /* This structure describes the state of one open file.  This structure
@@ -73,6 +90,21 @@ struct rpmsgfs_ofile_s
   int16_t                    crefs;    /* Reference count */
   mode_t                     oflags;   /* Open mode */
   int                        fd;
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  FAR char                   *rbuf[2]; /* Current and prefetch buffer */
+  size_t                     rpos;     /* Consumed bytes of rbuf[0] */
+  size_t                     rlen;     /* Valid bytes of rbuf[0] */
+  size_t                     plen;     /* Valid bytes of rbuf[1] */
+  FAR void                   *rreq;    /* Pending read into rbuf[1] */
+#endif
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  FAR char                   *wbuf;    /* Write-behind buffer */
+  size_t                     wlen;     /* Valid bytes of wbuf */
+  FAR void                   *wreq;    /* Pending write */
+#endif
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  struct rpmsgfs_attr_s      attr;     /* Cached fstat() */
+#endif
 };
 
 /* This structure represents the overall mountpoint state.  An instance of
@@ -87,6 +119,10 @@ struct rpmsgfs_mountpt_s
   char                       fs_root[PATH_MAX];
   void                       *handle;
   int                        timeout;  /* Connect timeout */
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  struct rpmsgfs_attr_s      fs_attr[CONFIG_FS_RPMSGFS_ATTR_NCACHE];
+  int                        fs_attrnext; /* Next entry to replace */
+#endif
 };
 
 /****************************************************************************
@@ -272,6 +308,472 @@ static void rpmsgfs_mkpath(FAR struct rpmsgfs_mountpt_s *fs,
     }
 }
 
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+/****************************************************************************
+ * Name: rpmsgfs_attr_get
+ *
+ * Description: Return a cached stat() result if it is still valid.
+ *
+ ****************************************************************************/
+
+static bool rpmsgfs_attr_get(FAR struct rpmsgfs_mountpt_s *fs,
+                             FAR const struct rpmsgfs_attr_s *attr,
+                             FAR struct stat *buf)
+{
+  if (!attr->valid ||
+      attr->gen != rpmsgfs_client_generation(fs->handle) ||
+      clock_systime_ticks() - attr->stamp >=
+      MSEC2TICK(CONFIG_FS_RPMSGFS_ATTR_TIMEOUT))
+    {
+      return false;
+    }
+
+  memcpy(buf, &attr->buf, sizeof(*buf));
+  return true;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_set
+ ****************************************************************************/
+
+static void rpmsgfs_attr_set(FAR struct rpmsgfs_mountpt_s *fs,
+                             FAR struct rpmsgfs_attr_s *attr,
+                             FAR const struct stat *buf)
+{
+  memcpy(&attr->buf, buf, sizeof(*buf));
+  attr->gen   = rpmsgfs_client_generation(fs->handle);
+  attr->stamp = clock_systime_ticks();
+  attr->valid = true;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_lookup
+ *
+ * Description: Find the stat() cache entry of a host path.
+ *
+ ****************************************************************************/
+
+static FAR struct rpmsgfs_attr_s *
+rpmsgfs_attr_lookup(FAR struct rpmsgfs_mountpt_s *fs, FAR const char *path)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_ATTR_NCACHE; i++)
+    {
+      if (fs->fs_attr[i].path != NULL &&
+          strcmp(fs->fs_attr[i].path, path) == 0)
+        {
+          return &fs->fs_attr[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_insert
+ *
+ * Description: Cache the stat() result of a host path, replacing the
+ *   entries round robin.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_insert(FAR struct rpmsgfs_mountpt_s *fs,
+                                FAR const char *path,
+                                FAR const struct stat *buf)
+{
+  FAR struct rpmsgfs_attr_s *attr;
+
+  attr = rpmsgfs_attr_lookup(fs, path);
+  if (attr == NULL)
+    {
+      attr = &fs->fs_attr[fs->fs_attrnext];
+      fs->fs_attrnext = (fs->fs_attrnext + 1) %
+                        CONFIG_FS_RPMSGFS_ATTR_NCACHE;
+
+      fs_heap_free(attr->path);
+      attr->path = fs_heap_strdup(path);
+      if (attr->path == NULL)
+        {
+          attr->valid = false;
+          return;
+        }
+    }
+
+  rpmsgfs_attr_set(fs, attr, buf);
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_attr_invalidate
+ *
+ * Description: Drop all cached attributes after a local change.  The
+ *   path of a modified open file is not known, so all entries go.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_attr_invalidate(FAR struct rpmsgfs_mountpt_s *fs)
+{
+  FAR struct rpmsgfs_ofile_s *hf;
+  int i;
+
+  for (i = 0; i < CONFIG_FS_RPMSGFS_ATTR_NCACHE; i++)
+    {
+      fs->fs_attr[i].valid = false;
+    }
+
+  for (hf = fs->fs_head; hf != NULL; hf = hf->fnext)
+    {
+      hf->attr.valid = false;
+    }
+}
+#else
+#  define rpmsgfs_attr_invalidate(fs)
+#endif
+
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+/****************************************************************************
+ * Name: rpmsgfs_rwait
+ *
+ * Description: Complete the pending read-ahead into rbuf[1].
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_rwait(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf)
+{
+  ssize_t ret;
+
+  if (hf->rreq == NULL)
+    {
+      return OK;
+    }
+
+  ret = rpmsgfs_client_wait(fs->handle, hf->rreq);
+  hf->rreq = NULL;
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  hf->plen = ret;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_rnext
+ *
+ * Description: Make the prefetched rbuf[1] the current buffer.
+ *
+ ****************************************************************************/
+
+static void rpmsgfs_rnext(FAR struct rpmsgfs_ofile_s *hf)
+{
+  FAR char *tmp = hf->rbuf[0];
+
+  hf->rbuf[0] = hf->rbuf[1];
+  hf->rbuf[1] = tmp;
+  hf->rpos    = 0;
+  hf->rlen    = hf->plen;
+  hf->plen    = 0;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_rdrop
+ *
+ * Description: Discard the read-ahead data and move the host file
+ *   position back to the position of the caller.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_rdrop(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf, off_t pos)
+{
+  bool ahead;
+  off_t ret;
+
+  ret   = rpmsgfs_rwait(fs, hf);
+  ahead = ret < 0 || hf->rpos < hf->rlen || hf->plen > 0;
+
+  hf->rpos = 0;
+  hf->rlen = 0;
+  hf->plen = 0;
+
+  if (ahead)
+    {
+      ret = rpmsgfs_client_lseek(fs->handle, hf->fd, pos, SEEK_SET);
+    }
+
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_rseek
+ *
+ * Description: Seek inside the read-ahead data.  Returns false if the
+ *   target is not buffered.
+ *
+ ****************************************************************************/
+
+static bool rpmsgfs_rseek(FAR struct rpmsgfs_mountpt_s *fs,
+                          FAR struct rpmsgfs_ofile_s *hf,
+                          off_t pos, off_t target)
+{
+  off_t start = pos - hf->rpos;
+
+  if (rpmsgfs_rwait(fs, hf) < 0)
+    {
+      return false;
+    }
+
+  if (target >= start && target <= start + hf->rlen)
+    {
+      hf->rpos = target - start;
+      return true;
+    }
+
+  /* rbuf[1] continues right where rbuf[0] ends */
+
+  start += hf->rlen;
+  if (hf->plen > 0 && target > start && target <= start + hf->plen)
+    {
+      rpmsgfs_rnext(hf);
+      hf->rpos = target - start;
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_rread
+ *
+ * Description: Read through the read-ahead buffers.  After a full buffer
+ *   was consumed, the next one is requested right away so that a
+ *   sequential reader always has one request in flight.
+ *
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_rread(FAR struct rpmsgfs_mountpt_s *fs,
+                             FAR struct rpmsgfs_ofile_s *hf,
+                             FAR char *buffer, size_t buflen)
+{
+  ssize_t total = 0;
+  ssize_t ret = 0;
+
+  if (hf->rbuf[0] == NULL)
+    {
+      hf->rbuf[0] = fs_heap_malloc(2 * CONFIG_FS_RPMSGFS_READAHEAD);
+      if (hf->rbuf[0] == NULL)
+        {
+          return rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+        }
+
+      hf->rbuf[1] = hf->rbuf[0] + CONFIG_FS_RPMSGFS_READAHEAD;
+    }
+
+  while (buflen > 0)
+    {
+      if (hf->rpos < hf->rlen)
+        {
+          size_t n = MIN(buflen, hf->rlen - hf->rpos);
+
+          memcpy(buffer, hf->rbuf[0] + hf->rpos, n);
+          hf->rpos += n;
+          buffer   += n;
+          buflen   -= n;
+          total    += n;
+          continue;
+        }
+
+      if (hf->rreq != NULL || hf->plen > 0)
+        {
+          ret = rpmsgfs_rwait(fs, hf);
+          if (ret < 0)
+            {
+              break;
+            }
+
+          rpmsgfs_rnext(hf);
+          if (hf->rlen == 0)
+            {
+              break;
+            }
+
+          continue;
+        }
+
+      if (buflen >= CONFIG_FS_RPMSGFS_READAHEAD)
+        {
+          ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+          if (ret > 0)
+            {
+              total += ret;
+            }
+
+          break;
+        }
+
+      ret = rpmsgfs_client_read(fs->handle, hf->fd, hf->rbuf[0],
+                                CONFIG_FS_RPMSGFS_READAHEAD);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      hf->rpos = 0;
+      hf->rlen = ret;
+    }
+
+  if (ret >= 0 && hf->rlen == CONFIG_FS_RPMSGFS_READAHEAD &&
+      hf->rreq == NULL && hf->plen == 0)
+    {
+      rpmsgfs_client_read_start(fs->handle, hf->fd, hf->rbuf[1],
+                                CONFIG_FS_RPMSGFS_READAHEAD, &hf->rreq);
+    }
+
+  return total > 0 ? total : ret;
+}
+#endif
+
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+/****************************************************************************
+ * Name: rpmsgfs_wwait
+ *
+ * Description: Collect the result of the pending write.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_wwait(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf)
+{
+  ssize_t ret;
+
+  if (hf->wreq == NULL)
+    {
+      return OK;
+    }
+
+  ret = rpmsgfs_client_wait(fs->handle, hf->wreq);
+  hf->wreq = NULL;
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_wflush
+ *
+ * Description: Send the write-behind buffer without waiting for the
+ *   result.  At most one write is outstanding per file.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_wflush(FAR struct rpmsgfs_mountpt_s *fs,
+                          FAR struct rpmsgfs_ofile_s *hf)
+{
+  int ret;
+
+  if (hf->wlen == 0)
+    {
+      return OK;
+    }
+
+  ret = rpmsgfs_wwait(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_write_start(fs->handle, hf->fd, hf->wbuf,
+                                       hf->wlen, &hf->wreq);
+    }
+
+  hf->wlen = 0;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_wsync
+ *
+ * Description: Flush the write-behind buffer and wait until the host has
+ *   written everything.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_wsync(FAR struct rpmsgfs_mountpt_s *fs,
+                         FAR struct rpmsgfs_ofile_s *hf)
+{
+  int ret;
+  int ret2;
+
+  ret  = rpmsgfs_wflush(fs, hf);
+  ret2 = rpmsgfs_wwait(fs, hf);
+  return ret < 0 ? ret : ret2;
+}
+
+/****************************************************************************
+ * Name: rpmsgfs_wwrite
+ ****************************************************************************/
+
+static ssize_t rpmsgfs_wwrite(FAR struct rpmsgfs_mountpt_s *fs,
+                              FAR struct rpmsgfs_ofile_s *hf,
+                              FAR const char *buffer, size_t buflen)
+{
+  int ret;
+
+  if (hf->wbuf == NULL && buflen < CONFIG_FS_RPMSGFS_WRITEBEHIND)
+    {
+      hf->wbuf = fs_heap_malloc(CONFIG_FS_RPMSGFS_WRITEBEHIND);
+    }
+
+  if (hf->wbuf == NULL || buflen >= CONFIG_FS_RPMSGFS_WRITEBEHIND)
+    {
+      ret = rpmsgfs_wsync(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      return rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+    }
+
+  if (hf->wlen + buflen > CONFIG_FS_RPMSGFS_WRITEBEHIND)
+    {
+      ret = rpmsgfs_wflush(fs, hf);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  memcpy(hf->wbuf + hf->wlen, buffer, buflen);
+  hf->wlen += buflen;
+  return buflen;
+}
+#else
+#  define rpmsgfs_wsync(fs, hf) OK
+#endif
+
+/****************************************************************************
+ * Name: rpmsgfs_settle
+ *
+ * Description: Bring the host file in line with the caller's view before
+ *   an operation that does not go through the read-ahead and write-behind
+ *   buffers.
+ *
+ ****************************************************************************/
+
+static int rpmsgfs_settle(FAR struct rpmsgfs_mountpt_s *fs,
+                          FAR struct rpmsgfs_ofile_s *hf, off_t pos)
+{
+  int ret;
+
+  ret = rpmsgfs_wsync(fs, hf);
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_rdrop(fs, hf, pos);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: rpmsgfs_open
  ****************************************************************************/
@@ -315,7 +817,7 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Allocate memory for the open file */
 
-  hf = fs_heap_malloc(sizeof *hf);
+  hf = fs_heap_zalloc(sizeof *hf);
   if (hf == NULL)
     {
       ret = -ENOMEM;
@@ -337,6 +839,13 @@ static int rpmsgfs_open(FAR struct file *filep, FAR const char *relpath,
       goto errout_with_buffer;
     }
 
+  /* The file may have been created or truncated */
+
+  if ((oflags & (O_CREAT | O_TRUNC)) != 0)
+    {
+      rpmsgfs_attr_invalidate(fs);
+    }
+
   /* In write/append mode, we need to set the file pointer to the end of the
    * file.
    */
@@ -427,6 +936,7 @@ static int rpmsgfs_close(FAR struct file *filep)
        * reference count and return.
        */
 
+      ret = rpmsgfs_settle(fs, hf, filep->f_pos);
       hf->crefs--;
       goto okout;
     }
@@ -461,6 +971,19 @@ static int rpmsgfs_close(FAR struct file *filep)
         }
     }
 
+  /* Write back what is still buffered, its result is the result of
+   * close().
+   */
+
+  ret = rpmsgfs_wsync(fs, hf);
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  rpmsgfs_rwait(fs, hf);
+  fs_heap_free(hf->rbuf[0]);
+#endif
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  fs_heap_free(hf->wbuf);
+#endif
+
   /* Close the host file */
 
   rpmsgfs_client_close(fs->handle, hf->fd);
@@ -472,7 +995,7 @@ static int rpmsgfs_close(FAR struct file *filep)
 
 okout:
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -507,14 +1030,27 @@ static ssize_t rpmsgfs_read(FAR struct file *filep, FAR char *buffer,
       return ret;
     }
 
+  /* Buffered writes have to reach the host first */
+
+  ret = rpmsgfs_wsync(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
   /* Call the host to perform the read */
 
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  ret = rpmsgfs_rread(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_read(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
     }
 
+errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -559,12 +1095,27 @@ static ssize_t rpmsgfs_write(FAR struct file *filep, const char *buffer,
       goto errout_with_lock;
     }
 
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  /* Move the host position back from the read-ahead data */
+
+  ret = rpmsgfs_rdrop(fs, hf, filep->f_pos);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the write */
 
+#if CONFIG_FS_RPMSGFS_WRITEBEHIND > 0
+  ret = rpmsgfs_wwrite(fs, hf, buffer, buflen);
+#else
   ret = rpmsgfs_client_write(fs->handle, hf->fd, buffer, buflen);
+#endif
   if (ret > 0)
     {
       filep->f_pos += ret;
+      rpmsgfs_attr_invalidate(fs);
     }
 
 errout_with_lock:
@@ -603,6 +1154,36 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
       return ret;
     }
 
+  ret = rpmsgfs_wsync(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+#if CONFIG_FS_RPMSGFS_READAHEAD > 0
+  /* The host is ahead of f_pos by the read-ahead data, so seek relative
+   * to f_pos here and try to stay inside the buffered data.
+   */
+
+  if (whence == SEEK_CUR)
+    {
+      offset += filep->f_pos;
+      whence  = SEEK_SET;
+    }
+
+  if (whence == SEEK_SET && rpmsgfs_rseek(fs, hf, filep->f_pos, offset))
+    {
+      filep->f_pos = offset;
+      ret = offset;
+      goto errout_with_lock;
+    }
+
+  rpmsgfs_rwait(fs, hf);
+  hf->rpos = 0;
+  hf->rlen = 0;
+  hf->plen = 0;
+#endif
+
   /* Call our internal routine to perform the seek */
 
   ret = rpmsgfs_client_lseek(fs->handle, hf->fd, offset, whence);
@@ -611,6 +1192,7 @@ static off_t rpmsgfs_seek(FAR struct file *filep, off_t offset, int whence)
       filep->f_pos = ret;
     }
 
+errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -648,7 +1230,12 @@ static int rpmsgfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   /* Call our internal routine to perform the ioctl */
 
-  ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+  ret = rpmsgfs_settle(fs, hf, filep->f_pos);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ioctl(fs->handle, hf->fd, cmd, arg);
+    }
+
   if (ret == 0 && (cmd == FIONBIO || cmd == FIOCLEX || cmd == FIONCLEX))
     {
       ret = -ENOTTY;
@@ -693,10 +1280,11 @@ static int rpmsgfs_sync(FAR struct file *filep)
       return ret;
     }
 
+  ret = rpmsgfs_wsync(fs, hf);
   rpmsgfs_client_sync(fs->handle, hf->fd);
 
   nxmutex_unlock(&fs->fs_lock);
-  return OK;
+  return ret;
 }
 
 /****************************************************************************
@@ -767,10 +1355,32 @@ static int rpmsgfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
       return ret;
     }
 
+  /* The size has to include buffered writes */
+
+  ret = rpmsgfs_wsync(fs, hf);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  if (rpmsgfs_attr_get(fs, &hf->attr, buf))
+    {
+      goto errout_with_lock;
+    }
+#endif
+
   /* Call the host to perform the read */
 
   ret = rpmsgfs_client_fstat(fs->handle, hf->fd, buf);
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  if (ret >= 0)
+    {
+      rpmsgfs_attr_set(fs, &hf->attr, buf);
+    }
+#endif
 
+errout_with_lock:
   nxmutex_unlock(&fs->fs_lock);
   return ret;
 }
@@ -815,7 +1425,13 @@ static int rpmsgfs_fchstat(FAR const struct file *filep,
 
   /* Call the host to perform the change */
 
-  ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+  ret = rpmsgfs_wsync(fs, hf);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_fchstat(fs->handle, hf->fd, buf, flags);
+    }
+
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -856,7 +1472,13 @@ static int rpmsgfs_truncate(FAR struct file *filep, off_t length)
 
   /* Call the host to perform the truncate */
 
-  ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+  ret = rpmsgfs_settle(fs, hf, filep->f_pos);
+  if (ret >= 0)
+    {
+      ret = rpmsgfs_client_ftruncate(fs->handle, hf->fd, length);
+    }
+
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1005,9 +1627,37 @@ static int rpmsgfs_readdir(FAR struct inode *mountpt,
       return ret;
     }
 
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  /* Refill the batch of entries from the host */
+
+  if (rdir->pos >= rdir->len)
+    {
+      size_t size = sizeof(rdir->entries);
+
+      rdir->pos = 0;
+      ret = rpmsgfs_client_readdirs(fs->handle, rdir->dir,
+                                    rdir->entries, &size);
+      rdir->len = size;
+      if (ret <= 0)
+        {
+          ret = ret < 0 ? ret : -ENOENT;
+          goto errout_with_lock;
+        }
+    }
+
+  entry->d_type = rdir->entries[rdir->pos++];
+  strlcpy(entry->d_name, &rdir->entries[rdir->pos],
+          sizeof(entry->d_name));
+  rdir->pos += strnlen(&rdir->entries[rdir->pos],
+                       rdir->len - rdir->pos) + 1;
+  ret = OK;
+
+errout_with_lock:
+#else
   /* Call the host OS's readdir function */
 
   ret = rpmsgfs_client_readdir(fs->handle, rdir->dir, entry);
+#endif
 
   nxmutex_unlock(&fs->fs_lock);
   return ret;
@@ -1047,6 +1697,10 @@ static int rpmsgfs_rewinddir(FAR struct inode *mountpt,
   /* Call the host and let it do all the work */
 
   rpmsgfs_client_rewinddir(fs->handle, rdir->dir);
+#ifdef CONFIG_FS_RPMSGFS_READDIR_BATCH
+  rdir->pos = 0;
+  rdir->len = 0;
+#endif
 
   nxmutex_unlock(&fs->fs_lock);
   return OK;
@@ -1213,6 +1867,13 @@ static int rpmsgfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return ret;
     }
 
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  for (ret = 0; ret < CONFIG_FS_RPMSGFS_ATTR_NCACHE; ret++)
+    {
+      fs_heap_free(fs->fs_attr[ret].path);
+    }
+#endif
+
   nxmutex_destroy(&fs->fs_lock);
   fs_heap_free(fs);
   return 0;
@@ -1292,6 +1953,7 @@ static int rpmsgfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host fs to perform the unlink */
 
   ret = rpmsgfs_client_unlink(fs->handle, path);
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
@@ -1340,6 +2002,7 @@ static int rpmsgfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the mkdir */
 
   ret = rpmsgfs_client_mkdir(fs->handle, path, mode);
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
@@ -1389,6 +2052,7 @@ int rpmsgfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
   /* Call the host FS to do the mkdir */
 
   ret = rpmsgfs_client_rmdir(fs->handle, path);
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
@@ -1449,6 +2113,7 @@ int rpmsgfs_rename(FAR struct inode *mountpt, FAR const char *oldrelpath,
   /* Call the host FS to do the mkdir */
 
   ret = rpmsgfs_client_rename(fs->handle, oldpath, newpath);
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(oldpath);
@@ -1467,6 +2132,9 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                         FAR struct stat *buf)
 {
   FAR struct rpmsgfs_mountpt_s *fs;
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  FAR struct rpmsgfs_attr_s *attr;
+#endif
   FAR char *path;
   int ret;
 
@@ -1497,7 +2165,23 @@ static int rpmsgfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
 
   /* Call the host FS to do the stat operation */
 
+#if CONFIG_FS_RPMSGFS_ATTR_TIMEOUT > 0
+  attr = rpmsgfs_attr_lookup(fs, path);
+  if (attr != NULL && rpmsgfs_attr_get(fs, attr, buf))
+    {
+      ret = OK;
+    }
+  else
+    {
+      ret = rpmsgfs_client_stat(fs->handle, path, buf);
+      if (ret >= 0)
+        {
+          rpmsgfs_attr_insert(fs, path, buf);
+        }
+    }
+#else
   ret = rpmsgfs_client_stat(fs->handle, path, buf);
+#endif
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
@@ -1546,6 +2230,7 @@ static int rpmsgfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
   /* Call the host FS to do the chstat operation */
 
   ret = rpmsgfs_client_chstat(fs->handle, path, buf, flags);
+  rpmsgfs_attr_invalidate(fs);
 
   nxmutex_unlock(&fs->fs_lock);
   lib_put_pathbuffer(path);
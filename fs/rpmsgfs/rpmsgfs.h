@@ -61,6 +61,12 @@
 #define RPMSGFS_STAT            20
 #define RPMSGFS_FCHSTAT         21
 #define RPMSGFS_CHSTAT          22
+#define RPMSGFS_READDIRS        23
+#define RPMSGFS_INVALIDATE      24
+
+/* Room for the entries of one batched readdir on the client side */
+
+#define RPMSGFS_READDIRS_SIZE   512
 
 /****************************************************************************
  * Public Types
@@ -171,6 +177,14 @@ begin_packed_struct struct rpmsgfs_readdir_s
   char                    name[0];
 } end_packed_struct;
 
+begin_packed_struct struct rpmsgfs_readdirs_s
+{
+  struct rpmsgfs_header_s header;
+  int32_t                 fd;
+  uint32_t                size;     /* Space for entries on the client */
+  char                    buf[0];   /* d_type, d_name and '\0' per entry */
+} end_packed_struct;
+
 #define rpmsgfs_rewinddir_s rpmsgfs_close_s
 #define rpmsgfs_closedir_s rpmsgfs_close_s
 
@@ -216,6 +230,7 @@ begin_packed_struct struct rpmsgfs_fchstat_s
 } end_packed_struct;
 
 #define rpmsgfs_chstat_s rpmsgfs_fchstat_s
+#define rpmsgfs_invalidate_s rpmsgfs_header_s
 
 /****************************************************************************
  * Internal function prototypes
@@ -228,6 +243,13 @@ ssize_t   rpmsgfs_client_read(FAR void *handle, int fd,
                               FAR void *buf, size_t count);
 ssize_t   rpmsgfs_client_write(FAR void *handle, int fd,
                                FAR const void *buf, size_t count);
+int       rpmsgfs_client_read_start(FAR void *handle, int fd,
+                                    FAR void *buf, size_t count,
+                                    FAR void **req);
+int       rpmsgfs_client_write_start(FAR void *handle, int fd,
+                                     FAR const void *buf, size_t count,
+                                     FAR void **req);
+ssize_t   rpmsgfs_client_wait(FAR void *handle, FAR void *req);
 off_t     rpmsgfs_client_lseek(FAR void *handle, int fd,
                                off_t offset, int whence);
 int       rpmsgfs_client_ioctl(FAR void *handle, int fd,
@@ -242,7 +264,10 @@ int       rpmsgfs_client_ftruncate(FAR void *handle, int fd, off_t length);
 FAR void *rpmsgfs_client_opendir(FAR void *handle, FAR const char *name);
 int       rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
                                  FAR struct dirent *entry);
+int       rpmsgfs_client_readdirs(FAR void *handle, FAR void *dirp,
+                                  FAR void *buf, FAR size_t *size);
 void      rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp);
+uint32_t  rpmsgfs_client_generation(FAR void *handle);
 int       rpmsgfs_client_bind(FAR void **handle, FAR const char *cpuname);
 int       rpmsgfs_client_unbind(FAR void *handle);
 int       rpmsgfs_client_closedir(FAR void *handle, FAR void *dirp);
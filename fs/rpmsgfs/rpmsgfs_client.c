@@ -49,6 +49,7 @@ struct rpmsgfs_s
   struct rpmsg_endpoint ept;
   char                  cpuname[RPMSG_NAME_SIZE];
   sem_t                 wait;
+  uint32_t              gen;       /* Bumped by server invalidations */
 };
 
 struct rpmsgfs_cookie_s
@@ -58,6 +59,15 @@ struct rpmsgfs_cookie_s
   FAR void *data;
 };
 
+/* An asynchronous read or write, completed by rpmsgfs_client_wait() */
+
+struct rpmsgfs_request_s
+{
+  struct rpmsgfs_cookie_s cookie;
+  struct iovec            read;    /* Destination of a read */
+  ssize_t                 count;   /* Size of a write, -1 for a read */
+};
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -74,6 +84,12 @@ static int rpmsgfs_ioctl_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_invalidate_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv);
 static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv);
@@ -124,6 +140,8 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_default_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_default_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
+  [RPMSGFS_INVALIDATE] = rpmsgfs_invalidate_handler,
 };
 
 /****************************************************************************
@@ -216,6 +234,44 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   return 0;
 }
 
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_header_s *header = data;
+  FAR struct rpmsgfs_cookie_s *cookie =
+      (FAR struct rpmsgfs_cookie_s *)(uintptr_t)header->cookie;
+  FAR struct rpmsgfs_readdirs_s *rsp = data;
+  FAR struct iovec *entries = cookie->data;
+
+  cookie->result = header->result;
+  if (cookie->result > 0)
+    {
+      entries->iov_len = MIN(entries->iov_len, len - sizeof(*rsp));
+      memcpy(entries->iov_base, rsp->buf, entries->iov_len);
+    }
+  else
+    {
+      entries->iov_len = 0;
+    }
+
+  rpmsg_post(ept, &cookie->sem);
+
+  return 0;
+}
+
+static int rpmsgfs_invalidate_handler(FAR struct rpmsg_endpoint *ept,
+                                      FAR void *data, size_t len,
+                                      uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_s *ept_priv = ept->priv;
+
+  /* Something changed on the server, drop all cached attributes */
+
+  ept_priv->gen++;
+  return 0;
+}
+
 static int rpmsgfs_statfs_handler(FAR struct rpmsg_endpoint *ept,
                                   FAR void *data, size_t len,
                                   uint32_t src, FAR void *priv)
@@ -407,6 +463,73 @@ fail:
   return ret;
 }
 
+static int rpmsgfs_read_send(FAR struct rpmsgfs_s *priv, int fd,
+                             size_t count,
+                             FAR struct rpmsgfs_cookie_s *cookie)
+{
+  struct rpmsgfs_read_s msg;
+
+  msg.header.command = RPMSGFS_READ;
+  msg.header.result  = -ENXIO;
+  msg.header.cookie  = (uintptr_t)cookie;
+  msg.fd             = fd;
+  msg.count          = count;
+
+  return rpmsg_send(&priv->ept, &msg, sizeof(msg));
+}
+
+static int rpmsgfs_write_send(FAR struct rpmsgfs_s *priv, int fd,
+                              FAR const void *buf, size_t count,
+                              FAR struct rpmsgfs_cookie_s *cookie)
+{
+  size_t written = 0;
+  int ret;
+
+  /* Only the last chunk carries the cookie, the server answers that one
+   * alone.
+   */
+
+  while (written < count)
+    {
+      FAR struct rpmsgfs_write_s *msg;
+      uint32_t space;
+
+      msg = rpmsgfs_get_tx_payload_buffer(priv, &space);
+      if (!msg)
+        {
+          return -ENOMEM;
+        }
+
+      space -= sizeof(*msg);
+      if (space >= count - written)
+        {
+          space = count - written;
+          msg->header.cookie = (uintptr_t)cookie;
+        }
+      else
+        {
+          msg->header.cookie = 0;
+        }
+
+      msg->header.command = RPMSGFS_WRITE;
+      msg->header.result  = -ENXIO;
+      msg->fd             = fd;
+      msg->count          = space;
+      memcpy(msg->buf, buf + written, space);
+
+      ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg) + space);
+      if (ret < 0)
+        {
+          rpmsg_release_tx_buffer(&priv->ept, msg);
+          return ret;
+        }
+
+      written += space;
+    }
+
+  return 0;
+}
+
 static ssize_t rpmsgfs_ioctl_arglen(int cmd)
 {
   switch (cmd)
@@ -484,7 +607,6 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
     };
 
   struct rpmsgfs_cookie_s cookie;
-  struct rpmsgfs_read_s msg;
   int ret = 0;
 
   if (!buf || count <= 0)
@@ -497,13 +619,7 @@ ssize_t rpmsgfs_client_read(FAR void *handle, int fd,
   nxsem_init(&cookie.sem, 0, 0);
   cookie.data = &read;
 
-  msg.header.command = RPMSGFS_READ;
-  msg.header.result  = -ENXIO;
-  msg.header.cookie  = (uintptr_t)&cookie;
-  msg.fd             = fd;
-  msg.count          = count;
-
-  ret = rpmsg_send(&priv->ept, &msg, sizeof(msg));
+  ret = rpmsgfs_read_send(priv, fd, count, &cookie);
   if (ret < 0)
     {
       goto out;
@@ -527,7 +643,6 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
 {
   FAR struct rpmsgfs_s *priv = handle;
   struct rpmsgfs_cookie_s cookie;
-  size_t written = 0;
   int ret = 0;
 
   if (!buf || count <= 0)
@@ -538,43 +653,10 @@ ssize_t rpmsgfs_client_write(FAR void *handle, int fd,
   memset(&cookie, 0, sizeof(cookie));
   nxsem_init(&cookie.sem, 0, 0);
 
-  while (written < count)
+  ret = rpmsgfs_write_send(priv, fd, buf, count, &cookie);
+  if (ret < 0)
     {
-      FAR struct rpmsgfs_write_s *msg;
-      uint32_t space;
-
-      msg = rpmsgfs_get_tx_payload_buffer(priv, &space);
-      if (!msg)
-        {
-          ret = -ENOMEM;
-          goto out;
-        }
-
-      space -= sizeof(*msg);
-      if (space >= count - written)
-        {
-          space = count - written;
-          msg->header.cookie = (uintptr_t)&cookie;
-        }
-      else
-        {
-          msg->header.cookie = 0;
-        }
-
-      msg->header.command = RPMSGFS_WRITE;
-      msg->header.result  = -ENXIO;
-      msg->fd             = fd;
-      msg->count          = space;
-      memcpy(msg->buf, buf + written, space);
-
-      ret = rpmsg_send_nocopy(&priv->ept, msg, sizeof(*msg) + space);
-      if (ret < 0)
-        {
-          rpmsg_release_tx_buffer(&priv->ept, msg);
-          goto out;
-        }
-
-      written += space;
+      goto out;
     }
 
   ret = rpmsg_wait(&priv->ept, &cookie.sem);
@@ -590,6 +672,98 @@ out:
   return ret < 0 ? ret : count;
 }
 
+int rpmsgfs_client_read_start(FAR void *handle, int fd,
+                              FAR void *buf, size_t count,
+                              FAR void **req)
+{
+  FAR struct rpmsgfs_request_s *request;
+  int ret;
+
+  request = fs_heap_zalloc(sizeof(*request));
+  if (request == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&request->cookie.sem, 0, 0);
+  request->cookie.data   = &request->read;
+  request->read.iov_base = buf;
+  request->count         = -1;
+
+  ret = rpmsgfs_read_send(handle, fd, count, &request->cookie);
+  if (ret < 0)
+    {
+      nxsem_destroy(&request->cookie.sem);
+      fs_heap_free(request);
+      return ret;
+    }
+
+  *req = request;
+  return 0;
+}
+
+int rpmsgfs_client_write_start(FAR void *handle, int fd,
+                               FAR const void *buf, size_t count,
+                               FAR void **req)
+{
+  FAR struct rpmsgfs_request_s *request;
+  int ret;
+
+  request = fs_heap_zalloc(sizeof(*request));
+  if (request == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  nxsem_init(&request->cookie.sem, 0, 0);
+  request->count = count;
+
+  /* The payload is copied into the rpmsg buffers here, so buf may be
+   * reused as soon as this returns.
+   */
+
+  ret = rpmsgfs_write_send(handle, fd, buf, count, &request->cookie);
+  if (ret < 0)
+    {
+      /* Only the last chunk carries the cookie and it was not sent, so
+       * no answer can arrive for this request.
+       */
+
+      nxsem_destroy(&request->cookie.sem);
+      fs_heap_free(request);
+      return ret;
+    }
+
+  *req = request;
+  return 0;
+}
+
+ssize_t rpmsgfs_client_wait(FAR void *handle, FAR void *req)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+  FAR struct rpmsgfs_request_s *request = req;
+  ssize_t ret;
+
+  ret = rpmsg_wait(&priv->ept, &request->cookie.sem);
+  if (ret >= 0)
+    {
+      ret = request->cookie.result;
+    }
+
+  if (request->count < 0)
+    {
+      ret = request->read.iov_len > 0 ? request->read.iov_len : ret;
+    }
+  else if (ret >= 0)
+    {
+      ret = request->count;
+    }
+
+  nxsem_destroy(&request->cookie.sem);
+  fs_heap_free(request);
+  return ret;
+}
+
 off_t rpmsgfs_client_lseek(FAR void *handle, int fd,
                            off_t offset, int whence)
 {
@@ -738,6 +912,29 @@ int rpmsgfs_client_readdir(FAR void *handle, FAR void *dirp,
           (struct rpmsgfs_header_s *)&msg, sizeof(msg), entry);
 }
 
+int rpmsgfs_client_readdirs(FAR void *handle, FAR void *dirp,
+                            FAR void *buf, FAR size_t *size)
+{
+  struct iovec entries =
+    {
+      .iov_base = buf,
+      .iov_len  = *size,
+    };
+
+  struct rpmsgfs_readdirs_s msg =
+  {
+    .fd   = (uintptr_t)dirp,
+    .size = *size,
+  };
+
+  int ret;
+
+  ret = rpmsgfs_send_recv(handle, RPMSGFS_READDIRS, true,
+          (struct rpmsgfs_header_s *)&msg, sizeof(msg), &entries);
+  *size = ret > 0 ? entries.iov_len : 0;
+  return ret;
+}
+
 void rpmsgfs_client_rewinddir(FAR void *handle, FAR void *dirp)
 {
   struct rpmsgfs_rewinddir_s msg =
@@ -784,6 +981,13 @@ int rpmsgfs_client_bind(FAR void **handle, FAR const char *cpuname)
   return 0;
 }
 
+uint32_t rpmsgfs_client_generation(FAR void *handle)
+{
+  FAR struct rpmsgfs_s *priv = handle;
+
+  return priv->gen;
+}
+
 int rpmsgfs_client_unbind(FAR void *handle)
 {
   struct rpmsgfs_s *priv = handle;
@@ -35,6 +35,7 @@
 #include <errno.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
 #include <nuttx/mutex.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/rpmsg/rpmsg.h>
@@ -54,6 +55,9 @@ struct rpmsgfs_server_s
   int                   file_rows;
   int                   dir_nums;
   mutex_t               lock;
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+  struct list_node      node;      /* Entry of g_rpmsgfs_servers */
+#endif
 };
 
 /****************************************************************************
@@ -96,6 +100,9 @@ static int rpmsgfs_opendir_handler(FAR struct rpmsg_endpoint *ept,
 static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
                                    FAR void *data, size_t len,
                                    uint32_t src, FAR void *priv);
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv);
 static int rpmsgfs_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv);
@@ -165,8 +172,15 @@ static const rpmsg_ept_cb g_rpmsgfs_handler[] =
   [RPMSGFS_STAT]      = rpmsgfs_stat_handler,
   [RPMSGFS_FCHSTAT]   = rpmsgfs_fchstat_handler,
   [RPMSGFS_CHSTAT]    = rpmsgfs_chstat_handler,
+  [RPMSGFS_READDIRS]  = rpmsgfs_readdirs_handler,
 };
 
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+static struct list_node g_rpmsgfs_servers =
+  LIST_INITIAL_VALUE(g_rpmsgfs_servers);
+static mutex_t g_rpmsgfs_servers_lock = NXMUTEX_INITIALIZER;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -631,6 +645,67 @@ static int rpmsgfs_readdir_handler(FAR struct rpmsg_endpoint *ept,
   return rpmsg_send(ept, msg, len);
 }
 
+static int rpmsgfs_readdirs_handler(FAR struct rpmsg_endpoint *ept,
+                                    FAR void *data, size_t len,
+                                    uint32_t src, FAR void *priv)
+{
+  FAR struct rpmsgfs_readdirs_s *msg = data;
+  FAR struct rpmsgfs_readdirs_s *rsp;
+  FAR struct dirent *entry;
+  int ret = -ENOENT;
+  size_t used = 0;
+  uint32_t space;
+  FAR void *dir;
+
+  rsp = rpmsg_get_tx_payload_buffer(ept, &space, true);
+  if (rsp == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *rsp  = *msg;
+  space = MIN(space - sizeof(*rsp), msg->size);
+
+  dir = rpmsgfs_get_dir(priv, msg->fd);
+  if (dir)
+    {
+      /* Only read an entry if the longest possible one still fits, so no
+       * entry has to be pushed back into the directory stream.
+       */
+
+      ret = 0;
+      while (used + NAME_MAX + 2 <= space)
+        {
+          size_t namelen;
+
+          entry = readdir(dir);
+          if (entry == NULL)
+            {
+              break;
+            }
+
+          namelen = strlen(entry->d_name) + 1;
+          rsp->buf[used++] = entry->d_type;
+          memcpy(&rsp->buf[used], entry->d_name, namelen);
+          used += namelen;
+          ret++;
+        }
+
+      if (ret == 0 && space < NAME_MAX + 2)
+        {
+          ret = -ENOBUFS;
+        }
+    }
+
+  rsp->header.result = ret;
+  if (rpmsg_send_nocopy(ept, rsp, sizeof(*rsp) + used) < 0)
+    {
+      rpmsg_release_tx_buffer(ept, rsp);
+    }
+
+  return 0;
+}
+
 static int rpmsgfs_rewinddir_handler(FAR struct rpmsg_endpoint *ept,
                                      FAR void *data, size_t len,
                                      uint32_t src, FAR void *priv)
@@ -882,6 +957,80 @@ out:
   return rpmsg_send(ept, msg, sizeof(*msg));
 }
 
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+static bool rpmsgfs_modified(FAR void *data)
+{
+  FAR struct rpmsgfs_header_s *header = data;
+
+  if (header->result < 0)
+    {
+      return false;
+    }
+
+  switch (header->command)
+    {
+      case RPMSGFS_OPEN:
+        return (((FAR struct rpmsgfs_open_s *)data)->flags &
+                (O_CREAT | O_TRUNC)) != 0;
+
+      case RPMSGFS_WRITE:
+
+        /* Only the last chunk of a write carries a cookie */
+
+        return header->cookie != 0;
+
+      case RPMSGFS_FTRUNCATE:
+      case RPMSGFS_UNLINK:
+      case RPMSGFS_MKDIR:
+      case RPMSGFS_RMDIR:
+      case RPMSGFS_RENAME:
+      case RPMSGFS_FCHSTAT:
+      case RPMSGFS_CHSTAT:
+        return true;
+
+      default:
+        return false;
+    }
+}
+
+static void rpmsgfs_invalidate(FAR struct rpmsgfs_server_s *priv)
+{
+  FAR struct rpmsgfs_server_s *server;
+
+  nxmutex_lock(&g_rpmsgfs_servers_lock);
+  list_for_every_entry(&g_rpmsgfs_servers, server,
+                       struct rpmsgfs_server_s, node)
+    {
+      FAR struct rpmsgfs_invalidate_s *msg;
+      uint32_t space;
+
+      if (server == priv)
+        {
+          continue;
+        }
+
+      /* Best effort: never block a request on a notification, clients
+       * still expire their caches by time.
+       */
+
+      msg = rpmsg_get_tx_payload_buffer(&server->ept, &space, false);
+      if (msg == NULL)
+        {
+          continue;
+        }
+
+      memset(msg, 0, sizeof(*msg));
+      msg->command = RPMSGFS_INVALIDATE;
+      if (rpmsg_send_nocopy(&server->ept, msg, sizeof(*msg)) < 0)
+        {
+          rpmsg_release_tx_buffer(&server->ept, msg);
+        }
+    }
+
+  nxmutex_unlock(&g_rpmsgfs_servers_lock);
+}
+#endif
+
 static bool rpmsgfs_ns_match(FAR struct rpmsg_device *rdev,
                              FAR void *priv_, FAR const char *name,
                              uint32_t dest)
@@ -895,6 +1044,12 @@ static void rpmsgfs_ept_release(FAR struct rpmsg_endpoint *ept)
   int i;
   int j;
 
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+  nxmutex_lock(&g_rpmsgfs_servers_lock);
+  list_delete(&priv->node);
+  nxmutex_unlock(&g_rpmsgfs_servers_lock);
+#endif
+
   for (i = 0; i < priv->file_rows; i++)
     {
       for (j = 0; j < CONFIG_NFILE_DESCRIPTORS_PER_BLOCK; j++)
@@ -940,11 +1095,23 @@ static void rpmsgfs_ns_bind(FAR struct rpmsg_device *rdev,
   priv->ept.release_cb = rpmsgfs_ept_release;
   nxmutex_init(&priv->lock);
 
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+  nxmutex_lock(&g_rpmsgfs_servers_lock);
+  list_add_tail(&g_rpmsgfs_servers, &priv->node);
+  nxmutex_unlock(&g_rpmsgfs_servers_lock);
+#endif
+
   ret = rpmsg_create_ept(&priv->ept, rdev, name,
                          RPMSG_ADDR_ANY, dest,
                          rpmsgfs_ept_cb, rpmsg_destroy_ept);
   if (ret)
     {
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+      nxmutex_lock(&g_rpmsgfs_servers_lock);
+      list_delete(&priv->node);
+      nxmutex_unlock(&g_rpmsgfs_servers_lock);
+#endif
+
       nxmutex_destroy(&priv->lock);
       fs_heap_free(priv);
     }
@@ -969,6 +1136,12 @@ static int rpmsgfs_ept_cb(FAR struct rpmsg_endpoint *ept,
       ferr("ERROR: handle failed, ept=%p cmd=%" PRIu32 " ret=%d\n",
            ept, command, ret);
     }
+#ifdef CONFIG_FS_RPMSGFS_SERVER_INVALIDATE
+  else if (rpmsgfs_modified(data))
+    {
+      rpmsgfs_invalidate(priv);
+    }
+#endif
 
   return ret;
 }
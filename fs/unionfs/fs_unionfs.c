@@ -42,6 +42,7 @@
 #include <fixedmath.h>
 #include <nuttx/debug.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/ioctl.h>
@@ -52,6 +53,39 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_UNIONFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_NCACHE
+#  define CONFIG_FS_UNIONFS_LOOKUP_NCACHE 0
+#endif
+
+#ifndef CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT
+#  define CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT 0
+#endif
+
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+/* A whiteout on file system 1 is an empty file with this prefix on the
+ * name of the file system 2 entry that it hides.
+ */
+
+#  define UNIONFS_WHITEOUT          ".wh."
+#  define UNIONFS_WHITEOUT_LEN      4
+
+/* Size of the buffer used to copy files up to file system 1 */
+
+#  define UNIONFS_COPYUP_BUFSIZE    512
+#else
+#  define unionfs_hidden(ui,p)      false
+#  define unionfs_iswhiteout(n)     false
+#  define unionfs_whitedout(ui,p)   false
+#endif
+
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE <= 0
+#  define unionfs_invalidate(ui)
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -74,6 +108,21 @@ struct unionfs_mountpt_s
   FAR char *um_prefix;               /* Path prefix to filesystem */
 };
 
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+/* This structure records which file system holds one path */
+
+struct unionfs_lookup_s
+{
+  FAR char *ul_path;                 /* Union relative path */
+  uint32_t ul_hash;                  /* Hash of ul_path */
+  uint32_t ul_gen;                   /* ui_gen when the entry was recorded */
+#if CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT > 0
+  clock_t ul_stamp;                  /* Time when the entry was recorded */
+#endif
+  int ul_result;                     /* File system index or -ENOENT */
+};
+#endif
+
 /* This structure describes the union file system */
 
 struct unionfs_inode_s
@@ -82,8 +131,21 @@ struct unionfs_inode_s
   mutex_t ui_lock;                   /* Enforces mutually exclusive access */
   int16_t ui_nopen;                  /* Number of open references */
   bool ui_unmounted;                 /* File system has been unmounted */
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  mutex_t ui_cachelock;              /* Protects the lookup cache */
+  uint32_t ui_gen;                   /* Bumped when the union is modified */
+  struct unionfs_lookup_s ui_cache[CONFIG_FS_UNIONFS_LOOKUP_NCACHE];
+#endif
 };
 
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+/* Called by unionfs_scandir() for each entry of a directory */
+
+typedef CODE int (*unionfs_scan_t)(FAR struct unionfs_inode_s *ui,
+                                   FAR const char *relpath,
+                                   FAR const char *name);
+#endif
+
 /* This structure describes one opened file */
 
 struct unionfs_file_s
@@ -140,6 +202,47 @@ static int     unionfs_trystatfile(FAR struct inode *inode,
                                    FAR const char *prefix);
 static FAR char *unionfs_relpath(FAR const char *path,
                                  FAR const char *name);
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+static uint32_t unionfs_hash(FAR const char *relpath);
+static int     unionfs_cache_get(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath,
+                                 FAR uint32_t *gen);
+static void    unionfs_cache_put(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath, uint32_t gen,
+                                 int result);
+static void    unionfs_invalidate(FAR struct unionfs_inode_s *ui);
+#endif
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+static bool    unionfs_iswhiteout(FAR const char *name);
+static bool    unionfs_haswhiteout(FAR struct unionfs_inode_s *ui,
+                                   FAR const char *relpath, size_t len);
+static bool    unionfs_whitedout(FAR struct unionfs_inode_s *ui,
+                                 FAR const char *relpath);
+static bool    unionfs_hidden(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath);
+static int     unionfs_whiteout(FAR struct unionfs_inode_s *ui,
+                                FAR const char *relpath);
+static int     unionfs_copyup_parents(FAR struct unionfs_inode_s *ui,
+                                      FAR const char *relpath);
+static int     unionfs_copyup(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath,
+                              FAR const struct stat *buf, bool data);
+static int     unionfs_scandir(FAR struct unionfs_inode_s *ui, int ndx,
+                               FAR const char *relpath,
+                               unionfs_scan_t handler);
+static int     unionfs_scan_upper(FAR struct unionfs_inode_s *ui,
+                                  FAR const char *relpath,
+                                  FAR const char *name);
+static int     unionfs_scan_lower(FAR struct unionfs_inode_s *ui,
+                                  FAR const char *relpath,
+                                  FAR const char *name);
+static int     unionfs_scan_purge(FAR struct unionfs_inode_s *ui,
+                                  FAR const char *relpath,
+                                  FAR const char *name);
+#endif
+static int     unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath,
+                              FAR struct stat *buf);
 
 static int     unionfs_unbind_child(FAR struct unionfs_mountpt_s *um);
 static void    unionfs_destroy(FAR struct unionfs_inode_s *ui);
@@ -761,6 +864,730 @@ static FAR char *unionfs_relpath(FAR const char *path, FAR const char *name)
     }
 }
 
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+/****************************************************************************
+ * Name: unionfs_hash
+ ****************************************************************************/
+
+static uint32_t unionfs_hash(FAR const char *relpath)
+{
+  uint32_t hash = 5381;
+
+  while (*relpath != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*relpath++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_get
+ *
+ * Description:
+ *   Look up a path in the lookup cache.  The current cache generation is
+ *   returned in gen; it must be passed back to unionfs_cache_put() so that
+ *   the result of a lookup that raced with a modification is not recorded.
+ *   Entries older than CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT are ignored, so
+ *   changes made directly on the contained file systems are seen after
+ *   that time.
+ *
+ * Returned Value:
+ *   The index of the file system holding the path, -ENOENT if the path is
+ *   known not to exist, or -EAGAIN if the path is not cached.
+ *
+ ****************************************************************************/
+
+static int unionfs_cache_get(FAR struct unionfs_inode_s *ui,
+                             FAR const char *relpath, FAR uint32_t *gen)
+{
+  FAR struct unionfs_lookup_s *ul;
+  uint32_t hash = unionfs_hash(relpath);
+  int ret = -EAGAIN;
+
+  nxmutex_lock(&ui->ui_cachelock);
+
+  ul = &ui->ui_cache[hash % CONFIG_FS_UNIONFS_LOOKUP_NCACHE];
+  if (ul->ul_gen == ui->ui_gen && ul->ul_hash == hash &&
+#if CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT > 0
+      clock_systime_ticks() - ul->ul_stamp <
+      MSEC2TICK(CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT) &&
+#endif
+      strcmp(ul->ul_path, relpath) == 0)
+    {
+      ret = ul->ul_result;
+    }
+
+  *gen = ui->ui_gen;
+  nxmutex_unlock(&ui->ui_cachelock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: unionfs_cache_put
+ *
+ * Description:
+ *   Record the result of a lookup.  Only positive results and -ENOENT are
+ *   cached.  The cache is direct mapped, so the entry replaces whatever
+ *   other path hashed to the same slot.
+ *
+ ****************************************************************************/
+
+static void unionfs_cache_put(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath, uint32_t gen,
+                              int result)
+{
+  FAR struct unionfs_lookup_s *ul;
+  FAR char *path;
+  uint32_t hash;
+
+  if (result < 0 && result != -ENOENT)
+    {
+      return;
+    }
+
+  path = fs_heap_strdup(relpath);
+  if (path == NULL)
+    {
+      return;
+    }
+
+  hash = unionfs_hash(relpath);
+
+  nxmutex_lock(&ui->ui_cachelock);
+
+  if (gen == ui->ui_gen)
+    {
+      FAR char *tmp;
+
+      ul             = &ui->ui_cache[hash % CONFIG_FS_UNIONFS_LOOKUP_NCACHE];
+      tmp            = ul->ul_path;
+      ul->ul_path    = path;
+      ul->ul_hash    = hash;
+      ul->ul_gen     = gen;
+#if CONFIG_FS_UNIONFS_LOOKUP_TIMEOUT > 0
+      ul->ul_stamp   = clock_systime_ticks();
+#endif
+      ul->ul_result  = result;
+      path           = tmp;
+    }
+
+  nxmutex_unlock(&ui->ui_cachelock);
+
+  if (path != NULL)
+    {
+      fs_heap_free(path);
+    }
+}
+
+/****************************************************************************
+ * Name: unionfs_invalidate
+ *
+ * Description:
+ *   Discard all cached lookups.  This must be called after any operation
+ *   that may have created, removed or moved a path on either file system.
+ *
+ ****************************************************************************/
+
+static void unionfs_invalidate(FAR struct unionfs_inode_s *ui)
+{
+  int i;
+
+  nxmutex_lock(&ui->ui_cachelock);
+
+  if (++ui->ui_gen == 0)
+    {
+      /* Generation zero is never valid.  On wrap-around, make sure that
+       * no old entry can match the new generation.
+       */
+
+      for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_NCACHE; i++)
+        {
+          ui->ui_cache[i].ul_gen = 0;
+        }
+
+      ui->ui_gen = 1;
+    }
+
+  nxmutex_unlock(&ui->ui_cachelock);
+}
+#endif
+
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+/****************************************************************************
+ * Name: unionfs_iswhiteout
+ ****************************************************************************/
+
+static bool unionfs_iswhiteout(FAR const char *name)
+{
+  return strncmp(name, UNIONFS_WHITEOUT, UNIONFS_WHITEOUT_LEN) == 0;
+}
+
+/****************************************************************************
+ * Name: unionfs_haswhiteout
+ *
+ * Description:
+ *   Check if file system 1 holds a whiteout for the first len characters
+ *   of relpath.
+ *
+ ****************************************************************************/
+
+static bool unionfs_haswhiteout(FAR struct unionfs_inode_s *ui,
+                                FAR const char *relpath, size_t len)
+{
+  FAR struct unionfs_mountpt_s *um = &ui->ui_fs[0];
+  FAR char *wpath;
+  struct stat buf;
+  size_t dirlen;
+  int ret;
+
+  /* Insert the whiteout prefix in front of the last path segment */
+
+  for (dirlen = len; dirlen > 0 && relpath[dirlen - 1] != '/'; dirlen--);
+
+  wpath = fs_heap_malloc(len + UNIONFS_WHITEOUT_LEN + 1);
+  if (wpath == NULL)
+    {
+      return false;
+    }
+
+  memcpy(wpath, relpath, dirlen);
+  memcpy(&wpath[dirlen], UNIONFS_WHITEOUT, UNIONFS_WHITEOUT_LEN);
+  memcpy(&wpath[dirlen + UNIONFS_WHITEOUT_LEN], &relpath[dirlen],
+         len - dirlen);
+  wpath[len + UNIONFS_WHITEOUT_LEN] = '\0';
+
+  ret = unionfs_trystat(um->um_node, wpath, um->um_prefix, &buf);
+  fs_heap_free(wpath);
+  return ret >= 0;
+}
+
+/****************************************************************************
+ * Name: unionfs_whitedout
+ *
+ * Description:
+ *   Check if relpath itself has a whiteout on file system 1.
+ *
+ ****************************************************************************/
+
+static bool unionfs_whitedout(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath)
+{
+  return unionfs_haswhiteout(ui, relpath, strlen(relpath));
+}
+
+/****************************************************************************
+ * Name: unionfs_hidden
+ *
+ * Description:
+ *   Check if whatever is at relpath on file system 2 is hidden by a
+ *   whiteout of relpath or of one of its parent directories.
+ *
+ ****************************************************************************/
+
+static bool unionfs_hidden(FAR struct unionfs_inode_s *ui,
+                           FAR const char *relpath)
+{
+  FAR const char *end = relpath;
+  size_t len;
+
+  for (; ; )
+    {
+      end = strchr(end, '/');
+      len = end != NULL ? end - relpath : strlen(relpath);
+
+      /* Skip empty segments */
+
+      if (len > 0 && relpath[len - 1] != '/' &&
+          unionfs_haswhiteout(ui, relpath, len))
+        {
+          return true;
+        }
+
+      if (end == NULL)
+        {
+          return false;
+        }
+
+      end++;
+    }
+}
+
+/****************************************************************************
+ * Name: unionfs_whiteout
+ *
+ * Description:
+ *   Create a whiteout on file system 1 that hides relpath on file system 2.
+ *
+ ****************************************************************************/
+
+static int unionfs_whiteout(FAR struct unionfs_inode_s *ui,
+                            FAR const char *relpath)
+{
+  FAR struct unionfs_mountpt_s *um = &ui->ui_fs[0];
+  FAR const char *name;
+  FAR char *wpath;
+  struct file file;
+  int ret;
+
+  ret = unionfs_copyup_parents(ui, relpath);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  name = strrchr(relpath, '/');
+  name = name != NULL ? name + 1 : relpath;
+
+  ret = fs_heap_asprintf(&wpath, "%.*s%s%s", (int)(name - relpath), relpath,
+                         UNIONFS_WHITEOUT, name);
+  if (ret < 0)
+    {
+      return -ENOMEM;
+    }
+
+  memset(&file, 0, sizeof(struct file));
+  file.f_oflags = O_WRONLY | O_CREAT | O_TRUNC;
+  file.f_inode  = um->um_node;
+
+  ret = unionfs_tryopen(&file, wpath, um->um_prefix, file.f_oflags, 0666);
+  if (ret >= 0 && um->um_node->u.i_mops->close != NULL)
+    {
+      um->um_node->u.i_mops->close(&file);
+    }
+
+  fs_heap_free(wpath);
+  unionfs_invalidate(ui);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: unionfs_copyup_parents
+ *
+ * Description:
+ *   Make sure that all of the parent directories of relpath exist on file
+ *   system 1, creating them with the modes of the file system 2 directories
+ *   where needed.
+ *
+ ****************************************************************************/
+
+static int unionfs_copyup_parents(FAR struct unionfs_inode_s *ui,
+                                  FAR const char *relpath)
+{
+  FAR struct unionfs_mountpt_s *upper = &ui->ui_fs[0];
+  FAR struct unionfs_mountpt_s *lower = &ui->ui_fs[1];
+  FAR char *path;
+  FAR char *sep;
+  struct stat buf;
+  int ret = OK;
+
+  path = fs_heap_strdup(relpath);
+  if (path == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (sep = strchr(path, '/'); sep != NULL; sep = strchr(sep + 1, '/'))
+    {
+      if (sep == path || *(sep - 1) == '/')
+        {
+          continue;
+        }
+
+      *sep = '\0';
+
+      ret = unionfs_trystat(upper->um_node, path, upper->um_prefix, &buf);
+      if (ret >= 0)
+        {
+          ret = S_ISDIR(buf.st_mode) ? OK : -ENOTDIR;
+        }
+      else
+        {
+          mode_t mode = 0777;
+
+          if (unionfs_trystat(lower->um_node, path, lower->um_prefix,
+                              &buf) >= 0)
+            {
+              mode = buf.st_mode & 0777;
+            }
+
+          ret = unionfs_trymkdir(upper->um_node, path, upper->um_prefix,
+                                 mode);
+        }
+
+      *sep = '/';
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  fs_heap_free(path);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: unionfs_copyup
+ *
+ * Description:
+ *   Copy a file or directory from file system 2 to file system 1 so that it
+ *   can be modified.  Directories are created empty.  The content of a
+ *   regular file is only copied if data is true.
+ *
+ * Input Parameters:
+ *   ui      - The union file system
+ *   relpath - The path to copy up
+ *   buf     - The status of relpath on file system 2
+ *   data    - False if the file will be truncated anyway
+ *
+ ****************************************************************************/
+
+static int unionfs_copyup(FAR struct unionfs_inode_s *ui,
+                          FAR const char *relpath,
+                          FAR const struct stat *buf, bool data)
+{
+  FAR struct unionfs_mountpt_s *upper = &ui->ui_fs[0];
+  FAR struct unionfs_mountpt_s *lower = &ui->ui_fs[1];
+  FAR const struct mountpt_operations *uops = upper->um_node->u.i_mops;
+  FAR const struct mountpt_operations *lops = lower->um_node->u.i_mops;
+  FAR char *copybuf;
+  struct file dst;
+  struct file src;
+  ssize_t nread;
+  ssize_t nwritten;
+  int ret;
+
+  finfo("relpath: %s\n", relpath);
+
+  ret = unionfs_copyup_parents(ui, relpath);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (S_ISDIR(buf->st_mode))
+    {
+      ret = unionfs_trymkdir(upper->um_node, relpath, upper->um_prefix,
+                             buf->st_mode & 0777);
+      goto out;
+    }
+  else if (!S_ISREG(buf->st_mode))
+    {
+      return -ENOSYS;
+    }
+
+  memset(&dst, 0, sizeof(struct file));
+  dst.f_oflags = O_WRONLY | O_CREAT | O_TRUNC;
+  dst.f_inode  = upper->um_node;
+
+  ret = unionfs_tryopen(&dst, relpath, upper->um_prefix, dst.f_oflags,
+                        buf->st_mode & 0777);
+  if (ret < 0)
+    {
+      goto out;
+    }
+
+  if (data && buf->st_size > 0)
+    {
+      if (lops->read == NULL || uops->write == NULL)
+        {
+          ret = -ENOSYS;
+          goto errout_with_dst;
+        }
+
+      copybuf = fs_heap_malloc(UNIONFS_COPYUP_BUFSIZE);
+      if (copybuf == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout_with_dst;
+        }
+
+      memset(&src, 0, sizeof(struct file));
+      src.f_oflags = O_RDONLY;
+      src.f_inode  = lower->um_node;
+
+      ret = unionfs_tryopen(&src, relpath, lower->um_prefix, O_RDONLY, 0);
+      if (ret >= 0)
+        {
+          while ((nread = lops->read(&src, copybuf,
+                                     UNIONFS_COPYUP_BUFSIZE)) > 0)
+            {
+              FAR char *ptr = copybuf;
+
+              do
+                {
+                  nwritten = uops->write(&dst, ptr, nread);
+                  if (nwritten <= 0)
+                    {
+                      nread = nwritten < 0 ? nwritten : -EIO;
+                      break;
+                    }
+
+                  ptr   += nwritten;
+                  nread -= nwritten;
+                }
+              while (nread > 0);
+
+              if (nread < 0)
+                {
+                  break;
+                }
+            }
+
+          ret = nread < 0 ? nread : OK;
+
+          if (lops->close != NULL)
+            {
+              lops->close(&src);
+            }
+        }
+
+      fs_heap_free(copybuf);
+    }
+
+  if (ret >= 0 && uops->chstat != NULL)
+    {
+      /* Carry over the ownership and time stamps.  This is best effort, not
+       * every file system can store them.
+       */
+
+      unionfs_trychstat(upper->um_node, relpath, upper->um_prefix, buf,
+                        CH_STAT_UID | CH_STAT_GID | CH_STAT_ATIME |
+                        CH_STAT_MTIME);
+    }
+
+errout_with_dst:
+  if (uops->close != NULL)
+    {
+      uops->close(&dst);
+    }
+
+  if (ret < 0)
+    {
+      /* Don't leave a partial copy behind to shadow the original */
+
+      unionfs_tryunlink(upper->um_node, relpath, upper->um_prefix);
+    }
+
+out:
+  unionfs_invalidate(ui);
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Name: unionfs_scandir
+ *
+ * Description:
+ *   Call handler for each entry of the relpath directory on one of the
+ *   contained file systems.  The scan stops at the first handler failure.
+ *
+ ****************************************************************************/
+
+static int unionfs_scandir(FAR struct unionfs_inode_s *ui, int ndx,
+                           FAR const char *relpath, unionfs_scan_t handler)
+{
+  FAR struct unionfs_mountpt_s *um = &ui->ui_fs[ndx];
+  FAR const struct mountpt_operations *ops = um->um_node->u.i_mops;
+  FAR struct fs_dirent_s *dir;
+  FAR struct dirent *entry;
+  int ret;
+
+  if (ops->readdir == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  entry = fs_heap_malloc(sizeof(struct dirent));
+  if (entry == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix, &dir);
+  if (ret < 0)
+    {
+      goto errout_with_entry;
+    }
+
+  dir->fd_root = um->um_node;
+
+  while ((ret = ops->readdir(um->um_node, dir, entry)) >= 0)
+    {
+      if (strcmp(entry->d_name, ".") == 0 ||
+          strcmp(entry->d_name, "..") == 0)
+        {
+          continue;
+        }
+
+      ret = handler(ui, relpath, entry->d_name);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  /* -ENOENT just marks the end of the directory */
+
+  if (ret == -ENOENT)
+    {
+      ret = OK;
+    }
+
+  if (ops->closedir != NULL)
+    {
+      ops->closedir(um->um_node, dir);
+    }
+
+errout_with_entry:
+  fs_heap_free(entry);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: unionfs_scan_upper
+ *
+ * Description:
+ *   unionfs_scandir() handler that fails if a file system 1 directory
+ *   holds anything other than whiteouts.
+ *
+ ****************************************************************************/
+
+static int unionfs_scan_upper(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath, FAR const char *name)
+{
+  return unionfs_iswhiteout(name) ? OK : -ENOTEMPTY;
+}
+
+/****************************************************************************
+ * Name: unionfs_scan_lower
+ *
+ * Description:
+ *   unionfs_scandir() handler that fails if a file system 2 directory
+ *   holds anything that is not hidden by a whiteout.
+ *
+ ****************************************************************************/
+
+static int unionfs_scan_lower(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath, FAR const char *name)
+{
+  FAR char *path;
+  bool hidden;
+
+  path = unionfs_relpath(relpath, name);
+  if (path == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hidden = unionfs_whitedout(ui, path);
+  fs_heap_free(path);
+  return hidden ? OK : -ENOTEMPTY;
+}
+
+/****************************************************************************
+ * Name: unionfs_scan_purge
+ *
+ * Description:
+ *   unionfs_scandir() handler that removes the whiteout for each entry of a
+ *   file system 2 directory from the file system 1 directory.
+ *
+ ****************************************************************************/
+
+static int unionfs_scan_purge(FAR struct unionfs_inode_s *ui,
+                              FAR const char *relpath, FAR const char *name)
+{
+  FAR struct unionfs_mountpt_s *um = &ui->ui_fs[0];
+  FAR char *wpath;
+  int ret;
+
+  if (relpath != NULL && *relpath != '\0')
+    {
+      ret = fs_heap_asprintf(&wpath, "%s/%s%s", relpath, UNIONFS_WHITEOUT,
+                             name);
+    }
+  else
+    {
+      ret = fs_heap_asprintf(&wpath, "%s%s", UNIONFS_WHITEOUT, name);
+    }
+
+  if (ret < 0)
+    {
+      return -ENOMEM;
+    }
+
+  unionfs_tryunlink(um->um_node, wpath, um->um_prefix);
+  fs_heap_free(wpath);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: unionfs_lookup
+ *
+ * Description:
+ *   Find which of the contained file systems holds relpath.  If buf is not
+ *   NULL, it receives the status of relpath on that file system.
+ *
+ * Returned Value:
+ *   The index of the file system holding relpath or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int unionfs_lookup(FAR struct unionfs_inode_s *ui,
+                          FAR const char *relpath, FAR struct stat *buf)
+{
+  FAR struct unionfs_mountpt_s *um;
+  struct stat tmp;
+  int ret;
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  uint32_t gen;
+
+  ret = unionfs_cache_get(ui, relpath, &gen);
+  if (ret == -ENOENT || (ret >= 0 && buf == NULL))
+    {
+      return ret;
+    }
+  else if (ret >= 0)
+    {
+      um = &ui->ui_fs[ret];
+      if (unionfs_trystat(um->um_node, relpath, um->um_prefix, buf) >= 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
+  if (buf == NULL)
+    {
+      buf = &tmp;
+    }
+
+  um  = &ui->ui_fs[0];
+  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  if (ret >= 0)
+    {
+      ret = 0;
+    }
+  else if (unionfs_hidden(ui, relpath))
+    {
+      ret = -ENOENT;
+    }
+  else
+    {
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+      if (ret >= 0)
+        {
+          ret = 1;
+        }
+    }
+
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  unionfs_cache_put(ui, relpath, gen, ret);
+#endif
+  return ret;
+}
+
 /****************************************************************************
  * Name: unionfs_unbind_child
  ****************************************************************************/
@@ -832,6 +1659,10 @@ static int unionfs_unbind_child(FAR struct unionfs_mountpt_s *um)
 
 static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
 {
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  int i;
+#endif
+
   DEBUGASSERT(ui != NULL && ui->ui_fs[0].um_node != NULL &&
               ui->ui_fs[1].um_node != NULL && ui->ui_nopen == 0);
 
@@ -852,6 +1683,20 @@ static void unionfs_destroy(FAR struct unionfs_inode_s *ui)
       fs_heap_free(ui->ui_fs[1].um_prefix);
     }
 
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  /* Free the lookup cache */
+
+  for (i = 0; i < CONFIG_FS_UNIONFS_LOOKUP_NCACHE; i++)
+    {
+      if (ui->ui_cache[i].ul_path != NULL)
+        {
+          fs_heap_free(ui->ui_cache[i].ul_path);
+        }
+    }
+
+  nxmutex_destroy(&ui->ui_cachelock);
+#endif
+
   /* And finally free the allocated unionfs state structure as well */
 
   nxmutex_destroy(&ui->ui_lock);
@@ -868,6 +1713,10 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_file_s *uf;
   FAR struct unionfs_mountpt_s *um;
+  bool create;
+  int first;
+  int last;
+  int ndx;
   int ret;
 
   /* Recover the open file data from the struct file instance */
@@ -884,51 +1733,105 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
       return ret;
     }
 
-  /* Allocate a container to hold the open file system information */
+  /* Allocate a container to hold the open file system information */
+
+  uf = (FAR struct unionfs_file_s *)
+    fs_heap_zalloc(sizeof(struct unionfs_file_s));
+  if (uf == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  /* Find out which file system holds the file */
+
+  ndx    = unionfs_lookup(ui, relpath, NULL);
+  create = ndx < 0 && (oflags & O_CREAT) != 0;
+
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  if (ndx == 1 && (oflags & (O_WROK | O_TRUNC)) != 0)
+    {
+      struct stat buf;
+
+      /* The file is about to be modified.  Copy it up to file system 1
+       * first, there is no need to copy the data if it will be truncated.
+       */
+
+      um  = &ui->ui_fs[1];
+      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+      if (ret >= 0)
+        {
+          ret = unionfs_copyup(ui, relpath, &buf, (oflags & O_TRUNC) == 0);
+        }
+
+      if (ret < 0)
+        {
+          goto errout_with_uf;
+        }
 
-  uf = (FAR struct unionfs_file_s *)
-    fs_heap_zalloc(sizeof(struct unionfs_file_s));
-  if (uf == NULL)
-    {
-      ret = -ENOMEM;
-      goto errout_with_lock;
+      ndx = 0;
     }
+  else if (create)
+    {
+      /* New files are only created on file system 1 */
 
-  /* Try to open the file on file system 1 */
+      ret = unionfs_copyup_parents(ui, relpath);
+      if (ret < 0)
+        {
+          goto errout_with_uf;
+        }
 
-  um = &ui->ui_fs[0];
-  DEBUGASSERT(um != NULL && um->um_node != NULL &&
-              um->um_node->u.i_mops != NULL);
+      ndx = 0;
+    }
+#endif
 
-  uf->uf_file.f_oflags = filep->f_oflags;
-  uf->uf_file.f_inode  = um->um_node;
+  if (ndx >= 0)
+    {
+      /* Open the file where it was found */
 
-  ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags, mode);
-  if (ret >= 0)
+      first = ndx;
+      last  = ndx;
+    }
+  else if (create)
     {
-      /* Successfully opened on file system 1 */
+      /* Create the file on the first file system that will take it */
 
-      uf->uf_ndx = 0;
+      first = 0;
+      last  = 1;
     }
   else
     {
-      /* Try to open the file on file system 1 */
+      ret = ndx;
+      goto errout_with_uf;
+    }
 
-      um  = &ui->ui_fs[1];
+  for (ndx = first; ndx <= last; ndx++)
+    {
+      um = &ui->ui_fs[ndx];
+      DEBUGASSERT(um != NULL && um->um_node != NULL &&
+                  um->um_node->u.i_mops != NULL);
 
       uf->uf_file.f_oflags = filep->f_oflags;
       uf->uf_file.f_inode  = um->um_node;
 
       ret = unionfs_tryopen(&uf->uf_file, relpath, um->um_prefix, oflags,
                             mode);
-      if (ret < 0)
+      if (ret >= 0)
         {
-          goto errout_with_lock;
+          break;
         }
+    }
+
+  if (ret < 0)
+    {
+      goto errout_with_uf;
+    }
 
-      /* Successfully opened on file system 1 */
+  uf->uf_ndx = ndx;
 
-      uf->uf_ndx = 1;
+  if (create)
+    {
+      unionfs_invalidate(ui);
     }
 
   /* Increment the open reference count */
@@ -939,7 +1842,11 @@ static int unionfs_open(FAR struct file *filep, FAR const char *relpath,
   /* Save our private data in the file structure */
 
   filep->f_priv = (FAR void *)uf;
-  ret = OK;
+  nxmutex_unlock(&ui->ui_lock);
+  return OK;
+
+errout_with_uf:
+  fs_heap_free(uf);
 
 errout_with_lock:
   nxmutex_unlock(&ui->ui_lock);
@@ -1447,11 +2354,16 @@ static int unionfs_opendir(FAR struct inode *mountpt,
         }
     }
 
-  /* Check file system 2 first. */
+  /* Check file system 2 first, unless the directory is hidden there. */
 
   um = &ui->ui_fs[1];
-  ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
-                           &udir->fu_lower[1]);
+  ret = -ENOENT;
+  if (!unionfs_hidden(ui, relpath))
+    {
+      ret = unionfs_tryopendir(um->um_node, relpath, um->um_prefix,
+                               &udir->fu_lower[1]);
+    }
+
   if (ret >= 0)
     {
       /* Save the file system 2 access info */
@@ -1865,11 +2777,26 @@ static int unionfs_readdir(FAR struct inode *mountpt,
                       duplicate = true;
                     }
 
+                  /* Or the entry may have been removed from the union */
+
+                  else if (unionfs_whitedout(ui, relpath))
+                    {
+                      duplicate = true;
+                    }
+
                   /* Free the allocated relpath */
 
                   fs_heap_free(relpath);
                 }
             }
+
+          /* Whiteouts on file system 1 are never listed */
+
+          else if (ret >= 0 && udir->fu_ndx == 0 &&
+                   unionfs_iswhiteout(entry->d_name))
+            {
+              duplicate = true;
+            }
         }
       while (duplicate);
     }
@@ -2171,6 +3098,7 @@ static int unionfs_unlink(FAR struct inode *mountpt,
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
   struct stat buf;
+  int ndx;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2181,45 +3109,66 @@ static int unionfs_unlink(FAR struct inode *mountpt,
               relpath != NULL);
   ui = mountpt->i_private;
 
-  /* Check if some exists at this path on file system 1.  This might be
-   * a file or a directory
+  /* Get exclusive access to the file system data structures */
+
+  ret = nxmutex_lock(&ui->ui_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Find the file system that holds this path.  This might be a file or a
+   * directory.
    */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
-  if (ret >= 0)
+  ndx = unionfs_lookup(ui, relpath, &buf);
+  if (ndx < 0)
     {
-      /* Yes.. Try to unlink the file on file system 1 (perhaps exposing
-       * a file of the same name on file system 2).  This would fail
-       * with -ENOSYS if file system 1 is a read-only only file system or
-       * -EISDIR if the path is not a file.
-       */
+      ret = ndx;
+      goto errout_with_lock;
+    }
 
-      ret = unionfs_tryunlink(um->um_node, relpath, um->um_prefix);
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  if (S_ISDIR(buf.st_mode))
+    {
+      ret = -EISDIR;
+      goto errout_with_lock;
     }
 
-  /* There is nothing at this path on file system 1 */
+  /* Remove the file from file system 1 if it is there */
 
-  else
+  if (ndx == 0)
     {
-      /* Check if the file exists with name on file system 2.  The only
-       * reason that we check here is so that we can return the more
-       * meaningful -ENOSYS if file system 2 is a read-only file system.
-       */
-
-      um  = &ui->ui_fs[1];
-      ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
-      if (ret >= 0)
+      um  = &ui->ui_fs[0];
+      ret = unionfs_tryunlink(um->um_node, relpath, um->um_prefix);
+      if (ret < 0)
         {
-          /* Yes.. Try to unlink the file on file system 1.  This would fail
-           * with -ENOSYS if file system 2 is a read-only only file system or
-           * -EISDIR if the path is not a file.
-           * */
-
-          ret = unionfs_tryunlink(um->um_node, relpath, um->um_prefix);
+          goto errout_with_lock;
         }
     }
 
+  /* File system 2 is read-only.  Hide any file of the same name there. */
+
+  um = &ui->ui_fs[1];
+  if (unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf) >= 0)
+    {
+      ret = unionfs_whiteout(ui, relpath);
+    }
+#else
+  /* Try to unlink the file where it was found.  If that is file system 1,
+   * this may expose a file of the same name on file system 2.  This would
+   * fail with -ENOSYS if the file system is a read-only file system or
+   * -EISDIR if the path is not a file.
+   */
+
+  um  = &ui->ui_fs[ndx];
+  ret = unionfs_tryunlink(um->um_node, relpath, um->um_prefix);
+#endif
+
+  unionfs_invalidate(ui);
+
+errout_with_lock:
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2232,9 +3181,10 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
-  struct stat buf;
+#ifndef CONFIG_FS_UNIONFS_OVERLAY
   int ret1;
   int ret2;
+#endif
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2245,22 +3195,36 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = mountpt->i_private;
 
+  /* Get exclusive access to the file system data structures */
+
+  ret = nxmutex_lock(&ui->ui_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* Is there anything with this name on either file system? */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+  ret = unionfs_lookup(ui, relpath, NULL);
   if (ret >= 0)
     {
-      return -EEXIST;
+      ret = -EEXIST;
+      goto errout_with_lock;
     }
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, &buf);
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  /* New directories are only created on file system 1.  If the name is
+   * whited out, the whiteout stays in place and keeps hiding the old
+   * content on file system 2.
+   */
+
+  ret = unionfs_copyup_parents(ui, relpath);
   if (ret >= 0)
     {
-      return -EEXIST;
+      um  = &ui->ui_fs[0];
+      ret = unionfs_trymkdir(um->um_node, relpath, um->um_prefix, mode);
     }
-
+#else
   /* Try to create the directory on both file systems. */
 
   um  = &ui->ui_fs[0];
@@ -2274,7 +3238,14 @@ static int unionfs_mkdir(FAR struct inode *mountpt, FAR const char *relpath,
    * read-only and the other is write-able?
    */
 
-  return (ret1 >= 0 || ret2 >= 0) ? OK : ret1;
+  ret = (ret1 >= 0 || ret2 >= 0) ? OK : ret1;
+#endif
+
+  unionfs_invalidate(ui);
+
+errout_with_lock:
+  nxmutex_unlock(&ui->ui_lock);
+  return ret;
 }
 
 /****************************************************************************
@@ -2285,6 +3256,11 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  struct stat buf;
+  bool lower;
+  int ndx;
+#endif
   int ret = -ENOENT;
   int tmp;
 
@@ -2296,6 +3272,74 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
               relpath != NULL);
   ui = mountpt->i_private;
 
+  /* Get exclusive access to the file system data structures */
+
+  tmp = nxmutex_lock(&ui->ui_lock);
+  if (tmp < 0)
+    {
+      return tmp;
+    }
+
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  ndx = unionfs_lookup(ui, relpath, &buf);
+  if (ndx < 0)
+    {
+      ret = ndx;
+      goto errout_with_lock;
+    }
+  else if (!S_ISDIR(buf.st_mode))
+    {
+      ret = -ENOTDIR;
+      goto errout_with_lock;
+    }
+
+  um    = &ui->ui_fs[1];
+  lower = unionfs_trystatdir(um->um_node, relpath, um->um_prefix) >= 0;
+
+  /* The directory must look empty in the union:  On file system 1 it may
+   * only hold whiteouts and everything in it on file system 2 must be
+   * whited out.
+   */
+
+  if (ndx == 0)
+    {
+      ret = unionfs_scandir(ui, 0, relpath, unionfs_scan_upper);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  if (lower && !unionfs_hidden(ui, relpath))
+    {
+      ret = unionfs_scandir(ui, 1, relpath, unionfs_scan_lower);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  ret = OK;
+  if (ndx == 0)
+    {
+      /* Remove the whiteouts and then the directory from file system 1 */
+
+      if (lower)
+        {
+          unionfs_scandir(ui, 1, relpath, unionfs_scan_purge);
+        }
+
+      um  = &ui->ui_fs[0];
+      ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
+    }
+
+  /* File system 2 is read-only.  Hide the directory there. */
+
+  if (ret >= 0 && lower)
+    {
+      ret = unionfs_whiteout(ui, relpath);
+    }
+#else
   /* We really don't know any better so we will try to remove the directory
    * from both file systems.
    */
@@ -2313,7 +3357,7 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
       ret = unionfs_tryrmdir(um->um_node, relpath, um->um_prefix);
       if (ret < 0)
         {
-          return ret;
+          goto errout_with_lock;
         }
     }
 
@@ -2335,7 +3379,11 @@ static int unionfs_rmdir(FAR struct inode *mountpt, FAR const char *relpath)
        * if we failure to removed the directory on file system 2?
        */
     }
+#endif
 
+errout_with_lock:
+  unionfs_invalidate(ui);
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2349,6 +3397,12 @@ static int unionfs_rename(FAR struct inode *mountpt,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  struct stat buf;
+  struct stat lbuf;
+  bool lower;
+  int ndx;
+#endif
   int ret = -ENOENT;
   int tmp;
 
@@ -2361,6 +3415,64 @@ static int unionfs_rename(FAR struct inode *mountpt,
 
   DEBUGASSERT(oldrelpath != NULL && oldrelpath != NULL);
 
+  /* Get exclusive access to the file system data structures */
+
+  tmp = nxmutex_lock(&ui->ui_lock);
+  if (tmp < 0)
+    {
+      return tmp;
+    }
+
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  ndx = unionfs_lookup(ui, oldrelpath, &buf);
+  if (ndx < 0)
+    {
+      ret = ndx;
+      goto errout_with_lock;
+    }
+
+  um    = &ui->ui_fs[1];
+  lower = unionfs_trystat(um->um_node, oldrelpath, um->um_prefix,
+                          &lbuf) >= 0;
+
+  /* Moving a directory that is visible on file system 2 would require
+   * copying up its whole content.
+   */
+
+  if (S_ISDIR(buf.st_mode) && lower && !unionfs_hidden(ui, oldrelpath))
+    {
+      ret = -EXDEV;
+      goto errout_with_lock;
+    }
+
+  /* Files on file system 2 are copied up and renamed on file system 1 */
+
+  if (ndx == 1)
+    {
+      ret = unionfs_copyup(ui, oldrelpath, &buf, true);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+    }
+
+  ret = unionfs_copyup_parents(ui, newrelpath);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  um  = &ui->ui_fs[0];
+  ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
+                          um->um_prefix);
+
+  /* Make sure that the original on file system 2 does not reappear */
+
+  if (ret >= 0 && lower)
+    {
+      ret = unionfs_whiteout(ui, oldrelpath);
+    }
+#else
   /* Is there a file with this name on file system 1 */
 
   um   = &ui->ui_fs[0];
@@ -2381,7 +3493,8 @@ static int unionfs_rename(FAR struct inode *mountpt,
            * file of the same relative path will become visible.
            */
 
-          return OK;
+          ret = OK;
+          goto errout_with_lock;
         }
     }
 
@@ -2401,7 +3514,11 @@ static int unionfs_rename(FAR struct inode *mountpt,
       ret = unionfs_tryrename(um->um_node, oldrelpath, newrelpath,
                               um->um_prefix);
     }
+#endif
 
+errout_with_lock:
+  unionfs_invalidate(ui);
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2413,7 +3530,6 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
                         FAR struct stat *buf)
 {
   FAR struct unionfs_inode_s *ui;
-  FAR struct unionfs_mountpt_s *um;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2424,34 +3540,18 @@ static int unionfs_stat(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = mountpt->i_private;
 
-  /* stat this path on file system 1 */
-
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
-  if (ret >= 0)
-    {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
-
-      return OK;
-    }
-
-  /* stat failed on the file system 1.  Try again on file system 2. */
+  /* stat this path on the file system that holds it.  The first instance
+   * of the file will shadow the second anyway.
+   */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trystat(um->um_node, relpath, um->um_prefix, buf);
+  ret = unionfs_lookup(ui, relpath, buf);
   if (ret >= 0)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
-
       return OK;
     }
 
   /* Special case the unionfs root directory when both file systems are
-   * offset.  In that case, both of the above trystat calls will fail.
+   * offset.  In that case, the lookup on both file systems will fail.
    */
 
   if (ui->ui_fs[0].um_prefix != NULL && ui->ui_fs[1].um_prefix != NULL)
@@ -2491,6 +3591,8 @@ static int unionfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
 {
   FAR struct unionfs_inode_s *ui;
   FAR struct unionfs_mountpt_s *um;
+  struct stat tmp;
+  int ndx;
   int ret;
 
   finfo("relpath: %s\n", relpath);
@@ -2501,28 +3603,45 @@ static int unionfs_chstat(FAR struct inode *mountpt, FAR const char *relpath,
               relpath != NULL);
   ui = mountpt->i_private;
 
-  /* chstat this path on file system 1 */
+  /* Get exclusive access to the file system data structures */
 
-  um  = &ui->ui_fs[0];
-  ret = unionfs_trychstat(um->um_node, relpath, um->um_prefix, buf, flags);
-  if (ret >= 0)
+  ret = nxmutex_lock(&ui->ui_lock);
+  if (ret < 0)
     {
-      /* Return on the first success.  The first instance of the file will
-       * shadow the second anyway.
-       */
+      return ret;
+    }
 
-      return OK;
+  /* chstat this path on the file system that holds it.  The first
+   * instance of the file will shadow the second anyway.
+   */
+
+  ndx = unionfs_lookup(ui, relpath, &tmp);
+  if (ndx < 0)
+    {
+      ret = ndx;
+      goto errout_with_lock;
     }
 
-  /* chstat failed on the file system 1.  Try again on file system 2. */
+#ifdef CONFIG_FS_UNIONFS_OVERLAY
+  /* File system 2 is read-only, change a copy on file system 1 instead */
 
-  um  = &ui->ui_fs[1];
-  ret = unionfs_trychstat(um->um_node, relpath, um->um_prefix, buf, flags);
-  if (ret >= 0)
+  if (ndx == 1)
     {
-      return OK;
+      ret = unionfs_copyup(ui, relpath, &tmp, true);
+      if (ret < 0)
+        {
+          goto errout_with_lock;
+        }
+
+      ndx = 0;
     }
+#endif
+
+  um  = &ui->ui_fs[ndx];
+  ret = unionfs_trychstat(um->um_node, relpath, um->um_prefix, buf, flags);
 
+errout_with_lock:
+  nxmutex_unlock(&ui->ui_lock);
   return ret;
 }
 
@@ -2608,6 +3727,10 @@ static int unionfs_dobind(FAR const char *fspath1, FAR const char *prefix1,
     }
 
   nxmutex_init(&ui->ui_lock);
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  nxmutex_init(&ui->ui_cachelock);
+  ui->ui_gen = 1;
+#endif
 
   /* Get the inodes associated with fspath1 and fspath2 */
 
@@ -2675,6 +3798,9 @@ errout_with_fs1:
   inode_release(ui->ui_fs[0].um_node);
 
 errout_with_uinode:
+#if CONFIG_FS_UNIONFS_LOOKUP_NCACHE > 0
+  nxmutex_destroy(&ui->ui_cachelock);
+#endif
   nxmutex_destroy(&ui->ui_lock);
   fs_heap_free(ui);
   return ret;
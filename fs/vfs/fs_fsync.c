@@ -55,6 +55,7 @@
 int file_fsync(FAR struct file *filep)
 {
   FAR struct inode *inode;
+  bool iowait;
   int ret;
 
   /* Is this inode a registered mountpoint? Does it support the
@@ -72,14 +73,19 @@ int file_fsync(FAR struct file *filep)
             {
               /* Yes, then tell the mountpoint to sync this file */
 
-              return inode->u.i_mops->sync(filep);
+              iowait = nxsched_iowait_begin();
+              ret = inode->u.i_mops->sync(filep);
+              nxsched_iowait_end(iowait);
+              return ret;
             }
         }
       else
 #endif
       if (inode->u.i_ops && inode->u.i_ops->ioctl)
         {
+          iowait = nxsched_iowait_begin();
           ret = inode->u.i_ops->ioctl(filep, BIOC_FLUSH, 0);
+          nxsched_iowait_end(iowait);
           return ret >= 0 ? 0 : ret;
         }
     }
@@ -34,6 +34,7 @@
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
 
 #include "inode/inode.h"
 #include "vfs.h"
@@ -209,9 +210,13 @@ ssize_t file_readv(FAR struct file *filep,
   else if (inode != NULL && inode->u.i_ops)
     {
       clock_t start_time;
+      bool iowait;
 
       FS_PROFILE_START(start_time);
 
+      /* Reads of a file system may have to wait for the storage */
+
+      iowait = INODE_IS_MOUNTPT(inode) && nxsched_iowait_begin();
       if (inode->u.i_ops->readv)
         {
           struct uio uio;
@@ -227,6 +232,7 @@ ssize_t file_readv(FAR struct file *filep,
           ret = file_readv_compat(filep, iov, iovcnt);
         }
 
+      nxsched_iowait_end(iowait);
       FS_PROFILE_STOP(start_time, g_fs_profile.total_read_time,
                       g_fs_profile.reads);
     }
@@ -34,6 +34,7 @@
 #include <assert.h>
 
 #include <nuttx/cancelpt.h>
+#include <nuttx/sched.h>
 
 #include "inode/inode.h"
 #include "vfs.h"
@@ -189,9 +190,13 @@ ssize_t file_writev(FAR struct file *filep,
   if (inode != NULL && inode->u.i_ops)
     {
       clock_t start_time;
+      bool iowait;
 
       FS_PROFILE_START(start_time);
 
+      /* Writes to a file system may have to wait for the storage */
+
+      iowait = INODE_IS_MOUNTPT(inode) && nxsched_iowait_begin();
       if (inode->u.i_ops->writev)
         {
           struct uio uio;
@@ -207,6 +212,7 @@ ssize_t file_writev(FAR struct file *filep,
           ret = file_writev_compat(filep, iov, iovcnt);
         }
 
+      nxsched_iowait_end(iowait);
       FS_PROFILE_STOP(start_time, g_fs_profile.total_write_time,
                       g_fs_profile.writes);
     }
@@ -25,8 +25,10 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/statfs.h>
@@ -51,16 +53,59 @@ struct zipfs_dir_s
   bool last;
 };
 
+#ifdef CONFIG_ZIPFS_DIRCACHE
+struct zipfs_hash_s
+{
+  uint32_t hash;              /* Hash of the case folded entry name */
+  unz64_file_pos pos;         /* Position in the central directory */
+};
+#endif
+
 struct zipfs_mountpt_s
 {
+#ifdef CONFIG_ZIPFS_DIRCACHE
+  FAR struct zipfs_hash_s *hash;   /* Sorted by hash, NULL if unavailable */
+  size_t nhash;
+#endif
   char abspath[1];
 };
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+struct zipfs_point_s
+{
+  off_t out;                  /* Uncompressed offset of the checkpoint */
+  off_t in;                   /* Compressed offset of the next full byte */
+  uint8_t bits;               /* Pending bits of the byte before 'in' */
+  uInt wsize;                 /* Size of the dictionary snapshot */
+  FAR Bytef *window;          /* Dictionary snapshot */
+};
+
+struct zipfs_index_s
+{
+  struct file zfile;          /* Raw access to the archive */
+  z_stream strm;              /* Raw inflate state */
+  int method;                 /* 0 (stored) or Z_DEFLATED */
+  bool eof;                   /* End of the deflate stream reached */
+  off_t base;                 /* Archive offset of the entry data */
+  off_t csize;                /* Compressed size */
+  off_t usize;                /* Uncompressed size */
+  off_t in;                   /* Compressed bytes read from zfile */
+  off_t out;                  /* Uncompressed bytes produced by strm */
+  off_t interval;             /* Current checkpoint interval */
+  int npoints;
+  struct zipfs_point_s points[CONFIG_ZIPFS_SEEK_MAXPOINTS];
+  Bytef inbuf[CONFIG_ZIPFS_SEEK_BUFSIZE];
+};
+#endif
+
 struct zipfs_file_s
 {
   unzFile uf;
   mutex_t lock;
   FAR char *seekbuf;
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  FAR struct zipfs_index_s *index; /* NULL if minizip inflates the entry */
+#endif
   char relpath[1];
 };
 
@@ -243,6 +288,584 @@ static int zipfs_convert_result(int ziperr)
     }
 }
 
+#ifdef CONFIG_ZIPFS_DIRCACHE
+static uint32_t zipfs_hash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  /* FNV-1a over the case folded name, so the lookup stays correct when
+   * minizip compares names case insensitively.
+   */
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)tolower(*name++);
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+static int zipfs_hash_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct zipfs_hash_s *ha = a;
+  FAR const struct zipfs_hash_s *hb = b;
+
+  if (ha->hash != hb->hash)
+    {
+      return ha->hash < hb->hash ? -1 : 1;
+    }
+
+  /* Keep entries with the same hash in directory order, so that
+   * duplicated names resolve to the same entry as unzLocateFile().
+   */
+
+  if (ha->pos.num_of_file != hb->pos.num_of_file)
+    {
+      return ha->pos.num_of_file < hb->pos.num_of_file ? -1 : 1;
+    }
+
+  return 0;
+}
+
+static void zipfs_dircache_build(FAR struct zipfs_mountpt_s *fs,
+                                 unzFile uf)
+{
+  FAR struct zipfs_hash_s *hash;
+  unz_global_info64 global;
+  unz_file_info64 file_info;
+  FAR char *name;
+  size_t nhash = 0;
+  int ret;
+
+  if (unzGetGlobalInfo64(uf, &global) != UNZ_OK ||
+      global.number_entry == 0)
+    {
+      return;
+    }
+
+  hash = fs_heap_malloc(global.number_entry * sizeof(*hash));
+  if (hash == NULL)
+    {
+      return;
+    }
+
+  name = fs_heap_malloc(PATH_MAX);
+  if (name == NULL)
+    {
+      fs_heap_free(hash);
+      return;
+    }
+
+  ret = unzGoToFirstFile(uf);
+  while (ret == UNZ_OK && nhash < global.number_entry)
+    {
+      ret = unzGetCurrentFileInfo64(uf, &file_info, name, PATH_MAX,
+                                    NULL, 0, NULL, 0);
+      if (ret != UNZ_OK || file_info.size_filename >= PATH_MAX)
+        {
+          break;
+        }
+
+      ret = unzGetFilePos64(uf, &hash[nhash].pos);
+      if (ret != UNZ_OK)
+        {
+          break;
+        }
+
+      hash[nhash++].hash = zipfs_hash(name);
+      ret = unzGoToNextFile(uf);
+    }
+
+  fs_heap_free(name);
+
+  /* Fall back to unzLocateFile() unless the whole directory was hashed */
+
+  if (ret != UNZ_END_OF_LIST_OF_FILE || nhash != global.number_entry)
+    {
+      fs_heap_free(hash);
+      return;
+    }
+
+  qsort(hash, nhash, sizeof(*hash), zipfs_hash_compare);
+  fs->hash = hash;
+  fs->nhash = nhash;
+}
+
+static int zipfs_dircache_locate(FAR struct zipfs_mountpt_s *fs,
+                                 unzFile uf, FAR const char *relpath)
+{
+  unz_file_info64 file_info;
+  FAR char *name;
+  uint32_t hash;
+  size_t len;
+  size_t lo;
+  size_t hi;
+  int ret;
+
+  hash = zipfs_hash(relpath);
+  lo = 0;
+  hi = fs->nhash;
+
+  /* Find the first entry with a matching hash */
+
+  while (lo < hi)
+    {
+      size_t mid = lo + (hi - lo) / 2;
+
+      if (fs->hash[mid].hash < hash)
+        {
+          lo = mid + 1;
+        }
+      else
+        {
+          hi = mid;
+        }
+    }
+
+  len = strlen(relpath);
+  name = fs_heap_malloc(len + 1);
+  if (name == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = -ENOENT;
+  for (; lo < fs->nhash && fs->hash[lo].hash == hash; lo++)
+    {
+      ret = zipfs_convert_result(unzGoToFilePos64(uf, &fs->hash[lo].pos));
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret = unzGetCurrentFileInfo64(uf, &file_info, name, len + 1,
+                                    NULL, 0, NULL, 0);
+      ret = zipfs_convert_result(ret);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      if (file_info.size_filename == len &&
+          unzStringFileNameCompare(name, relpath, 0) == 0)
+        {
+          break;
+        }
+
+      ret = -ENOENT;
+    }
+
+  fs_heap_free(name);
+  return ret;
+}
+#endif
+
+static int zipfs_locate(FAR struct zipfs_mountpt_s *fs, unzFile uf,
+                        FAR const char *relpath)
+{
+#ifdef CONFIG_ZIPFS_DIRCACHE
+  if (fs->hash != NULL)
+    {
+      return zipfs_dircache_locate(fs, uf, relpath);
+    }
+#endif
+
+  return zipfs_convert_result(unzLocateFile(uf, relpath, 0));
+}
+
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+static void zipfs_index_free(FAR struct zipfs_index_s *idx)
+{
+  int i;
+
+  for (i = 0; i < idx->npoints; i++)
+    {
+      fs_heap_free(idx->points[i].window);
+    }
+
+  if (idx->method == Z_DEFLATED)
+    {
+      inflateEnd(&idx->strm);
+    }
+
+  file_close(&idx->zfile);
+  fs_heap_free(idx);
+}
+
+static int zipfs_index_open(FAR struct zipfs_mountpt_s *fs,
+                            FAR struct zipfs_file_s *fp)
+{
+  FAR struct zipfs_index_s *idx;
+  unz_file_info64 file_info;
+  ZPOS64_T base;
+  int ret;
+
+  ret = unzGetCurrentFileInfo64(fp->uf, &file_info, NULL, 0,
+                                NULL, 0, NULL, 0);
+  ret = zipfs_convert_result(ret);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Leave encrypted entries and other methods to minizip */
+
+  if ((file_info.flag & 1) != 0 ||
+      (file_info.compression_method != 0 &&
+       file_info.compression_method != Z_DEFLATED))
+    {
+      return -ENOSYS;
+    }
+
+  ret = zipfs_convert_result(unzOpenCurrentFile2(fp->uf, NULL, NULL, 1));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  base = unzGetCurrentFileZStreamPos64(fp->uf);
+  if (base == 0)
+    {
+      return -EINVAL;
+    }
+
+  idx = fs_heap_zalloc(sizeof(*idx));
+  if (idx == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = file_open(&idx->zfile, fs->abspath, O_RDONLY);
+  if (ret < 0)
+    {
+      fs_heap_free(idx);
+      return ret;
+    }
+
+  ret = file_seek(&idx->zfile, base, SEEK_SET);
+  if (ret < 0)
+    {
+      file_close(&idx->zfile);
+      fs_heap_free(idx);
+      return ret;
+    }
+
+  idx->method   = file_info.compression_method;
+  idx->base     = base;
+  idx->csize    = file_info.compressed_size;
+  idx->usize    = file_info.uncompressed_size;
+  idx->interval = CONFIG_ZIPFS_SEEK_INTERVAL;
+
+  if (idx->method == Z_DEFLATED &&
+      inflateInit2(&idx->strm, -MAX_WBITS) != Z_OK)
+    {
+      file_close(&idx->zfile);
+      fs_heap_free(idx);
+      return -ENOMEM;
+    }
+
+  fp->index = idx;
+  return OK;
+}
+
+static int zipfs_index_fill(FAR struct zipfs_index_s *idx)
+{
+  off_t remain = idx->csize - idx->in;
+  ssize_t ret;
+
+  if (remain > CONFIG_ZIPFS_SEEK_BUFSIZE)
+    {
+      remain = CONFIG_ZIPFS_SEEK_BUFSIZE;
+    }
+
+  if (remain <= 0)
+    {
+      return 0;
+    }
+
+  ret = file_read(&idx->zfile, idx->inbuf, remain);
+  if (ret > 0)
+    {
+      idx->in            += ret;
+      idx->strm.next_in   = idx->inbuf;
+      idx->strm.avail_in  = ret;
+    }
+
+  return ret;
+}
+
+static void zipfs_index_addpoint(FAR struct zipfs_index_s *idx)
+{
+  FAR struct zipfs_point_s *point;
+  off_t last;
+  int i;
+
+  last = idx->npoints > 0 ? idx->points[idx->npoints - 1].out : 0;
+  if (idx->out < last + idx->interval)
+    {
+      return;
+    }
+
+  if (idx->npoints == CONFIG_ZIPFS_SEEK_MAXPOINTS)
+    {
+      /* Keep every other checkpoint and double the interval, the
+       * remaining ones are then again about one interval apart.
+       */
+
+      for (i = 0; i < idx->npoints; i++)
+        {
+          if ((i & 1) == 0)
+            {
+              fs_heap_free(idx->points[i].window);
+            }
+          else
+            {
+              idx->points[i / 2] = idx->points[i];
+            }
+        }
+
+      idx->npoints  /= 2;
+      idx->interval *= 2;
+
+      last = idx->npoints > 0 ? idx->points[idx->npoints - 1].out : 0;
+      if (idx->out < last + idx->interval)
+        {
+          return;
+        }
+    }
+
+  point = &idx->points[idx->npoints];
+  inflateGetDictionary(&idx->strm, NULL, &point->wsize);
+  point->window = fs_heap_malloc(point->wsize);
+  if (point->window == NULL)
+    {
+      /* A checkpoint is only an optimization */
+
+      return;
+    }
+
+  inflateGetDictionary(&idx->strm, point->window, &point->wsize);
+  point->out  = idx->out;
+  point->in   = idx->in - idx->strm.avail_in;
+  point->bits = idx->strm.data_type & 7;
+  idx->npoints++;
+}
+
+static ssize_t zipfs_index_inflate(FAR struct zipfs_index_s *idx,
+                                   FAR char *buffer, size_t buflen)
+{
+  int ret = OK;
+
+  idx->strm.next_out  = (FAR Bytef *)buffer;
+  idx->strm.avail_out = buflen;
+
+  while (idx->strm.avail_out > 0 && !idx->eof)
+    {
+      uInt avail = idx->strm.avail_out;
+
+      if (idx->strm.avail_in == 0)
+        {
+          ret = zipfs_index_fill(idx);
+          if (ret < 0)
+            {
+              break;
+            }
+        }
+
+      /* Z_BLOCK returns at every deflate block boundary, which is where
+       * a checkpoint can be taken.
+       */
+
+      ret = inflate(&idx->strm, Z_BLOCK);
+      idx->out += avail - idx->strm.avail_out;
+      if (ret == Z_STREAM_END)
+        {
+          idx->eof = true;
+          ret = OK;
+          break;
+        }
+      else if (ret != Z_OK)
+        {
+          ret = ret == Z_MEM_ERROR ? -ENOMEM : -EIO;
+          break;
+        }
+
+      if ((idx->strm.data_type & 128) != 0 &&
+          (idx->strm.data_type & 64) == 0)
+        {
+          zipfs_index_addpoint(idx);
+        }
+    }
+
+  buflen -= idx->strm.avail_out;
+  return buflen > 0 ? buflen : ret;
+}
+
+static int zipfs_index_restore(FAR struct zipfs_index_s *idx,
+                               FAR struct zipfs_point_s *point)
+{
+  off_t in = 0;
+  int ret;
+
+  if (inflateReset(&idx->strm) != Z_OK)
+    {
+      return -EIO;
+    }
+
+  if (point != NULL)
+    {
+      in = point->in - (point->bits ? 1 : 0);
+    }
+
+  ret = file_seek(&idx->zfile, idx->base + in, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  idx->strm.avail_in = 0;
+  idx->in  = in;
+  idx->out = 0;
+  idx->eof = false;
+
+  if (point == NULL)
+    {
+      return OK;
+    }
+
+  if (point->bits)
+    {
+      ret = zipfs_index_fill(idx);
+      if (ret <= 0)
+        {
+          return ret < 0 ? ret : -EIO;
+        }
+
+      inflatePrime(&idx->strm, point->bits,
+                   *idx->strm.next_in >> (8 - point->bits));
+      idx->strm.next_in++;
+      idx->strm.avail_in--;
+    }
+
+  if (inflateSetDictionary(&idx->strm, point->window,
+                           point->wsize) != Z_OK)
+    {
+      return -EIO;
+    }
+
+  idx->out = point->out;
+  return OK;
+}
+
+static ssize_t zipfs_index_read(FAR struct file *filep,
+                                FAR char *buffer, size_t buflen)
+{
+  FAR struct zipfs_file_s *fp = filep->f_priv;
+  FAR struct zipfs_index_s *idx = fp->index;
+  ssize_t ret;
+
+  if (idx->method == Z_DEFLATED)
+    {
+      return zipfs_index_inflate(idx, buffer, buflen);
+    }
+
+  /* Stored entries are read in place */
+
+  if (filep->f_pos >= idx->usize)
+    {
+      return 0;
+    }
+
+  if (buflen > idx->usize - filep->f_pos)
+    {
+      buflen = idx->usize - filep->f_pos;
+    }
+
+  ret = file_seek(&idx->zfile, idx->base + filep->f_pos, SEEK_SET);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return file_read(&idx->zfile, buffer, buflen);
+}
+
+static off_t zipfs_index_seek(FAR struct file *filep, off_t offset)
+{
+  FAR struct zipfs_file_s *fp = filep->f_priv;
+  FAR struct zipfs_index_s *idx = fp->index;
+  FAR struct zipfs_point_s *point = NULL;
+  ssize_t ret;
+  int i;
+
+  if (offset < 0)
+    {
+      return -EINVAL;
+    }
+
+  if (idx->method != Z_DEFLATED)
+    {
+      return offset < idx->usize ? offset : idx->usize;
+    }
+
+  /* Restart from the nearest checkpoint at or before the target if the
+   * target lies behind the current position or the checkpoint is ahead
+   * of it.
+   */
+
+  for (i = idx->npoints - 1; i >= 0; i--)
+    {
+      if (idx->points[i].out <= offset)
+        {
+          point = &idx->points[i];
+          break;
+        }
+    }
+
+  if (offset < idx->out || (point != NULL && point->out > idx->out))
+    {
+      ret = zipfs_index_restore(idx, point);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (fp->seekbuf == NULL)
+    {
+      fp->seekbuf = fs_heap_malloc(CONFIG_ZIPFS_SEEK_BUFSIZE);
+      if (fp->seekbuf == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  while (idx->out < offset)
+    {
+      off_t remain = offset - idx->out;
+
+      if (remain > CONFIG_ZIPFS_SEEK_BUFSIZE)
+        {
+          remain = CONFIG_ZIPFS_SEEK_BUFSIZE;
+        }
+
+      ret = zipfs_index_inflate(idx, fp->seekbuf, remain);
+      if (ret <= 0)
+        {
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+    }
+
+  return idx->out;
+}
+#endif
+
 static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
                       int oflags, mode_t mode)
 {
@@ -271,13 +894,21 @@ static int zipfs_open(FAR struct file *filep, FAR const char *relpath,
       goto err_with_mutex;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(fp->uf, relpath, 0));
+  ret = zipfs_locate(fs, fp->uf, relpath);
   if (ret < 0)
     {
       goto err_with_zip;
     }
 
-  ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  fp->index = NULL;
+  ret = zipfs_index_open(fs, fp);
+  if (ret == -ENOSYS)
+#endif
+    {
+      ret = zipfs_convert_result(unzOpenCurrentFile(fp->uf));
+    }
+
   if (ret < 0)
     {
       goto err_with_zip;
@@ -307,6 +938,13 @@ static int zipfs_close(FAR struct file *filep)
   FAR struct zipfs_file_s *fp = filep->f_priv;
   int ret;
 
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      zipfs_index_free(fp->index);
+    }
+#endif
+
   ret = zipfs_convert_result(unzClose(fp->uf));
   nxmutex_destroy(&fp->lock);
   fs_heap_free(fp->seekbuf);
@@ -321,7 +959,18 @@ static ssize_t zipfs_read(FAR struct file *filep, FAR char *buffer,
   ssize_t ret;
 
   nxmutex_lock(&fp->lock);
-  ret = zipfs_convert_result(unzReadCurrentFile(fp->uf, buffer, buflen));
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      ret = zipfs_index_read(filep, buffer, buflen);
+    }
+  else
+#endif
+    {
+      ret = unzReadCurrentFile(fp->uf, buffer, buflen);
+      ret = zipfs_convert_result(ret);
+    }
+
   if (ret > 0)
     {
       filep->f_pos += ret;
@@ -402,7 +1051,21 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
     {
       goto err_with_lock;
     }
-  else if (filep->f_pos > offset)
+
+#ifdef CONFIG_ZIPFS_SEEK_INDEX
+  if (fp->index != NULL)
+    {
+      ret = zipfs_index_seek(filep, offset);
+      if (ret >= 0)
+        {
+          filep->f_pos = ret;
+        }
+
+      goto err_with_lock;
+    }
+#endif
+
+  if (filep->f_pos > offset)
     {
       ret = zipfs_convert_result(unzClose(fp->uf));
       if (ret < 0)
@@ -417,7 +1080,7 @@ static off_t zipfs_seek(FAR struct file *filep, off_t offset,
           goto err_with_lock;
         }
 
-      ret = zipfs_convert_result(unzLocateFile(fp->uf, fp->relpath, 0));
+      ret = zipfs_locate(fs, fp->uf, fp->relpath);
       if (ret < 0)
         {
           goto err_with_lock;
@@ -603,6 +1266,10 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
       return -EINVAL;
     }
 
+#ifdef CONFIG_ZIPFS_DIRCACHE
+  zipfs_dircache_build(fs, uf);
+#endif
+
   unzClose(uf);
   strcpy(fs->abspath, data);
   *handle = fs;
@@ -613,6 +1280,12 @@ static int zipfs_bind(FAR struct inode *driver, FAR const void *data,
 static int zipfs_unbind(FAR void *handle, FAR struct inode **driver,
                         unsigned int flags)
 {
+#ifdef CONFIG_ZIPFS_DIRCACHE
+  FAR struct zipfs_mountpt_s *fs = handle;
+
+  fs_heap_free(fs->hash);
+#endif
+
   fs_heap_free(handle);
   return OK;
 }
@@ -648,7 +1321,7 @@ static int zipfs_stat(FAR struct inode *mountpt,
       return -EINVAL;
     }
 
-  ret = zipfs_convert_result(unzLocateFile(uf, relpath, 0));
+  ret = zipfs_locate(fs, uf, relpath);
   if (ret < 0)
     {
       unzClose(uf);
@@ -38,6 +38,14 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_attr.mq_flags bit honored by mq_open() when creating a
+ * message queue: store the messages in a lock-free ring of fixed size
+ * slots (FIFO order, the priority is only passed along).  Ignored unless
+ * CONFIG_MQ_RING is enabled.
+ */
+
+#define MQ_RING     (1 << 28)
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
@@ -52,6 +60,16 @@ struct mq_attr
   long    mq_curmsgs;   /* Number of messages currently in queue */
 };
 
+/* One message buffer of mq_receive_many() (non-standard) */
+
+struct mq_msgbuf
+{
+  FAR char     *msg;    /* Buffer to receive the message */
+  size_t        msglen; /* Size of the buffer in bytes */
+  size_t        len;    /* Returned: Length of the message */
+  unsigned int  prio;   /* Returned: Priority of the message */
+};
+
 /* Message queue descriptor */
 
 typedef int mqd_t;
@@ -84,6 +102,9 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
 ssize_t mq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                         FAR unsigned int *prio,
                         FAR const struct timespec *abstime);
+int     mq_receive_many(mqd_t mqdes, FAR struct mq_msgbuf *vec,
+                        unsigned int vlen,
+                        FAR const struct timespec *abstime);
 int     mq_notify(mqd_t mqdes, FAR const struct sigevent *notification);
 int     mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat,
                    FAR struct mq_attr *oldstat);
@@ -158,6 +158,9 @@ struct module_s
   char modname[LIBC_ELF_NAMEMAX];        /* Module name */
 #endif
   struct mod_info_s modinfo;           /* Module information */
+#ifdef CONFIG_SYMTAB_HASH
+  FAR struct symtab_hash_s *exphash;   /* Hash index of modinfo.exports */
+#endif
   FAR void *textalloc;                 /* Allocated kernel text memory */
   FAR void *dataalloc;                 /* Allocated kernel memory */
   uintptr_t xipbase;                   /* if elf is position independent, and use
@@ -213,6 +216,9 @@ struct mod_loadinfo_s
   size_t        textalign;   /* Necessary alignment of .text */
   size_t        dataalign;   /* Necessary alignment of .bss/.text */
   off_t         filelen;     /* Length of the entire module file */
+#ifdef CONFIG_LIBC_ELF_XIPREAD
+  uintptr_t     filebase;    /* Address of the file data if memory-resident */
+#endif
   uid_t         fileuid;     /* Uid of the file system */
   gid_t         filegid;     /* Gid of the file system */
   int           filemode;    /* Mode of the file system */
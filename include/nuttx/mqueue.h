@@ -94,10 +94,24 @@
 #  define MQ_WNELIST(cmn)             (&((cmn).waitfornotempty))
 #  define MQ_WNFLIST(cmn)             (&((cmn).waitfornotfull))
 
+/* Priority buckets: each bucket holds 2^CONFIG_MQ_PRIO_BUCKET_SHIFT
+ * adjacent message priorities.
+ */
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+#  define MQ_PRIO_NBUCKETS            (256 >> CONFIG_MQ_PRIO_BUCKET_SHIFT)
+#  define MQ_PRIO_MAPSIZE             ((MQ_PRIO_NBUCKETS + 31) >> 5)
+#  define MQ_PRIO_BUCKET(p)           ((p) >> CONFIG_MQ_PRIO_BUCKET_SHIFT)
+#endif
+
 /****************************************************************************
  * Public Type Declarations
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_RING
+struct mqueue_ring_s; /* Opaque, see sched/mqueue/mqueue.h */
+#endif
+
 /* Common prologue of all message queue structures. */
 
 struct mqueue_cmn_s
@@ -115,6 +129,15 @@ struct mqueue_inode_s
   struct mqueue_cmn_s cmn;    /* Common prologue */
   FAR struct inode *inode;    /* Containing inode */
   struct list_node msglist;   /* Prioritized message list */
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  /* Last message of each priority bucket and map of non-empty buckets */
+
+  FAR struct list_node *msgtail[MQ_PRIO_NBUCKETS];
+  uint32_t msgmap[MQ_PRIO_MAPSIZE];
+#endif
+#ifdef CONFIG_MQ_RING
+  FAR struct mqueue_ring_s *ring; /* Message ring if created with MQ_RING */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
 #if CONFIG_MQ_MAXMSGSIZE < 256
@@ -401,6 +424,25 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
 void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq);
 
+/****************************************************************************
+ * Name: nxmq_ring_count
+ *
+ * Description:
+ *   Return the number of messages in a message queue created with MQ_RING.
+ *   The value is a snapshot, it may change at any time.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   The number of messages in the ring.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MQ_RING
+int nxmq_ring_count(FAR struct mqueue_inode_s *msgq);
+#endif
+
 /****************************************************************************
  * Name: nxmq_alloc_msgq
  *
@@ -742,6 +784,84 @@ ssize_t file_mq_tickreceive(FAR struct file *mq, FAR char *msg,
                             size_t msglen, FAR unsigned int *prio,
                             clock_t ticks);
 
+/****************************************************************************
+ * Name: file_mq_timedreceive_ref and nxmq_timedreceive_ref
+ *
+ * Description:
+ *   Zero-copy variants of file_mq_timedreceive() and nxmq_timedreceive().
+ *   Instead of copying the message into a caller buffer, a reference to
+ *   the message data held by the message queue is returned in "msg".  The
+ *   reference must be released with file_mq_release_ref() once the data
+ *   has been consumed.  These are internal OS interfaces; the message data
+ *   is in kernel memory.
+ *
+ * Input Parameters:
+ *   mq/mqdes - Message Queue Descriptor
+ *   msg      - The location to return the reference to the message data
+ *   prio     - If not NULL, the location to store message priority.
+ *   abstime  - the absolute time to wait until a timeout is declared, or
+ *              NULL to wait forever.
+ *
+ * Returned Value:
+ *   On success, the length of the selected message in bytes is returned.
+ *   A negated errno value is returned on failure (see mq_timedreceive()
+ *   for the list valid return values).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_timedreceive_ref(FAR struct file *mq, FAR char **msg,
+                                 FAR unsigned int *prio,
+                                 FAR const struct timespec *abstime);
+ssize_t nxmq_timedreceive_ref(mqd_t mqdes, FAR char **msg,
+                              FAR unsigned int *prio,
+                              FAR const struct timespec *abstime);
+
+/****************************************************************************
+ * Name: file_mq_release_ref
+ *
+ * Description:
+ *   Release a message received with file_mq_timedreceive_ref() or
+ *   nxmq_timedreceive_ref().
+ *
+ * Input Parameters:
+ *   msg - The message data reference returned on receive
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void file_mq_release_ref(FAR char *msg);
+
+/****************************************************************************
+ * Name: file_mq_receive_many and nxmq_receive_many
+ *
+ * Description:
+ *   Internal OS versions of mq_receive_many(): receive up to vlen
+ *   messages, waiting (unless O_NONBLOCK is set) only until the first one
+ *   is available.  These are not cancellation points and do not modify
+ *   the errno value.
+ *
+ * Input Parameters:
+ *   mq/mqdes - Message Queue Descriptor
+ *   vec      - Array of message buffers
+ *   vlen     - Number of entries in vec
+ *   abstime  - the absolute time to wait until a timeout is declared, or
+ *              NULL to wait forever.
+ *
+ * Returned Value:
+ *   The number of messages received (at least one) on success.  A negated
+ *   errno value is returned on failure (see mq_timedreceive() for the list
+ *   valid return values).
+ *
+ ****************************************************************************/
+
+int file_mq_receive_many(FAR struct file *mq, FAR struct mq_msgbuf *vec,
+                         unsigned int vlen,
+                         FAR const struct timespec *abstime);
+int nxmq_receive_many(mqd_t mqdes, FAR struct mq_msgbuf *vec,
+                      unsigned int vlen, FAR const struct timespec *abstime);
+
 /****************************************************************************
  * Name:  file_mq_setattr
  *
@@ -449,6 +449,28 @@ struct net_driver_s
   struct iob_queue_s d_arpout;
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* TCP super-segments that have been split into MSS-sized segments and
+   * are waiting to be sent.
+   */
+
+  struct iob_queue_s d_gsoout;
+
+  /* Segment size of the TCP super-segment in d_iob, zero for a normal
+   * packet.  Set by the TCP send logic and consumed by tcp_gso_out().
+   */
+
+  uint16_t d_gsosize;
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  /* The TCP segment currently being coalesced by the receive offload.  It
+   * is flushed into the stack at the end of each receive poll batch.
+   */
+
+  FAR struct iob_s *d_gro;
+#endif
+
   /* The d_buf array is used to hold incoming and outgoing packets. The
    * device driver should place incoming data into this buffer.  When sending
    * data, the device driver should read the link level headers and the
@@ -1149,6 +1171,48 @@ void netdev_iob_release(FAR struct net_driver_s *dev);
 FAR struct iob_s *netdev_iob_clone(FAR struct net_driver_s *dev,
                                    bool throttled);
 
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Offer the packet in dev->d_iob to the generic receive offload.  In-order
+ *   TCP segments of the same flow are merged into one IOB chain held in
+ *   dev->d_gro; a segment that cannot be merged first flushes the held one
+ *   through the input callback.
+ *
+ * Input Parameters:
+ *   dev   - The network device that received the packet
+ *   input - The L2 input handler used to flush the coalesced segment
+ *
+ * Returned Value:
+ *   true if the packet was consumed (dev->d_iob has been taken away);
+ *   false if the caller must pass the packet to the stack itself.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GRO
+bool netdev_gro_receive(FAR struct net_driver_s *dev,
+                        CODE void (*input)(FAR struct net_driver_s *dev));
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the coalesced segment held in dev->d_gro (if any) to the input
+ *   callback.  Must be called at the end of every receive poll batch.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev));
+#endif
+
 /****************************************************************************
  * Name: netdev_ipv6_add/del
  *
@@ -72,11 +72,16 @@
 #define TCP_OPT_WS        3   /* Window size scaling factor */
 #define TCP_OPT_SACK_PERM 4   /* Selective-ACK Permitted option */
 #define TCP_OPT_SACK      5   /* Selective-ACK Block option */
+#define TCP_OPT_TS        8   /* Timestamps option (RFC 7323) */
 
 #define TCP_OPT_NOOP_LEN       1   /* Length of TCP NOOP option. */
 #define TCP_OPT_MSS_LEN        4   /* Length of TCP MSS option. */
 #define TCP_OPT_WS_LEN         3   /* Length of TCP WS option. */
 #define TCP_OPT_SACK_PERM_LEN  2   /* Length of TCP SACK option. */
+#define TCP_OPT_TS_LEN         10  /* Length of TCP Timestamps option. */
+#define TCP_OPT_TS_ALIGNED_LEN 12  /* Timestamps option padded by 2 NOOPs */
+
+#define TCP_OPT_MAX_LEN        40  /* Maximum length of all TCP options */
 
 /* The TCP states used in the struct tcp_conn_s tcpstateflags field */
 
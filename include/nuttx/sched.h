@@ -120,6 +120,13 @@
 #define GROUP_FLAG_FD_BACKTRACE    (1 << 4)                      /* Bit 4: Enable FD backtrace for the group */
                                                                  /* Bits 5-7: Available */
 
+/* Pressure stall states passed to nxsched_notify_pressure() */
+
+#define PRESSURE_CPU_SOME          (1 << 0)                      /* Bit 0: A task waits for a CPU */
+#define PRESSURE_CPU_FULL          (1 << 1)                      /* Bit 1: Not accounted */
+#define PRESSURE_IO_SOME           (1 << 2)                      /* Bit 2: A task waits for I/O */
+#define PRESSURE_IO_FULL           (1 << 3)                      /* Bit 3: ... and none is running */
+
 /* Values for struct child_status_s ch_flags */
 
 #define CHILD_FLAG_TTYPE_SHIFT     (0)                           /* Bits 0-1: child thread type */
@@ -409,6 +416,22 @@ struct stackinfo_s
                                          /* from the stack.                  */
 };
 
+/* struct schedlat_s ********************************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+
+/* Wakeup latency histogram.  count[0] counts the latencies below 1 us,
+ * count[n] those from 2^(n-1) up to 2^n us.  The last bucket also counts
+ * all longer latencies.
+ */
+
+struct schedlat_s
+{
+  uint32_t count[CONFIG_SCHED_LATENCY_NBUCKETS];
+  uint32_t max;                          /* Longest latency in us           */
+};
+#endif
+
 /* struct task_join_s *******************************************************/
 
 /* Used to save task join information */
@@ -684,6 +707,17 @@ struct tcb_s
   clock_t ticks;                         /* Number of ticks on this thread  */
 #endif
 
+#ifdef CONFIG_SCHED_PRESSURE
+  bool iowait;                           /* Thread is waiting for I/O       */
+#endif
+
+  /* Scheduling latency support *********************************************/
+
+#ifdef CONFIG_SCHED_LATENCY
+  clock_t readytime;                     /* Time when made ready-to-run     */
+  struct schedlat_s latency;             /* Wakeup latency histogram        */
+#endif
+
   /* Pre-emption monitor support ********************************************/
 
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_THREAD >= 0
@@ -839,6 +873,12 @@ EXTERN clock_t g_busywait_max[CONFIG_SMP_NCPUS];
 EXTERN clock_t g_busywait_total[CONFIG_SMP_NCPUS];
 #endif /* CONFIG_SCHED_CRITMONITOR_MAXTIME_BUSYWAIT >= 0 */
 
+/* Wakeup latency histograms of the threads run by each CPU */
+
+#ifdef CONFIG_SCHED_LATENCY
+EXTERN struct schedlat_s g_cpu_schedlat[CONFIG_SMP_NCPUS];
+#endif
+
 /* g_running_tasks[] holds a references to the running task for each CPU.
  * It is valid only when up_interrupt_context() returns true.
  */
@@ -1820,6 +1860,47 @@ void nxsched_sleep(unsigned int sec);
 int nxsched_nanosleep(FAR const struct timespec *rqtp,
                       FAR struct timespec *rmtp);
 
+#ifdef CONFIG_SCHED_PRESSURE
+/****************************************************************************
+ * Name: nxsched_iowait_begin
+ *
+ * Description:
+ *   Mark the calling thread as waiting for I/O, so that the time it spends
+ *   blocked is accounted as I/O pressure.  File systems and block drivers
+ *   bracket operations that may wait for the hardware with
+ *   nxsched_iowait_begin() and nxsched_iowait_end().  Nested calls are
+ *   only accounted once.
+ *
+ * Returned Value:
+ *   The value to be passed to nxsched_iowait_end().
+ *
+ ****************************************************************************/
+
+bool nxsched_iowait_begin(void);
+
+/****************************************************************************
+ * Name: nxsched_iowait_end
+ *
+ * Description:
+ *   End the I/O wait started by nxsched_iowait_begin().
+ *
+ * Input Parameters:
+ *   begun - The value returned by the matching nxsched_iowait_begin().
+ *
+ ****************************************************************************/
+
+void nxsched_iowait_end(bool begun);
+#else
+#  define nxsched_iowait_begin() false
+#  define nxsched_iowait_end(begun) UNUSED(begun)
+#endif
+
+/* Functions contained in fs_procfspressure.c *******************************/
+
+#ifdef CONFIG_SCHED_PRESSURE
+void nxsched_notify_pressure(uint32_t elapsed, unsigned int stalled);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
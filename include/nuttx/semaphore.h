@@ -42,10 +42,10 @@
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, holder, hhead */
 
 #    define NXSEM_INITIALIZER(c, f) \
-       {{(c)}, (f), SEM_WAITLIST_INITIALIZER, NULL}
+       {{(c)}, (f), SEM_WAITLIST_INITIALIZER, SEMHOLDER_INITIALIZER, NULL}
 #  else
 /* semcount, flags, waitlist, holder[2] */
 
@@ -233,6 +233,27 @@ int nxsem_wait_slow(FAR sem_t *sem);
 int nxsem_trywait(FAR sem_t *sem);
 int nxsem_trywait_slow(FAR sem_t *sem);
 
+/****************************************************************************
+ * Name: nxsem_trywait_fast
+ *
+ * Description:
+ *   Try to take the semaphore with an atomic operation only, without ever
+ *   entering the kernel.  This is the fast path shared by nxsem_trywait()
+ *   and the timed waits.
+ *
+ * Input Parameters:
+ *   sem - the semaphore descriptor
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the semaphore was taken, -EAGAIN if it is not
+ *   available and -ENOTSUP if the semaphore uses a protocol that has to be
+ *   handled by the kernel (priority protection, or priority inheritance on
+ *   a counting semaphore).
+ *
+ ****************************************************************************/
+
+int nxsem_trywait_fast(FAR sem_t *sem);
+
 /****************************************************************************
  * Name: nxsem_timedwait
  *
@@ -280,7 +301,7 @@ int nxsem_trywait_slow(FAR sem_t *sem);
 int nxsem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime);
 
 /****************************************************************************
- * Name: nxsem_clockwait
+ * Name: nxsem_clockwait / nxsem_clockwait_slow
  *
  * Description:
  *   This function will lock the semaphore referenced by sem as in the
@@ -326,9 +347,11 @@ int nxsem_timedwait(FAR sem_t *sem, FAR const struct timespec *abstime);
 
 int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
                     FAR const struct timespec *abstime);
+int nxsem_clockwait_slow(FAR sem_t *sem, clockid_t clockid,
+                         FAR const struct timespec *abstime);
 
 /****************************************************************************
- * Name: nxsem_tickwait
+ * Name: nxsem_tickwait / nxsem_tickwait_slow
  *
  * Description:
  *   This function is a lighter weight version of sem_timedwait().  It is
@@ -351,6 +374,7 @@ int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
  ****************************************************************************/
 
 int nxsem_tickwait(FAR sem_t *sem, uint32_t delay);
+int nxsem_tickwait_slow(FAR sem_t *sem, uint32_t delay);
 
 /****************************************************************************
  * Name: nxsem_post / nxsem_post_slow
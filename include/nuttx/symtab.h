@@ -29,6 +29,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -57,6 +59,23 @@ struct symtab_s
   FAR const void *sym_value; /* The value associated with the string */
 };
 
+#ifdef CONFIG_SYMTAB_HASH
+/* struct symtab_hash_s is a hash index built over an existing symbol table
+ * by symtab_hashinit().  The index refers to, but does not own, the
+ * symbol table.  All arrays are carved out of the same allocation.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* Number of entries in symtab[] */
+  uint32_t mask;                     /* Number of buckets - 1 */
+  FAR uint32_t *hashes;              /* Hash value of each entry */
+  FAR int *buckets;                  /* First entry in each bucket or -1 */
+  FAR int *chain;                    /* Next entry in the same bucket or -1 */
+};
+#endif
+
 /****************************************************************************
  * Public Functions Definitions
  ****************************************************************************/
@@ -121,6 +140,68 @@ symtab_findbyvalue(FAR const struct symtab_s *symtab,
 
 void symtab_sortbyname(FAR struct symtab_s *symtab, int nsyms);
 
+#ifdef CONFIG_SYMTAB_HASH
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Compute the hash value of a symbol name for use with symtab_hashfind().
+ *
+ * Returned Value:
+ *   The hash value of the name.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hashname(FAR const char *name);
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index over the symbol table.  The symbol table must
+ *   remain valid and unmodified for as long as the index is in use.
+ *
+ * Returned Value:
+ *   The allocated index or NULL if the table is empty or on allocation
+ *   failure.
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *
+symtab_hashinit(FAR const struct symtab_s *symtab, int nsyms);
+
+/****************************************************************************
+ * Name: symtab_hashfree
+ *
+ * Description:
+ *   Free an index created by symtab_hashinit().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_hashfree(FAR struct symtab_hash_s *hash);
+
+/****************************************************************************
+ * Name: symtab_hashfind
+ *
+ * Description:
+ *   Find the symbol with the matching name using a hash index.  hashval is
+ *   the value returned by symtab_hashname() for the same name.  Access
+ *   time is constant on average.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hashfind(FAR const struct symtab_hash_s *hash,
+                FAR const char *name, uint32_t hashval);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -355,6 +355,60 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
                                              FAR void *stack_addr,
                                              int stack_size, int nthreads);
 
+/****************************************************************************
+ * Name: work_queue_create_pool
+ *
+ * Description:
+ *   Create a new work queue whose thread pool grows on demand.  The queue
+ *   starts with minthreads threads.  Whenever all threads are busy and one
+ *   of them has been running the same work for
+ *   CONFIG_WQUEUE_STALL_TIMEOUT milliseconds, another thread is started,
+ *   up to maxthreads, so that work that blocks doesn't hold up the rest of
+ *   the queue.  The threads started on
+ *   demand exit again after CONFIG_WQUEUE_IDLE_TIMEOUT milliseconds
+ *   without work.  The stacks are allocated from the heap.
+ *
+ * Input Parameters:
+ *   name       - Name of the new tasks
+ *   priority   - Priority of the new tasks
+ *   stack_size - size (in bytes) of the stack of each task
+ *   minthreads - Number of work threads created up front
+ *   maxthreads - Maximum number of work threads
+ *
+ * Returned Value:
+ *   The work queue handle returned on success.  Otherwise, NULL
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+FAR struct kwork_wqueue_s *work_queue_create_pool(FAR const char *name,
+                                                  int priority,
+                                                  int stack_size,
+                                                  int minthreads,
+                                                  int maxthreads);
+#endif
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Return the kernel work queue of a CPU.  Work queued on it runs on that
+ *   CPU, so work_queue_wq(work_queue_cpu(this_cpu()), ...) keeps the work
+ *   local to the submitting CPU.  The work has to be cancelled through the
+ *   same queue it was queued on.
+ *
+ * Input Parameters:
+ *   cpu - The CPU index
+ *
+ * Returned Value:
+ *   The work queue handle, NULL if the CPU work queues are not started.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUWORK
+FAR struct kwork_wqueue_s *work_queue_cpu(int cpu);
+#endif
+
 /****************************************************************************
  * Name: work_queue_free
  *
@@ -71,26 +71,29 @@ struct semholder_s
   FAR struct semholder_s *flink;  /* List of semaphore's holder            */
 #endif
   FAR struct semholder_s *tlink;  /* List of task held semaphores          */
+  FAR struct semholder_s *tprev;  /* Previous entry in the task's list     */
   FAR struct sem_s *sem;          /* The corresponding semaphore           */
   FAR struct tcb_s *htcb;         /* The corresponding TCB                 */
   int32_t counts;                 /* Number of counts owned by this holder */
 };
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, NULL, 0}
 #  define INITIALIZE_SEMHOLDER(h) \
     do { \
       (h)->flink  = NULL; \
       (h)->tlink  = NULL; \
+      (h)->tprev  = NULL; \
       (h)->sem    = NULL; \
       (h)->htcb   = NULL; \
       (h)->counts = 0; \
     } while (0)
 #else
-#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, 0}
+#  define SEMHOLDER_INITIALIZER   {NULL, NULL, NULL, NULL, 0}
 #  define INITIALIZE_SEMHOLDER(h) \
     do { \
       (h)->tlink  = NULL; \
+      (h)->tprev  = NULL; \
       (h)->sem    = NULL; \
       (h)->htcb   = NULL; \
       (h)->counts = 0; \
@@ -128,10 +131,9 @@ struct sem_s
 #endif
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
+  struct semholder_s holder;     /* Built-in holder, used by mutexes */
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *hhead; /* List of holders of semaphore counts */
-#  else
-  struct semholder_s holder;     /* Slot for old and new holder */
+  FAR struct semholder_s *hhead; /* List of further holders of counts */
 #  endif
 #endif
 #ifdef CONFIG_PRIORITY_PROTECT
@@ -146,10 +148,10 @@ typedef struct sem_s sem_t;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
 #  if CONFIG_SEM_PREALLOCHOLDERS > 0
-/* semcount, flags, waitlist, hhead */
+/* semcount, flags, waitlist, holder, hhead */
 
 #    define SEM_INITIALIZER(c) \
-       {{(c)}, 0, SEM_WAITLIST_INITIALIZER, NULL}
+       {{(c)}, 0, SEM_WAITLIST_INITIALIZER, SEMHOLDER_INITIALIZER, NULL}
 #  else
 /* semcount, flags, waitlist, holder[2] */
 
@@ -78,8 +78,8 @@ SYSCALL_LOOKUP(sethostname,                2)
 SYSCALL_LOOKUP(nxsem_destroy,              1)
 SYSCALL_LOOKUP(nxsem_post_slow,            1)
 SYSCALL_LOOKUP(nxsem_reset,                2)
-SYSCALL_LOOKUP(nxsem_tickwait,             2)
-SYSCALL_LOOKUP(nxsem_clockwait,            3)
+SYSCALL_LOOKUP(nxsem_tickwait_slow,        2)
+SYSCALL_LOOKUP(nxsem_clockwait_slow,       3)
 SYSCALL_LOOKUP(nxsem_timedwait,            2)
 SYSCALL_LOOKUP(nxsem_trywait_slow,         1)
 SYSCALL_LOOKUP(nxsem_wait_slow,            1)
@@ -340,6 +340,7 @@ SYSCALL_LOOKUP(munmap,                     2)
   SYSCALL_LOOKUP(mq_notify,                2)
   SYSCALL_LOOKUP(mq_open,                  4)
   SYSCALL_LOOKUP(mq_receive,               4)
+  SYSCALL_LOOKUP(mq_receive_many,          4)
   SYSCALL_LOOKUP(mq_send,                  4)
   SYSCALL_LOOKUP(mq_setattr,               3)
   SYSCALL_LOOKUP(mq_timedreceive,          5)
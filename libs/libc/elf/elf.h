@@ -115,6 +115,50 @@ int libelf_symvalue(FAR struct module_s *modp,
                     Elf_Off sh_offset,
                     FAR const struct symtab_s *exports, int nexports);
 
+/****************************************************************************
+ * Name: libelf_findmodsym
+ *
+ * Description:
+ *   Find a symbol exported by an installed module.  The caller must hold
+ *   the registry lock.
+ *
+ * Input Parameters:
+ *   modp    - The module whose exports are searched
+ *   name    - The name of the symbol to find
+ *   hashval - symtab_hashname(name) (unused without CONFIG_SYMTAB_HASH)
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if found; NULL otherwise.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findmodsym(FAR struct module_s *modp, FAR const char *name,
+                  uint32_t hashval);
+
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol in the base code symbol table.  When CONFIG_SYMTAB_HASH
+ *   is enabled, a hash index of the most recently used table is kept so
+ *   that each lookup takes constant time on average.
+ *
+ * Input Parameters:
+ *   exports  - Pointer to the symbol table
+ *   nexports - Number of symbols in the symbol table
+ *   name     - The name of the symbol to find
+ *   hashval  - symtab_hashname(name) (unused without CONFIG_SYMTAB_HASH)
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if found; NULL otherwise.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports, int nexports,
+                  FAR const char *name, uint32_t hashval);
+
 /****************************************************************************
  * Name: libelf_insertsymtab
  *
@@ -48,6 +48,11 @@
 #define I_PLT   1    /* ... for PLTs */
 #define N_RELS  2    /* Number of relxxx[] indexes */
 
+/* Number of hash buckets in the symbol cache (must be a power of two) */
+
+#define SYMCACHE_NBUCKETS 64
+#define SYMCACHE_BUCKET(i) ((i) & (SYMCACHE_NBUCKETS - 1))
+
 #ifdef ARCH_ELFDATA
 #  define ARCH_ELFDATA_DEF  arch_elfdata_t arch_data; \
                             memset(&arch_data, 0, sizeof(arch_elfdata_t))
@@ -65,13 +70,27 @@
  * with legacy naming of other ELF types.
  */
 
-typedef struct
+typedef struct elf_symcache_s
 {
-  dq_entry_t entry;
+  dq_entry_t entry;                    /* LRU list link */
+  FAR struct elf_symcache_s *hnext;    /* Next entry in the same bucket */
   Elf_Sym    sym;
   int        idx;
 } Elf_SymCache;
 
+/* Symbols resolved while binding one module.  All relocation sections of a
+ * module refer to the same symbol table, so the cache is shared by all of
+ * them and lookups are hashed by symbol table index rather than walking
+ * the LRU list.
+ */
+
+struct libelf_symcache_s
+{
+  dq_queue_t lru;                      /* Entries, most recently used first */
+  int        count;                    /* Number of entries allocated */
+  FAR Elf_SymCache *hash[SYMCACHE_NBUCKETS];
+};
+
 struct
 {
   int stroff;           /* offset to string table */
@@ -165,6 +184,142 @@ static inline int libelf_readrelas(FAR struct mod_loadinfo_s *loadinfo,
                      relsec->sh_offset + offset);
 }
 
+/****************************************************************************
+ * Name: libelf_symcache_get
+ *
+ * Description:
+ *   Return the symbol table entry at index symidx with its value resolved.
+ *   The entry is taken from the cache if present, otherwise it is read
+ *   from the file, resolved with libelf_symvalue() and added to the cache,
+ *   evicting the least recently used entry if the cache is full.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int libelf_symcache_get(FAR struct module_s *modp,
+                               FAR struct mod_loadinfo_s *loadinfo,
+                               FAR struct libelf_symcache_s *cache,
+                               int symidx,
+                               FAR const struct symtab_s *exports,
+                               int nexports, FAR Elf_Sym **sym)
+{
+  FAR Elf_SymCache **prev;
+  FAR Elf_SymCache *entry;
+  int ret;
+
+  /* First try the cache */
+
+  for (entry = cache->hash[SYMCACHE_BUCKET(symidx)]; entry != NULL;
+       entry = entry->hnext)
+    {
+      if (entry->idx == symidx)
+        {
+          dq_rem(&entry->entry, &cache->lru);
+          dq_addfirst(&entry->entry, &cache->lru);
+          *sym = &entry->sym;
+          return OK;
+        }
+    }
+
+  /* If the symbol was not found in the cache, we will need to read the
+   * symbol from the file.
+   */
+
+  if (cache->count < CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT)
+    {
+      entry = lib_malloc(sizeof(Elf_SymCache));
+      if (entry == NULL)
+        {
+          berr("Failed to allocate memory for elf symbols\n");
+          return -ENOMEM;
+        }
+
+      cache->count++;
+    }
+  else
+    {
+      /* Recycle the least recently used entry */
+
+      entry = (FAR Elf_SymCache *)dq_remlast(&cache->lru);
+
+      prev = &cache->hash[SYMCACHE_BUCKET(entry->idx)];
+      while (*prev != entry)
+        {
+          prev = &(*prev)->hnext;
+        }
+
+      *prev = entry->hnext;
+    }
+
+  /* Read the symbol table entry into memory */
+
+  ret = libelf_readsym(loadinfo, symidx, &entry->sym,
+                       &loadinfo->shdr[loadinfo->symtabidx]);
+  if (ret < 0)
+    {
+      goto errout_with_entry;
+    }
+
+  /* Get the value of the symbol (in sym.st_value) */
+
+  ret = libelf_symvalue(modp, loadinfo, &entry->sym,
+                        loadinfo->shdr[loadinfo->strtabidx].sh_offset,
+                        exports, nexports);
+  if (ret < 0)
+    {
+      /* The special error -ESRCH is returned only in one condition:
+       * The symbol has no name.
+       *
+       * There are a few relocations for a few architectures that do
+       * no depend upon a named symbol.  We don't know if that is the
+       * case here, but we will use a NULL symbol pointer to indicate
+       * that case to up_relocate().  That function can then do what
+       * is best.
+       */
+
+      if (ret != -ESRCH)
+        {
+          goto errout_with_entry;
+        }
+
+      berr("ERROR: Undefined symbol[%d] has no name\n", symidx);
+    }
+
+  entry->idx   = symidx;
+  entry->hnext = cache->hash[SYMCACHE_BUCKET(symidx)];
+  cache->hash[SYMCACHE_BUCKET(symidx)] = entry;
+  dq_addfirst(&entry->entry, &cache->lru);
+
+  *sym = &entry->sym;
+  return OK;
+
+errout_with_entry:
+  lib_free(entry);
+  cache->count--;
+  return ret;
+}
+
+/****************************************************************************
+ * Name: libelf_symcache_free
+ *
+ * Description:
+ *   Release all entries of the symbol cache.
+ *
+ ****************************************************************************/
+
+static void libelf_symcache_free(FAR struct libelf_symcache_s *cache)
+{
+  FAR dq_entry_t *e;
+
+  while ((e = dq_remfirst(&cache->lru)) != NULL)
+    {
+      lib_free(e);
+    }
+}
+
 /****************************************************************************
  * Name: libelf_relocate and libelf_relocateadd
  *
@@ -179,21 +334,18 @@ static inline int libelf_readrelas(FAR struct mod_loadinfo_s *loadinfo,
 
 static int libelf_relocate(FAR struct module_s *modp,
                            FAR struct mod_loadinfo_s *loadinfo, int relidx,
+                           FAR struct libelf_symcache_s *cache,
                            FAR const struct symtab_s *exports, int nexports)
 {
   FAR Elf_Shdr     *relsec = &loadinfo->shdr[relidx];
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rel      *rels;
   FAR Elf_Rel      *rel;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -207,14 +359,12 @@ static int libelf_relocate(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rel); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -239,94 +389,18 @@ static int libelf_relocate(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rel->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
+      /* Look up the symbol in the per-load cache.  On a miss it is read
+       * from the file and its value is resolved.
        */
 
-      if (sym == NULL)
+      ret = libelf_symcache_get(modp, loadinfo, cache, symidx, exports,
+                                nexports, &sym);
+      if (ret < 0)
         {
-          if (j < CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = libelf_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = libelf_symvalue(modp, loadinfo, sym,
-                  loadinfo->shdr[loadinfo->strtabidx].sh_offset,
-                  exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -418,11 +492,6 @@ static int libelf_relocate(FAR struct module_s *modp,
     }
 
   lib_free(rels);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
 
   return ret;
 }
@@ -430,6 +499,7 @@ static int libelf_relocate(FAR struct module_s *modp,
 static int libelf_relocateadd(FAR struct module_s *modp,
                               FAR struct mod_loadinfo_s *loadinfo,
                               int relidx,
+                              FAR struct libelf_symcache_s *cache,
                               FAR const struct symtab_s *exports,
                               int nexports)
 {
@@ -437,15 +507,11 @@ static int libelf_relocateadd(FAR struct module_s *modp,
   FAR Elf_Shdr     *dstsec = &loadinfo->shdr[relsec->sh_info];
   FAR Elf_Rela     *relas;
   FAR Elf_Rela     *rela;
-  FAR Elf_SymCache *cache;
   FAR Elf_Sym      *sym;
-  FAR dq_entry_t   *e;
-  dq_queue_t        q;
   uintptr_t         addr;
   int               symidx;
   int               ret = OK;
   int               i;
-  int               j;
 
   /* Define potential architecture specific elf data container */
 
@@ -459,14 +525,12 @@ static int libelf_relocateadd(FAR struct module_s *modp,
       return -ENOMEM;
     }
 
-  dq_init(&q);
-
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = j = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
+  for (i = 0; i < relsec->sh_size / sizeof(Elf_Rela); i++)
     {
       /* Read the relocation entry into memory */
 
@@ -491,94 +555,18 @@ static int libelf_relocateadd(FAR struct module_s *modp,
 
       symidx = ELF_R_SYM(rela->r_info);
 
-      /* First try the cache */
-
-      sym = NULL;
-      for (e = dq_peek(&q); e; e = dq_next(e))
-        {
-          cache = (FAR Elf_SymCache *)e;
-          if (cache->idx == symidx)
-            {
-              dq_rem(&cache->entry, &q);
-              dq_addfirst(&cache->entry, &q);
-              sym = &cache->sym;
-              break;
-            }
-        }
-
-      /* If the symbol was not found in the cache, we will need to read the
-       * symbol from the file.
+      /* Look up the symbol in the per-load cache.  On a miss it is read
+       * from the file and its value is resolved.
        */
 
-      if (sym == NULL)
+      ret = libelf_symcache_get(modp, loadinfo, cache, symidx, exports,
+                                nexports, &sym);
+      if (ret < 0)
         {
-          if (j < CONFIG_LIBC_ELF_SYMBOL_CACHECOUNT)
-            {
-              cache = lib_malloc(sizeof(Elf_SymCache));
-              if (!cache)
-                {
-                  berr("Failed to allocate memory for elf symbols\n");
-                  ret = -ENOMEM;
-                  break;
-                }
-
-              j++;
-            }
-          else
-            {
-              cache = (FAR Elf_SymCache *)dq_remlast(&q);
-            }
-
-          sym = &cache->sym;
-
-          /* Read the symbol table entry into memory */
-
-          ret = libelf_readsym(loadinfo, symidx, sym,
-                               &loadinfo->shdr[loadinfo->symtabidx]);
-          if (ret < 0)
-            {
-              berr("ERROR: Section %d reloc %d: "
-                   "Failed to read symbol[%d]: %d\n",
-                   relidx, i, symidx, ret);
-              lib_free(cache);
-              break;
-            }
-
-          /* Get the value of the symbol (in sym.st_value) */
-
-          ret = libelf_symvalue(modp, loadinfo, sym,
-                           loadinfo->shdr[loadinfo->strtabidx].sh_offset,
-                           exports, nexports);
-          if (ret < 0)
-            {
-              /* The special error -ESRCH is returned only in one condition:
-               * The symbol has no name.
-               *
-               * There are a few relocations for a few architectures that do
-               * no depend upon a named symbol.  We don't know if that is the
-               * case here, but we will use a NULL symbol pointer to indicate
-               * that case to up_relocate().  That function can then do what
-               * is best.
-               */
-
-              if (ret == -ESRCH)
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Undefined symbol[%d] has no name: %d\n",
-                       relidx, i, symidx, ret);
-                }
-              else
-                {
-                  berr("ERROR: Section %d reloc %d: "
-                       "Failed to get value of symbol[%d]: %d\n",
-                       relidx, i, symidx, ret);
-                  lib_free(cache);
-                  break;
-                }
-            }
-
-          cache->idx = symidx;
-          dq_addfirst(&cache->entry, &q);
+          berr("ERROR: Section %d reloc %d: "
+               "Failed to get symbol[%d]: %d\n",
+               relidx, i, symidx, ret);
+          break;
         }
 
       if (sym->st_shndx == SHN_UNDEF && sym->st_name == 0)
@@ -614,11 +602,6 @@ static int libelf_relocateadd(FAR struct module_s *modp,
     }
 
   lib_free(relas);
-  while ((e = dq_peek(&q)) != NULL)
-    {
-      dq_rem(e, &q);
-      lib_free(e);
-    }
 
   return ret;
 }
@@ -916,6 +899,7 @@ int libelf_bind(FAR struct module_s *modp,
                 FAR struct mod_loadinfo_s *loadinfo,
                 FAR const struct symtab_s *exports, int nexports)
 {
+  FAR struct libelf_symcache_s *cache;
   int ret;
   int i;
 
@@ -944,6 +928,18 @@ int libelf_bind(FAR struct module_s *modp,
       goto errout_with_addrenv;
     }
 
+  /* The symbol cache lives for the whole bind so that symbols referenced
+   * from several relocation sections are only read and resolved once.
+   */
+
+  cache = lib_zalloc(sizeof(struct libelf_symcache_s));
+  if (cache == NULL)
+    {
+      berr("Failed to allocate memory for elf symbol cache\n");
+      ret = -ENOMEM;
+      goto errout_with_addrenv;
+    }
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -992,7 +988,7 @@ int libelf_bind(FAR struct module_s *modp,
 
           if (ret < 0)
             {
-              goto errout_with_addrenv;
+              break;
             }
         }
       else
@@ -1019,7 +1015,8 @@ int libelf_bind(FAR struct module_s *modp,
                     continue;
                   }
 
-                ret = libelf_relocate(modp, loadinfo, i, exports, nexports);
+                ret = libelf_relocate(modp, loadinfo, i, cache,
+                                      exports, nexports);
                 break;
               case SHT_RELA:
                 if ((loadinfo->shdr[infosec].sh_flags & SHF_ALLOC) == 0)
@@ -1027,8 +1024,8 @@ int libelf_bind(FAR struct module_s *modp,
                     continue;
                   }
 
-                ret = libelf_relocateadd(modp, loadinfo, i, exports,
-                                         nexports);
+                ret = libelf_relocateadd(modp, loadinfo, i, cache,
+                                         exports, nexports);
                 break;
               case SHT_INIT_ARRAY:
                 loadinfo->initarr = loadinfo->shdr[i].sh_addr;
@@ -1045,10 +1042,18 @@ int libelf_bind(FAR struct module_s *modp,
 
       if (ret < 0)
         {
-          goto errout_with_addrenv;
+          break;
         }
     }
 
+  libelf_symcache_free(cache);
+  lib_free(cache);
+
+  if (ret < 0)
+    {
+      goto errout_with_addrenv;
+    }
+
   modp->xipbase = loadinfo->xipbase;
 
   /* Ensure that the I and D caches are coherent before starting the newly
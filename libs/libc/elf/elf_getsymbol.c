@@ -30,6 +30,8 @@
 #include <nuttx/lib/elf.h>
 #include <nuttx/symtab.h>
 
+#include "elf/elf.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -93,8 +95,11 @@ FAR const void *libelf_getsymbol(FAR void *handle, FAR const char *name)
 
   /* Search the symbol table for the matching symbol */
 
-  symbol = symtab_findbyname(modp->modinfo.exports, name,
-                             modp->modinfo.nexports);
+#ifdef CONFIG_SYMTAB_HASH
+  symbol = libelf_findmodsym(modp, name, symtab_hashname(name));
+#else
+  symbol = libelf_findmodsym(modp, name, 0);
+#endif
 
   libelf_registry_unlock();
   if (symbol == NULL)
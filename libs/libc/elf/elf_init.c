@@ -26,8 +26,10 @@
 
 #include <nuttx/config.h>
 
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 
+#include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
 #include <fcntl.h>
@@ -35,6 +37,7 @@
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/lib/elf.h>
 
 #include "elf/elf.h"
@@ -126,6 +129,22 @@ int libelf_initialize(FAR const char *filename,
       return ret;
     }
 
+#ifdef CONFIG_LIBC_ELF_XIPREAD
+  /* If the file data is directly addressable, libelf_read() can copy from
+   * memory rather than going through the file system for every access.
+   */
+
+  if (ioctl(loadinfo->filfd, FIOC_XIPBASE,
+            (unsigned long)&loadinfo->filebase) < 0)
+    {
+      loadinfo->filebase = 0;
+    }
+  else
+    {
+      binfo("File data at %" PRIxPTR "\n", loadinfo->filebase);
+    }
+#endif
+
   /* Read the ELF ehdr from offset 0 */
 
   ret = libelf_read(loadinfo, (FAR uint8_t *)&loadinfo->ehdr,
@@ -84,6 +84,25 @@ int libelf_read(FAR struct mod_loadinfo_s *loadinfo, FAR uint8_t *buffer,
 
   binfo("Read %zu bytes from offset %" PRIdOFF "\n", readsize, offset);
 
+#ifdef CONFIG_LIBC_ELF_XIPREAD
+  /* If the file data is memory-resident, just copy it */
+
+  if (loadinfo->filebase != 0)
+    {
+      if (offset < 0 || offset > loadinfo->filelen ||
+          readsize > loadinfo->filelen - offset)
+        {
+          berr("ERROR: Unexpected end of file\n");
+          return -ENODATA;
+        }
+
+      memcpy(buffer, (FAR const void *)(loadinfo->filebase + offset),
+             readsize);
+      libelf_dumpreaddata(buffer, readsize);
+      return OK;
+    }
+#endif
+
   /* Loop until all of the requested data has been read. */
 
   /* Seek to the read position */
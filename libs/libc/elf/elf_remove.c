@@ -30,6 +30,7 @@
 #include <nuttx/arch.h>
 #include <nuttx/lib/lib.h>
 #include <nuttx/lib/elf.h>
+#include <nuttx/symtab.h>
 
 /****************************************************************************
  * Public Functions
@@ -93,6 +94,13 @@ int libelf_uninit(FAR struct module_s *modp)
 #endif
     }
 
+#ifdef CONFIG_SYMTAB_HASH
+  /* Drop the export index, the exports may not outlive the module */
+
+  symtab_hashfree(modp->exphash);
+  modp->exphash = NULL;
+#endif
+
   /* Release resources held by the module */
 
   if (modp->textalloc != NULL || modp->dataalloc != NULL)
@@ -55,6 +55,7 @@
 struct mod_exportinfo_s
 {
   FAR const char *name;              /* Symbol name to find */
+  uint32_t hashval;                  /* symtab_hashname(name) */
   FAR struct module_s *modp;         /* The module that needs the symbol */
   FAR const struct symtab_s *symbol; /* Symbol info returned (if found) */
 };
@@ -124,6 +125,46 @@ static int libelf_symname(FAR struct mod_loadinfo_s *loadinfo,
 
   offset = sh_offset + sym->st_name;
 
+#ifdef CONFIG_LIBC_ELF_XIPREAD
+  /* If the file data is memory-resident, the length of the name is known
+   * up front and the name can be copied in one go.
+   */
+
+  if (loadinfo->filebase != 0)
+    {
+      FAR const char *name;
+      size_t namelen;
+
+      if (offset >= loadinfo->filelen)
+        {
+          berr("ERROR: At end of file\n");
+          return -EINVAL;
+        }
+
+      name    = (FAR const char *)(loadinfo->filebase + offset);
+      namelen = strnlen(name, loadinfo->filelen - offset);
+      if (namelen == loadinfo->filelen - offset)
+        {
+          berr("ERROR: Unterminated symbol name\n");
+          return -EINVAL;
+        }
+
+      if (namelen >= loadinfo->buflen)
+        {
+          ret = libelf_reallocbuffer(loadinfo,
+                                     namelen + 1 - loadinfo->buflen);
+          if (ret < 0)
+            {
+              berr("ERROR: mod_reallocbuffer failed: %d\n", ret);
+              return ret;
+            }
+        }
+
+      memcpy(loadinfo->iobuffer, name, namelen + 1);
+      return OK;
+    }
+#endif
+
   /* Loop until we get the entire symbol name into memory */
 
   bytesread = 0;
@@ -203,9 +244,8 @@ static int libelf_symcallback(FAR struct module_s *modp, FAR void *arg)
 
   /* Check if this module exports a symbol of that name */
 
-  exportinfo->symbol = symtab_findbyname(modp->modinfo.exports,
-                                         exportinfo->name,
-                                         modp->modinfo.nexports);
+  exportinfo->symbol = libelf_findmodsym(modp, exportinfo->name,
+                                         exportinfo->hashval);
 
   if (exportinfo->symbol != NULL)
     {
@@ -310,6 +350,53 @@ int libelf_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
   return libelf_read(loadinfo, (FAR uint8_t *)sym, sizeof(Elf_Sym), offset);
 }
 
+/****************************************************************************
+ * Name: libelf_findmodsym
+ *
+ * Description:
+ *   Find a symbol exported by an installed module.  The caller must hold
+ *   the registry lock.
+ *
+ * Input Parameters:
+ *   modp    - The module whose exports are searched
+ *   name    - The name of the symbol to find
+ *   hashval - symtab_hashname(name) (unused without CONFIG_SYMTAB_HASH)
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if found; NULL otherwise.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findmodsym(FAR struct module_s *modp, FAR const char *name,
+                  uint32_t hashval)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  /* The exports may have been provided by the module initializer rather
+   * than by libelf_insertsymtab(), so the index is built on first use and
+   * rebuilt if the table has changed since.
+   */
+
+  if (modp->modinfo.exports != NULL &&
+      (modp->exphash == NULL ||
+       modp->exphash->symtab != modp->modinfo.exports ||
+       modp->exphash->nsyms != modp->modinfo.nexports))
+    {
+      symtab_hashfree(modp->exphash);
+      modp->exphash = symtab_hashinit(modp->modinfo.exports,
+                                      modp->modinfo.nexports);
+    }
+
+  if (modp->exphash != NULL)
+    {
+      return symtab_hashfind(modp->exphash, name, hashval);
+    }
+#endif
+
+  return symtab_findbyname(modp->modinfo.exports, name,
+                           modp->modinfo.nexports);
+}
+
 /****************************************************************************
  * Name: libelf_symvalue
  *
@@ -391,6 +478,11 @@ int libelf_symvalue(FAR struct module_s *modp,
         exportinfo.name   = (FAR const char *)loadinfo->iobuffer;
         exportinfo.modp   = modp;
         exportinfo.symbol = NULL;
+#ifdef CONFIG_SYMTAB_HASH
+        exportinfo.hashval = symtab_hashname(exportinfo.name);
+#else
+        exportinfo.hashval = 0;
+#endif
 
         ret = libelf_registry_foreach(libelf_symcallback,
                                       (FAR void *)&exportinfo);
@@ -408,8 +500,8 @@ int libelf_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
-            symbol = symtab_findbyname(exports, exportinfo.name,
-                                       nexports);
+            symbol = libelf_findexport(exports, nexports, exportinfo.name,
+                                       exportinfo.hashval);
           }
 
         /* Was the symbol found from any exporter? */
@@ -639,4 +731,9 @@ void libelf_freesymtab(FAR struct module_s *modp)
 
       lib_free((FAR void *)symbol);
     }
+
+#ifdef CONFIG_SYMTAB_HASH
+  symtab_hashfree(modp->exphash);
+  modp->exphash = NULL;
+#endif
 }
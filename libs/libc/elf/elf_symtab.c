@@ -31,6 +31,8 @@
 #include <nuttx/symtab.h>
 #include <nuttx/lib/elf.h>
 
+#include "elf/elf.h"
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -65,6 +67,12 @@ extern int CONFIG_LIBC_ELF_NSYMBOLS_VAR;
 static FAR const struct symtab_s *g_libelf_symtab;
 static int g_libelf_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASH
+/* Hash index of the most recently searched base code symbol table */
+
+static FAR struct symtab_hash_s *g_libelf_symhash;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -127,5 +135,71 @@ void libelf_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
   libelf_registry_lock();
   g_libelf_symtab   = symtab;
   g_libelf_nsymbols = nsymbols;
+
+#ifdef CONFIG_SYMTAB_HASH
+  /* The table may have been rewritten in place, discard the old index */
+
+  symtab_hashfree(g_libelf_symhash);
+  g_libelf_symhash  = NULL;
+#endif
+
+  libelf_registry_unlock();
+}
+
+/****************************************************************************
+ * Name: libelf_findexport
+ *
+ * Description:
+ *   Find a symbol in the base code symbol table.  When CONFIG_SYMTAB_HASH
+ *   is enabled, a hash index of the most recently used table is kept so
+ *   that each lookup takes constant time on average.
+ *
+ * Input Parameters:
+ *   exports  - Pointer to the symbol table
+ *   nexports - Number of symbols in the symbol table
+ *   name     - The name of the symbol to find
+ *   hashval  - symtab_hashname(name) (unused without CONFIG_SYMTAB_HASH)
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if found; NULL otherwise.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+libelf_findexport(FAR const struct symtab_s *exports, int nexports,
+                  FAR const char *name, uint32_t hashval)
+{
+#ifdef CONFIG_SYMTAB_HASH
+  FAR const struct symtab_s *symbol = NULL;
+
+  if (exports == NULL || nexports <= 0)
+    {
+      return NULL;
+    }
+
+  libelf_registry_lock();
+
+  /* (Re-)build the index if the caller is using a different table */
+
+  if (g_libelf_symhash == NULL ||
+      g_libelf_symhash->symtab != exports ||
+      g_libelf_symhash->nsyms != nexports)
+    {
+      symtab_hashfree(g_libelf_symhash);
+      g_libelf_symhash = symtab_hashinit(exports, nexports);
+    }
+
+  if (g_libelf_symhash != NULL)
+    {
+      symbol = symtab_hashfind(g_libelf_symhash, name, hashval);
+      libelf_registry_unlock();
+      return symbol;
+    }
+
   libelf_registry_unlock();
+#endif
+
+  /* No index (or no memory for one), fall back to the plain search */
+
+  return symtab_findbyname(exports, name, nexports);
 }
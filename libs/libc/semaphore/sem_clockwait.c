@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <time.h>
+#include <assert.h>
 #include <errno.h>
 
 #include <nuttx/cancelpt.h>
@@ -104,3 +105,48 @@ int sem_clockwait(FAR sem_t *sem, clockid_t clockid,
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxsem_clockwait
+ *
+ * Description:
+ *   This function will lock the semaphore referenced by sem as in the
+ *   sem_wait() function. However, if the semaphore cannot be locked without
+ *   waiting for another process or thread to unlock the semaphore by
+ *   performing a sem_post() function, this wait will be terminated when the
+ *   specified timeout expires.
+ *
+ *   An available semaphore is taken without entering the kernel, only the
+ *   contended case is passed to nxsem_clockwait_slow().
+ *
+ *   This is an internal OS interface.  It is functionally equivalent to
+ *   sem_clockwait except that:
+ *
+ *   - It is not a cancellation point, and
+ *   - It does not modify the errno value.
+ *
+ * Input Parameters:
+ *   sem     - Semaphore object
+ *   clockid - The timing source to use in the conversion
+ *   abstime - The absolute time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *   See nxsem_clockwait_slow() for the possible errors.
+ *
+ ****************************************************************************/
+
+int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
+                    FAR const struct timespec *abstime)
+{
+  DEBUGASSERT(sem != NULL && abstime != NULL);
+
+  if (nxsem_trywait_fast(sem) == OK)
+    {
+      return OK;
+    }
+
+  return nxsem_clockwait_slow(sem, clockid, abstime);
+}
@@ -84,41 +84,29 @@ int sem_trywait(FAR sem_t *sem)
 }
 
 /****************************************************************************
- * Name: nxsem_trywait
+ * Name: nxsem_trywait_fast
  *
  * Description:
- *   This function locks the specified semaphore only if the semaphore is
- *   currently not locked.  In either case, the call returns without
- *   blocking.
+ *   Try to take the semaphore with an atomic operation only, without
+ *   entering the kernel.
  *
  * Input Parameters:
  *   sem - the semaphore descriptor
  *
  * Returned Value:
- *   This is an internal OS interface and should not be used by applications.
- *   It follows the NuttX internal error return policy:  Zero (OK) is
- *   returned on success.  A negated errno value is returned on failure.
- *   Possible returned errors:
+ *   Zero (OK) is returned if the semaphore was taken.  Otherwise:
  *
- *     - EINVAL - Invalid attempt to get the semaphore
- *     - EAGAIN - The semaphore is not available.
+ *     - EAGAIN  - The semaphore is not available.
+ *     - ENOTSUP - The semaphore has to be taken by the kernel.
  *
  ****************************************************************************/
 
-int nxsem_trywait(FAR sem_t *sem)
+int nxsem_trywait_fast(FAR sem_t *sem)
 {
-  bool fastpath = true;
   bool mutex;
 
   DEBUGASSERT(sem != NULL);
 
-  /* This API should not be called from the idleloop or interrupt */
-
-#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
-  DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
-              up_interrupt_context());
-#endif
-
   mutex = NXSEM_IS_MUTEX(sem);
 
   /* Disable fast path if priority protection is enabled on the semaphore */
@@ -126,7 +114,7 @@ int nxsem_trywait(FAR sem_t *sem)
 #ifdef CONFIG_PRIORITY_PROTECT
   if ((sem->flags & SEM_PRIO_MASK) == SEM_PRIO_PROTECT)
     {
-      fastpath = false;
+      return -ENOTSUP;
     }
 #endif
 
@@ -135,11 +123,11 @@ int nxsem_trywait(FAR sem_t *sem)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   if (!mutex && (sem->flags & SEM_PRIO_MASK) != SEM_PRIO_NONE)
     {
-      fastpath = false;
+      return -ENOTSUP;
     }
 #endif
 
-  while (fastpath)
+  for (; ; )
     {
       FAR atomic_t *val = mutex ? NXSEM_MHOLDER(sem) : NXSEM_COUNT(sem);
       int32_t old = atomic_read(val);
@@ -169,6 +157,48 @@ int nxsem_trywait(FAR sem_t *sem)
           return OK;
         }
     }
+}
+
+/****************************************************************************
+ * Name: nxsem_trywait
+ *
+ * Description:
+ *   This function locks the specified semaphore only if the semaphore is
+ *   currently not locked.  In either case, the call returns without
+ *   blocking.
+ *
+ * Input Parameters:
+ *   sem - the semaphore descriptor
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *   Possible returned errors:
+ *
+ *     - EINVAL - Invalid attempt to get the semaphore
+ *     - EAGAIN - The semaphore is not available.
+ *
+ ****************************************************************************/
+
+int nxsem_trywait(FAR sem_t *sem)
+{
+  int ret;
+
+  DEBUGASSERT(sem != NULL);
+
+  /* This API should not be called from the idleloop or interrupt */
+
+#if defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__)
+  DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
+              up_interrupt_context());
+#endif
+
+  ret = nxsem_trywait_fast(sem);
+  if (ret == -ENOTSUP)
+    {
+      ret = nxsem_trywait_slow(sem);
+    }
 
-  return nxsem_trywait_slow(sem);
+  return ret;
 }
@@ -0,0 +1,219 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashstr
+ *
+ * Description:
+ *   The hash function used by the GNU .gnu.hash section (h * 33 + c,
+ *   seeded with 5381).  It is cheap and distributes C identifiers well.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hashstr(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Compute the hash value of a symbol name as it will be looked up with
+ *   symtab_hashfind().  The value can be computed once and then used to
+ *   search any number of hashed symbol tables.
+ *
+ * Returned Value:
+ *   The hash value of the name.
+ *
+ ****************************************************************************/
+
+uint32_t symtab_hashname(FAR const char *name)
+{
+  DEBUGASSERT(name != NULL);
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  return symtab_hashstr(name);
+}
+
+/****************************************************************************
+ * Name: symtab_hashinit
+ *
+ * Description:
+ *   Build a hash index over an existing symbol table.  The symbol table
+ *   itself is not modified or copied and must remain valid for as long as
+ *   the index is in use.
+ *
+ * Returned Value:
+ *   The allocated index on success; NULL if the table is empty or if the
+ *   index could not be allocated.  In either case the caller should fall
+ *   back to symtab_findbyname().
+ *
+ ****************************************************************************/
+
+FAR struct symtab_hash_s *
+symtab_hashinit(FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR struct symtab_hash_s *hash;
+  uint32_t nbuckets;
+  uint32_t bucket;
+  int i;
+
+  if (symtab == NULL || nsyms <= 0)
+    {
+      return NULL;
+    }
+
+  /* Use a power of two number of buckets with a load factor of at most
+   * one so that selecting the bucket is just a mask.
+   */
+
+  nbuckets = 1;
+  while (nbuckets < (uint32_t)nsyms)
+    {
+      nbuckets <<= 1;
+    }
+
+  hash = lib_malloc(sizeof(struct symtab_hash_s) +
+                    nbuckets * sizeof(int) +
+                    nsyms * (sizeof(int) + sizeof(uint32_t)));
+  if (hash == NULL)
+    {
+      return NULL;
+    }
+
+  hash->symtab   = symtab;
+  hash->nsyms    = nsyms;
+  hash->mask     = nbuckets - 1;
+  hash->hashes   = (FAR uint32_t *)(hash + 1);
+  hash->buckets  = (FAR int *)&hash->hashes[nsyms];
+  hash->chain    = &hash->buckets[nbuckets];
+
+  memset(hash->buckets, 0xff, nbuckets * sizeof(int));
+
+  /* Insert from the end of the table so that, if a name appears more than
+   * once, the chain yields the lowest index first just as the linear
+   * search in symtab_findbyname() would.
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      hash->hashes[i]       = symtab_hashstr(symtab[i].sym_name);
+      bucket                = hash->hashes[i] & hash->mask;
+      hash->chain[i]        = hash->buckets[bucket];
+      hash->buckets[bucket] = i;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: symtab_hashfree
+ *
+ * Description:
+ *   Free an index previously created by symtab_hashinit().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void symtab_hashfree(FAR struct symtab_hash_s *hash)
+{
+  lib_free(hash);
+}
+
+/****************************************************************************
+ * Name: symtab_hashfind
+ *
+ * Description:
+ *   Find the symbol with the matching name using a hash index.  hashval
+ *   must be the value returned by symtab_hashname() for the same name.
+ *   Only entries whose full hash value matches are compared with strcmp().
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_hashfind(FAR const struct symtab_hash_s *hash,
+                FAR const char *name, uint32_t hashval)
+{
+  int i;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+#ifdef CONFIG_SYMTAB_DECORATED
+  if (name[0] == '_')
+    {
+      name++;
+    }
+#endif
+
+  for (i = hash->buckets[hashval & hash->mask]; i >= 0; i = hash->chain[i])
+    {
+      if (hash->hashes[i] == hashval &&
+          strcmp(name, hash->symtab[i].sym_name) == 0)
+        {
+          return &hash->symtab[i];
+        }
+    }
+
+  return NULL;
+}
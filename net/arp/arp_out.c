@@ -298,6 +298,9 @@ void arp_out(FAR struct net_driver_s *dev)
        * the IP packet with an ARP request.
        */
 
+#ifdef CONFIG_NET_TCP_GSO
+      dev->d_gsosize = 0;
+#endif
       arp_format(dev, ipaddr);
       arp_dump(ARPBUF);
       return;
@@ -74,7 +74,14 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
+#  ifdef CONFIG_NET_TCP_GSO
+  /* TCP super-segments are split to the MTU before they are sent */
+
+  if (dev->d_gsosize == 0 &&
+      len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+#  else
   if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+#  endif
     {
       ret = -EMSGSIZE;
       goto errout;
@@ -707,7 +707,8 @@ devif_poll_tcp_connections(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_ARP_SEND_QUEUE) || defined(CONFIG_NET_IPFRAG)
+#if defined(CONFIG_NET_ARP_SEND_QUEUE) || defined(CONFIG_NET_IPFRAG) || \
+    defined(CONFIG_NET_TCP_GSO)
 static int devif_poll_queue(FAR struct iob_queue_s *iobq,
                             FAR struct net_driver_s *dev,
                             devif_poll_callback_t callback)
@@ -785,6 +786,34 @@ static inline_function int devif_poll_ipfrag(FAR struct net_driver_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: devif_poll_gso
+ *
+ * Description:
+ *   Poll all TCP segments split from super-segments for available packets
+ *   to send.
+ *
+ * Input Parameters:
+ *   dev - NIC Device instance.
+ *   callback - the actual sending API provided by each NIC driver.
+ *
+ * Returned Value:
+ *   Zero indicated the polling will continue, else stop the polling.
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver with the network
+ *   locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+static inline_function int devif_poll_gso(FAR struct net_driver_s *dev,
+                                          devif_poll_callback_t callback)
+{
+  return devif_poll_queue(&dev->d_gsoout, dev, callback);
+}
+#endif
+
 /****************************************************************************
  * Name: devif_poll_arp
  *
@@ -893,6 +922,16 @@ static int devif_poll_connections(FAR struct net_driver_s *dev,
             bstop = devif_poll_ipfrag(dev, callback);
             break;
 #endif
+#ifdef CONFIG_NET_TCP_GSO
+          case GSO_POLL:
+
+            /* Traverse all of the TCP segments split from super-segments
+             * for available packets to transfer
+             */
+
+            bstop = devif_poll_gso(dev, callback);
+            break;
+#endif
 #ifdef CONFIG_NET_PKT
           case PKT_POLL:
 
@@ -1281,6 +1320,17 @@ int devif_poll_out(FAR struct net_driver_s *dev,
 
   if (callback)
     {
+#ifdef CONFIG_NET_TCP_GSO
+      if (tcp_gso_out(dev) < 0)
+        {
+          return 1;
+        }
+      else if (iob_peek_queue(&dev->d_gsoout) != NULL)
+        {
+          return devif_poll_gso(dev, callback);
+        }
+#endif
+
 #ifdef CONFIG_NET_IPFRAG
       if (ip_fragout(dev) != OK)
         {
@@ -486,6 +486,10 @@ static int ipv4_in(FAR struct net_driver_s *dev)
 done:
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+  tcp_gso_out(dev);
+#endif
+
 #ifdef CONFIG_NET_IPFRAG
   ip_fragout(dev);
 #endif
@@ -48,7 +48,12 @@
  ****************************************************************************/
 
 #define LOCAL_NPOLLWAITERS 2
-#define LOCAL_NCONTROLFDS  4
+
+#ifdef CONFIG_NET_LOCAL_SCM_MAXFDS
+#  define LOCAL_NCONTROLFDS CONFIG_NET_LOCAL_SCM_MAXFDS
+#else
+#  define LOCAL_NCONTROLFDS 4
+#endif
 
 #if CONFIG_DEV_PIPE_MAXSIZE > 65535
 typedef uint32_t lc_size_t;  /* 32-bit index */
@@ -603,6 +608,21 @@ int local_getaddr(FAR struct local_conn_s *conn, FAR struct sockaddr *addr,
 int local_create_fifos(FAR struct local_conn_s *conn,
                        uint32_t cssize, uint32_t scsize);
 
+/****************************************************************************
+ * Name: local_create_rings
+ *
+ * Description:
+ *   Create the pair of in-memory rings connecting a SOCK_STREAM client and
+ *   the server side connection.  Used instead of the FIFO pair.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+int local_create_rings(FAR struct local_conn_s *client,
+                       FAR struct local_conn_s *server,
+                       uint32_t cssize, uint32_t scsize);
+#endif
+
 /****************************************************************************
  * Name: local_create_halfduplex
  *
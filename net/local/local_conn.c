@@ -232,6 +232,21 @@ int local_alloc_accept(FAR struct local_conn_s *server,
   strlcpy(conn->lc_path, server->lc_path, sizeof(conn->lc_path));
   conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  /* Connect both sides directly through in-memory rings */
+
+  ret = local_create_rings(client, conn, server->lc_rcvsize,
+                           client->lc_rcvsize);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create rings for %s: %d\n",
+           client->lc_path, ret);
+      goto err;
+    }
+
+  *accept = conn;
+  return OK;
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conn, server->lc_rcvsize, client->lc_rcvsize);
@@ -279,6 +294,7 @@ int local_alloc_accept(FAR struct local_conn_s *server,
 
 errout_with_fifos:
   local_release_fifos(conn);
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 
 err:
   local_free(conn);
@@ -345,9 +361,17 @@ void local_free(FAR struct local_conn_s *conn)
     }
 #endif /* CONFIG_NET_LOCAL_SCM */
 
-  /* Destroy all FIFOs associated with the connection */
+  /* Destroy all FIFOs associated with the connection.  Connected stream
+   * sockets do not have any when the in-memory rings are used.
+   */
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  if (conn->lc_proto != SOCK_STREAM)
+#endif
+    {
+      local_release_fifos(conn);
+    }
 
-  local_release_fifos(conn);
 #ifdef CONFIG_NET_LOCAL_STREAM
   nxsem_destroy(&conn->lc_waitsem);
 #endif
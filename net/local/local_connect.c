@@ -96,6 +96,18 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
       return ret;
     }
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  /* The rings were attached to both sides by local_alloc_accept() */
+
+  if (nonblock)
+    {
+      ret = local_set_nonblocking(client);
+      if (ret < 0)
+        {
+          goto errout_with_rings;
+        }
+    }
+#else
   /* Open the client-side write-only FIFO.  This should not block and should
    * prevent the server-side from blocking as well.
    */
@@ -123,6 +135,7 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
     }
 
   DEBUGASSERT(client->lc_infile.f_inode != NULL);
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 
   /* Increment the number of pending server connections */
 
@@ -142,6 +155,19 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   client->lc_state = LOCAL_STATE_CONNECTED;
   return ret;
 
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+errout_with_rings:
+  file_close(&client->lc_infile);
+  client->lc_infile.f_inode = NULL;
+  file_close(&client->lc_outfile);
+  client->lc_outfile.f_inode = NULL;
+  client->lc_state = LOCAL_STATE_BOUND;
+  local_lock();
+  local_free(conn);
+  local_unlock();
+
+  return ret;
+#else
 errout_with_outfd:
   file_close(&client->lc_outfile);
   client->lc_outfile.f_inode = NULL;
@@ -154,6 +180,7 @@ errout_with_conn:
   local_unlock();
 
   return ret;
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
 }
 
 /****************************************************************************
@@ -0,0 +1,605 @@
+/****************************************************************************
+ * net/local/local_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/ioctl.h>
+
+#include <sys/param.h>
+
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+#include <poll.h>
+#include <nuttx/debug.h>
+
+#include <nuttx/atomic.h>
+#include <nuttx/circbuf.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCAL_RING_NPOLLWAITERS (2 * LOCAL_NPOLLWAITERS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One direction of a connected stream socket pair.  The ring is shared
+ * between the read-only file of the receiving connection and the write-only
+ * file of the sending connection, and is freed when both are closed.
+ */
+
+struct local_ring_s
+{
+  mutex_t          lr_lock;        /* Protects the buffer and state */
+  sem_t            lr_rdsem;       /* Reader waits for data */
+  sem_t            lr_wrsem;       /* Writer waits for space */
+  struct circbuf_s lr_buffer;      /* The in-memory ring buffer */
+  lc_size_t        lr_pollinthrd;  /* Buffer threshold for POLLIN */
+  lc_size_t        lr_polloutthrd; /* Buffer threshold for POLLOUT */
+  bool             lr_rdopen;      /* The reading end is open */
+  bool             lr_wropen;      /* The writing end is open */
+
+  /* Poll structures of threads waiting on either end of the ring */
+
+  FAR struct pollfd *lr_fds[LOCAL_RING_NPOLLWAITERS];
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int     local_ring_close(FAR struct file *filep);
+static ssize_t local_ring_read(FAR struct file *filep, FAR char *buffer,
+                               size_t len);
+static ssize_t local_ring_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t len);
+static int     local_ring_ioctl(FAR struct file *filep, int cmd,
+                                unsigned long arg);
+static int     local_ring_poll(FAR struct file *filep,
+                               FAR struct pollfd *fds, bool setup);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct file_operations g_local_ring_fops =
+{
+  NULL,              /* open */
+  local_ring_close,  /* close */
+  local_ring_read,   /* read */
+  local_ring_write,  /* write */
+  NULL,              /* seek */
+  local_ring_ioctl,  /* ioctl */
+  NULL,              /* mmap */
+  NULL,              /* truncate */
+  local_ring_poll    /* poll */
+};
+
+/* The ring files are never visible in the file system, they all share this
+ * anonymous inode and find their ring through f_priv.
+ */
+
+static struct inode g_local_ring_inode =
+{
+  NULL,                   /* i_parent */
+  NULL,                   /* i_peer */
+  NULL,                   /* i_child */
+  1,                      /* i_crefs */
+  FSNODEFLAG_TYPE_PIPE,   /* i_flags */
+  {
+    &g_local_ring_fops    /* u */
+  }
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_ring_wakeup
+ ****************************************************************************/
+
+static void local_ring_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  if (nxsem_get_value(sem, &sval) >= 0)
+    {
+      while (sval++ <= 0)
+        {
+          nxsem_post(sem);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_attach
+ *
+ * Description:
+ *   Bind a file structure to one end of the ring.
+ *
+ ****************************************************************************/
+
+static void local_ring_attach(FAR struct file *filep,
+                              FAR struct local_ring_s *ring, int oflags)
+{
+  memset(filep, 0, sizeof(*filep));
+
+  atomic_fetch_add(&g_local_ring_inode.i_crefs, 1);
+  filep->f_inode  = &g_local_ring_inode;
+  filep->f_oflags = oflags | O_CLOEXEC;
+  filep->f_priv   = ring;
+}
+
+/****************************************************************************
+ * Name: local_ring_close
+ ****************************************************************************/
+
+static int local_ring_close(FAR struct file *filep)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  int ret;
+
+  DEBUGASSERT(ring != NULL);
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      /* Readers see end-of-file once the buffer is drained */
+
+      ring->lr_wropen = false;
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLHUP);
+      local_ring_wakeup(&ring->lr_rdsem);
+    }
+  else
+    {
+      /* Writers get EPIPE from now on */
+
+      ring->lr_rdopen = false;
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLERR);
+      local_ring_wakeup(&ring->lr_wrsem);
+    }
+
+  filep->f_priv = NULL;
+
+  if (ring->lr_rdopen || ring->lr_wropen)
+    {
+      nxmutex_unlock(&ring->lr_lock);
+      return OK;
+    }
+
+  /* Both ends are closed, release the ring */
+
+  nxmutex_unlock(&ring->lr_lock);
+
+  circbuf_uninit(&ring->lr_buffer);
+  nxsem_destroy(&ring->lr_rdsem);
+  nxsem_destroy(&ring->lr_wrsem);
+  nxmutex_destroy(&ring->lr_lock);
+  kmm_free(ring);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_read
+ ****************************************************************************/
+
+static ssize_t local_ring_read(FAR struct file *filep, FAR char *buffer,
+                               size_t len)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  ssize_t nread;
+  int ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  while (circbuf_is_empty(&ring->lr_buffer))
+    {
+      /* Return end-of-file once the writer is gone */
+
+      if (!ring->lr_wropen)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return 0;
+        }
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return -EAGAIN;
+        }
+
+      nxmutex_unlock(&ring->lr_lock);
+      ret = nxsem_wait(&ring->lr_rdsem);
+      if (ret < 0 || (ret = nxmutex_lock(&ring->lr_lock)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  nread = circbuf_read(&ring->lr_buffer, buffer, len);
+
+  if (circbuf_used(&ring->lr_buffer) <=
+      circbuf_size(&ring->lr_buffer) - ring->lr_polloutthrd)
+    {
+      poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLOUT);
+    }
+
+  local_ring_wakeup(&ring->lr_wrsem);
+  nxmutex_unlock(&ring->lr_lock);
+  return nread;
+}
+
+/****************************************************************************
+ * Name: local_ring_write
+ ****************************************************************************/
+
+static ssize_t local_ring_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t len)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  ssize_t nwritten = 0;
+  int ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  for (; ; )
+    {
+      if (!ring->lr_rdopen)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return nwritten == 0 ? -EPIPE : nwritten;
+        }
+
+      if (!circbuf_is_full(&ring->lr_buffer))
+        {
+          nwritten += circbuf_write(&ring->lr_buffer, buffer + nwritten,
+                                    len - nwritten);
+
+          if (circbuf_used(&ring->lr_buffer) > ring->lr_pollinthrd)
+            {
+              poll_notify(ring->lr_fds, LOCAL_RING_NPOLLWAITERS, POLLIN);
+            }
+
+          local_ring_wakeup(&ring->lr_rdsem);
+
+          if ((size_t)nwritten == len)
+            {
+              nxmutex_unlock(&ring->lr_lock);
+              return nwritten;
+            }
+        }
+
+      /* The ring is full, return what was written so far or wait for the
+       * reader to make room.
+       */
+
+      if ((filep->f_oflags & O_NONBLOCK) != 0)
+        {
+          nxmutex_unlock(&ring->lr_lock);
+          return nwritten == 0 ? -EAGAIN : nwritten;
+        }
+
+      nxmutex_unlock(&ring->lr_lock);
+      ret = nxsem_wait(&ring->lr_wrsem);
+      if (ret < 0 || (ret = nxmutex_lock(&ring->lr_lock)) < 0)
+        {
+          return nwritten == 0 ? (ssize_t)ret : nwritten;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_ring_ioctl
+ ****************************************************************************/
+
+static int local_ring_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  int ret;
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  switch (cmd)
+    {
+      case PIPEIOC_POLLINTHRD:
+      case PIPEIOC_POLLOUTTHRD:
+        if (arg >= circbuf_size(&ring->lr_buffer))
+          {
+            ret = -EINVAL;
+          }
+        else if (cmd == PIPEIOC_POLLINTHRD)
+          {
+            ring->lr_pollinthrd = arg;
+          }
+        else
+          {
+            ring->lr_polloutthrd = arg;
+          }
+        break;
+
+      case PIPEIOC_PEEK:
+        {
+          FAR struct pipe_peek_s *peek = (FAR struct pipe_peek_s *)arg;
+
+          DEBUGASSERT(peek && peek->buf);
+
+          ret = circbuf_peekat(&ring->lr_buffer,
+                               ring->lr_buffer.tail + peek->offset,
+                               peek->buf, peek->size);
+        }
+        break;
+
+      case PIPEIOC_SETSIZE:
+        if (arg == 0)
+          {
+            ret = -EINVAL;
+          }
+        else
+          {
+            ret = circbuf_resize(&ring->lr_buffer,
+                                 MIN(arg, CONFIG_DEV_PIPE_MAXSIZE));
+          }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        ret = circbuf_size(&ring->lr_buffer);
+        break;
+
+      case FIONWRITE:
+      case FIONREAD:
+        *(FAR int *)((uintptr_t)arg) = circbuf_used(&ring->lr_buffer);
+        break;
+
+      case FIONSPACE:
+        *(FAR int *)((uintptr_t)arg) = circbuf_space(&ring->lr_buffer);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  nxmutex_unlock(&ring->lr_lock);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: local_ring_poll
+ ****************************************************************************/
+
+static int local_ring_poll(FAR struct file *filep, FAR struct pollfd *fds,
+                           bool setup)
+{
+  FAR struct local_ring_s *ring = filep->f_priv;
+  pollevent_t eventset = 0;
+  size_t nbytes;
+  int ret;
+  int i;
+
+  ret = nxmutex_lock(&ring->lr_lock);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (!setup)
+    {
+      FAR struct pollfd **slot = (FAR struct pollfd **)fds->priv;
+
+      if (slot != NULL)
+        {
+          *slot     = NULL;
+          fds->priv = NULL;
+        }
+
+      nxmutex_unlock(&ring->lr_lock);
+      return OK;
+    }
+
+  for (i = 0; i < LOCAL_RING_NPOLLWAITERS; i++)
+    {
+      if (ring->lr_fds[i] == NULL)
+        {
+          ring->lr_fds[i] = fds;
+          fds->priv       = &ring->lr_fds[i];
+          break;
+        }
+    }
+
+  if (i >= LOCAL_RING_NPOLLWAITERS)
+    {
+      fds->priv = NULL;
+      nxmutex_unlock(&ring->lr_lock);
+      return -EBUSY;
+    }
+
+  nbytes = circbuf_used(&ring->lr_buffer);
+
+  if ((filep->f_oflags & O_WROK) != 0)
+    {
+      if (!ring->lr_rdopen)
+        {
+          eventset |= POLLERR;
+        }
+      else if (nbytes < circbuf_size(&ring->lr_buffer) -
+                        ring->lr_polloutthrd)
+        {
+          eventset |= POLLOUT;
+        }
+    }
+  else
+    {
+      if (nbytes > ring->lr_pollinthrd)
+        {
+          eventset |= POLLIN;
+        }
+
+      if (nbytes == 0 && !ring->lr_wropen)
+        {
+          eventset |= POLLHUP;
+        }
+    }
+
+  poll_notify(&fds, 1, eventset);
+  nxmutex_unlock(&ring->lr_lock);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_ring_create
+ *
+ * Description:
+ *   Create one direction of a connected stream socket: an in-memory ring
+ *   buffer read through infile and written through outfile.  Neither file
+ *   has a path in the file system.
+ *
+ ****************************************************************************/
+
+static int local_ring_create(FAR struct file *infile,
+                             FAR struct file *outfile, size_t bufsize)
+{
+  FAR struct local_ring_s *ring;
+  int ret;
+
+  ring = kmm_zalloc(sizeof(struct local_ring_s));
+  if (ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = circbuf_init(&ring->lr_buffer, NULL,
+                     MIN(bufsize, CONFIG_DEV_PIPE_MAXSIZE));
+  if (ret < 0)
+    {
+      kmm_free(ring);
+      return ret;
+    }
+
+  nxmutex_init(&ring->lr_lock);
+  nxsem_init(&ring->lr_rdsem, 0, 0);
+  nxsem_init(&ring->lr_wrsem, 0, 0);
+
+  ring->lr_rdopen = true;
+  ring->lr_wropen = true;
+
+  local_ring_attach(infile, ring, O_RDONLY);
+  local_ring_attach(outfile, ring, O_WRONLY);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_create_rings
+ *
+ * Description:
+ *   Create the pair of in-memory rings connecting a SOCK_STREAM client and
+ *   the server side connection.  This replaces the FIFO pair: no path is
+ *   created, opened or unlinked.  All ends are opened in blocking mode.
+ *
+ * Input Parameters:
+ *   client - The client connection
+ *   server - The server side connection
+ *   cssize - Size of the client-to-server ring
+ *   scsize - Size of the server-to-client ring
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int local_create_rings(FAR struct local_conn_s *client,
+                       FAR struct local_conn_s *server,
+                       uint32_t cssize, uint32_t scsize)
+{
+  int ret;
+
+  /* Client-to-server: written by the client, read by the server */
+
+  ret = local_ring_create(&server->lc_infile, &client->lc_outfile, cssize);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Server-to-client: written by the server, read by the client */
+
+  ret = local_ring_create(&client->lc_infile, &server->lc_outfile, scsize);
+  if (ret < 0)
+    {
+      file_close(&server->lc_infile);
+      file_close(&client->lc_outfile);
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_NET_LOCAL_STREAM_RING */
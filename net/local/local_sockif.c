@@ -1034,6 +1034,42 @@ static int local_socketpair(FAR struct socket *psocks[2])
                            = -1;
 #endif
 
+  nonblock = _SS_ISNONBLOCK(conns[0]->lc_conn.s_flags);
+
+#ifdef CONFIG_NET_LOCAL_STREAM_RING
+  if (psocks[0]->s_type == SOCK_STREAM)
+    {
+      /* Connect the pair directly through in-memory rings */
+
+      ret = local_create_rings(conns[0], conns[1], conns[1]->lc_rcvsize,
+                               conns[0]->lc_rcvsize);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; nonblock && ret >= 0 && i < 2; i++)
+        {
+          ret = local_set_nonblocking(conns[i]);
+        }
+
+      if (ret < 0)
+        {
+          for (i = 0; i < 2; i++)
+            {
+              file_close(&conns[i]->lc_infile);
+              file_close(&conns[i]->lc_outfile);
+            }
+
+          return ret;
+        }
+
+      conns[0]->lc_state = conns[1]->lc_state
+                         = LOCAL_STATE_CONNECTED;
+      return OK;
+    }
+#endif
+
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(conns[0], conns[0]->lc_rcvsize,
@@ -1043,8 +1079,6 @@ static int local_socketpair(FAR struct socket *psocks[2])
       goto errout;
     }
 
-  nonblock = _SS_ISNONBLOCK(conns[0]->lc_conn.s_flags);
-
   /* Open the client-side write-only FIFO. */
 
   ret = local_open_client_tx(conns[0], conns[1], nonblock);
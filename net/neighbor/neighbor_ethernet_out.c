@@ -170,6 +170,9 @@ void neighbor_ethernet_out(FAR struct net_driver_s *dev)
            * message.
            */
 
+#ifdef CONFIG_NET_TCP_GSO
+          dev->d_gsosize = 0;
+#endif
           icmpv6_solicit(dev, ipaddr);
 #else
           /* What to do here? We need the laddr, but no way to get it. */
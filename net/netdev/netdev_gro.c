@@ -0,0 +1,325 @@
+/****************************************************************************
+ * net/netdev/netdev_gro.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <nuttx/debug.h>
+
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NETDEV_GRO
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GRO_IPv4HDR(iob) ((FAR struct ipv4_hdr_s *)IOB_DATA(iob))
+#define GRO_TCPHDR(iob)  ((FAR struct tcp_hdr_s *) \
+                          (IOB_DATA(iob) + IPv4_HDRLEN))
+#define GRO_TCPHDRLEN(tcp) (((tcp)->tcpoffset >> 4) << 2)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_check
+ *
+ * Description:
+ *   Check whether the packet in dev->d_iob is a candidate for coalescing:
+ *   an unfragmented, option-free IPv4 datagram addressed to this device
+ *   carrying a pure ACK (optionally with PSH) TCP segment with payload and
+ *   valid checksums.
+ *
+ * Returned Value:
+ *   The TCP header of the segment on success; NULL if the packet must be
+ *   passed to the stack unmodified.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_hdr_s *netdev_gro_check(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct eth_hdr_s *eth;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t hdrlen;
+  uint16_t iplen;
+
+  if (iob == NULL ||
+      (dev->d_lltype != NET_LL_ETHERNET &&
+       dev->d_lltype != NET_LL_IEEE80211))
+    {
+      return NULL;
+    }
+
+  /* The L2 header precedes the IP header in the guard area of the first
+   * IOB.  VLAN tagged frames are not handled here.
+   */
+
+  eth = (FAR struct eth_hdr_s *)NETLLBUF;
+  if (eth->type != HTONS(ETHTYPE_IP) ||
+      iob->io_len < IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return NULL;
+    }
+
+  ipv4 = GRO_IPv4HDR(iob);
+  if (ipv4->vhl != 0x45 || ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                        dev->d_ipaddr))
+    {
+      return NULL;
+    }
+
+  /* Trailing link layer padding would end up in the middle of the merged
+   * payload, so the IP length must match the packet length exactly.
+   */
+
+  iplen = (ipv4->len[0] << 8) + ipv4->len[1];
+  if (iplen != iob->io_pktlen)
+    {
+      return NULL;
+    }
+
+  tcp    = GRO_TCPHDR(iob);
+  hdrlen = IPv4_HDRLEN + GRO_TCPHDRLEN(tcp);
+  if (GRO_TCPHDRLEN(tcp) < TCP_HDRLEN || hdrlen > iob->io_len ||
+      iplen <= hdrlen || (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return NULL;
+    }
+
+  /* The merged segment is handed to the stack with the checksums already
+   * verified, so each segment has to be verified here.
+   */
+
+  if ((dev->d_features & NETDEV_RX_CSUM) == 0)
+    {
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      if (ipv4_chksum(ipv4) != 0xffff)
+        {
+          return NULL;
+        }
+#endif
+
+      if (tcp_ipv4_chksum(dev) != 0xffff)
+        {
+          return NULL;
+        }
+    }
+
+  return tcp;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_match
+ *
+ * Description:
+ *   Check whether the new segment directly follows the held segment of the
+ *   same flow and carries identical TCP control information.
+ *
+ ****************************************************************************/
+
+static bool netdev_gro_match(FAR struct iob_s *held,
+                             FAR struct iob_s *iob,
+                             FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct ipv4_hdr_s *hipv4 = GRO_IPv4HDR(held);
+  FAR struct ipv4_hdr_s *ipv4 = GRO_IPv4HDR(iob);
+  FAR struct tcp_hdr_s *htcp = GRO_TCPHDR(held);
+  uint16_t tcphdrlen = GRO_TCPHDRLEN(tcp);
+  uint32_t seq;
+
+  if (!net_ipv4addr_hdrcmp(hipv4->srcipaddr, ipv4->srcipaddr) ||
+      !net_ipv4addr_hdrcmp(hipv4->destipaddr, ipv4->destipaddr) ||
+      htcp->srcport != tcp->srcport || htcp->destport != tcp->destport ||
+      htcp->tcpoffset != tcp->tcpoffset ||
+      memcmp(htcp->ackno, tcp->ackno, 4) != 0 ||
+      memcmp(htcp->wnd, tcp->wnd, 2) != 0 ||
+      memcmp(htcp->optdata, tcp->optdata, tcphdrlen - TCP_HDRLEN) != 0)
+    {
+      return false;
+    }
+
+  /* Held segment must not grow beyond the configured limit */
+
+  if (held->io_pktlen + iob->io_pktlen - IPv4_HDRLEN - tcphdrlen >
+      CONFIG_NETDEV_GRO_MAXSIZE)
+    {
+      return false;
+    }
+
+  seq = tcp_getsequence(htcp->seqno) +
+        held->io_pktlen - IPv4_HDRLEN - tcphdrlen;
+
+  return seq == tcp_getsequence(tcp->seqno);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_gro_flush
+ *
+ * Description:
+ *   Pass the coalesced segment held in dev->d_gro (if any) to the input
+ *   callback.  Must be called at the end of every receive poll batch.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+void netdev_gro_flush(FAR struct net_driver_s *dev,
+                      CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct iob_s *saved_iob;
+  FAR uint8_t *saved_buf;
+  uint16_t saved_len;
+  uint8_t features;
+
+  if (dev->d_gro == NULL)
+    {
+      return;
+    }
+
+  /* Save the packet currently being received, if any */
+
+  saved_iob  = dev->d_iob;
+  saved_buf  = dev->d_buf;
+  saved_len  = dev->d_len;
+  dev->d_iob = dev->d_gro;
+  dev->d_len = dev->d_gro->io_pktlen + NET_LL_HDRLEN(dev);
+  dev->d_gro = NULL;
+
+  /* Fix up the IPv4 header to cover the merged payload */
+
+  ipv4           = IPv4BUF;
+  ipv4->len[0]   = dev->d_iob->io_pktlen >> 8;
+  ipv4->len[1]   = dev->d_iob->io_pktlen & 0xff;
+  ipv4->ipchksum = 0;
+  ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+  /* All segments were verified in netdev_gro_check(), the TCP checksum of
+   * the merged segment is stale and must not be checked again.
+   */
+
+  features         = dev->d_features;
+  dev->d_features |= NETDEV_RX_CSUM;
+
+  input(dev);
+
+  dev->d_features = features;
+
+  /* Drop whatever the input handler left behind and restore the packet */
+
+  netdev_iob_release(dev);
+  dev->d_iob = saved_iob;
+  dev->d_buf = saved_buf;
+  dev->d_len = saved_len;
+}
+
+/****************************************************************************
+ * Name: netdev_gro_receive
+ *
+ * Description:
+ *   Offer the packet in dev->d_iob to the generic receive offload.  In-order
+ *   TCP segments of the same flow are merged into one IOB chain held in
+ *   dev->d_gro; a segment that cannot be merged first flushes the held one
+ *   through the input callback.
+ *
+ * Input Parameters:
+ *   dev   - The network device that received the packet
+ *   input - The L2 input handler used to flush the coalesced segment
+ *
+ * Returned Value:
+ *   true if the packet was consumed (dev->d_iob has been taken away);
+ *   false if the caller must pass the packet to the stack itself.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+bool netdev_gro_receive(FAR struct net_driver_s *dev,
+                        CODE void (*input)(FAR struct net_driver_s *dev))
+{
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *iob;
+
+  tcp = netdev_gro_check(dev);
+  if (tcp == NULL)
+    {
+      /* Keep the ordering with the segments held so far */
+
+      netdev_gro_flush(dev, input);
+      return false;
+    }
+
+  iob = dev->d_iob;
+  netdev_iob_clear(dev);
+
+  if (dev->d_gro != NULL && netdev_gro_match(dev->d_gro, iob, tcp))
+    {
+      /* Propagate PSH, then strip the headers and append the payload */
+
+      GRO_TCPHDR(dev->d_gro)->flags |= tcp->flags;
+      iob = iob_trimhead(iob, IPv4_HDRLEN + GRO_TCPHDRLEN(tcp));
+      iob_concat(dev->d_gro, iob);
+    }
+  else
+    {
+      netdev_gro_flush(dev, input);
+      dev->d_gro = iob;
+    }
+
+  /* Deliver the data to the application without delay once the sender
+   * asked for it.
+   */
+
+  if ((GRO_TCPHDR(dev->d_gro)->flags & TCP_PSH) != 0)
+    {
+      netdev_gro_flush(dev, input);
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_NETDEV_GRO */
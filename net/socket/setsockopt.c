@@ -137,6 +137,9 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                             * periodic transmission of probes */
       case SO_OOBINLINE:   /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:   /* Allow reuse of local addresses */
+#ifdef CONFIG_NET_REUSEPORT
+      case SO_REUSEPORT:   /* Allow several sockets on the same port */
+#endif
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:   /* Generates a timestamp in us for each incoming packet */
       case SO_TIMESTAMPNS: /* Generates a timestamp in ns for each incoming packet */
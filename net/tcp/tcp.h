@@ -72,6 +72,9 @@
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
+#ifdef CONFIG_NET_TCP_RACK
+#  define TCP_WBXMIT(wrb)            ((wrb)->wb_xmit)
+#endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
@@ -105,6 +108,7 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TSTAMP            0x20U /* Timestamps option enabled */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -127,6 +131,26 @@
 #define TCP_RTO_MAX 240 /* 120s,The unit is half a second */
 #define TCP_RTO_MIN 1   /* 0.5s */
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+/* The TCP timestamp clock (RFC 7323), in units of milliseconds */
+
+#  define TCP_TSCLOCK()       ((uint32_t)TICK2MSEC(clock_systime_ticks()))
+
+/* 32-bit modular comparison of timestamp values */
+
+#  define TCP_TS_LT(a, b)     ((int32_t)((a) - (b)) < 0)
+#  define TCP_TS_GTE(a, b)    (!TCP_TS_LT(a, b))
+
+/* Space consumed by the Timestamps option in every segment once the option
+ * has been negotiated on the connection.
+ */
+
+#  define TCP_TS_OPTLEN(conn) \
+     (((conn)->flags & TCP_TSTAMP) != 0 ? TCP_OPT_TS_ALIGNED_LEN : 0)
+#else
+#  define TCP_TS_OPTLEN(conn) 0
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -243,6 +267,20 @@ struct tcp_conn_s
                            * connection */
 #endif
   uint32_t rcv_adv;       /* The right edge of the recv window advertised */
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  uint32_t ts_recent;     /* The most recent TSval received (TS.Recent) */
+  uint32_t ts_ecr;        /* TSecr echoed by the last acceptable ACK */
+  uint32_t srtt;          /* Smoothed RTT from timestamp samples
+                           * (units: milliseconds, scaled by 8) */
+  uint32_t rttvar;        /* RTT variation from timestamp samples
+                           * (units: milliseconds, scaled by 4) */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  uint32_t rack_xmit;     /* Transmit time of the most recently sent
+                           * segment that has been delivered */
+  uint32_t rack_rtt;      /* The RTT of that segment (milliseconds) */
+  uint32_t rack_minrtt;   /* The minimum RTT observed (milliseconds) */
+#endif
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
   uint32_t last_ackno;    /* The ack number at the last receive ack */
   uint32_t dupacks;       /* The number of duplicate ack */
@@ -412,6 +450,9 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  uint32_t   wb_xmit;      /* Time the write buffer was last (re)sent */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -1158,6 +1199,39 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno,
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno);
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_ok
+ *
+ * Description:
+ *   Check whether conn may share the local address and port with the
+ *   connections already using them (SO_REUSEPORT).
+ *
+ * Assumptions:
+ *   Called from normal user code.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+bool tcp_reuseport_ok(FAR struct tcp_conn_s *conn,
+                      FAR const union ip_addr_u *ipaddr, uint16_t portno);
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Pick the listener of a SO_REUSEPORT group that handles the connection
+ *   from the given remote address and port.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                                            FAR const void *raddr,
+                                            uint16_t rport);
+#endif
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -2239,6 +2313,53 @@ int tcp_ioctl(FAR struct tcp_conn_s *conn, int cmd, unsigned long arg);
 void tcp_sendbuffer_notify(FAR struct tcp_conn_s *conn);
 #endif /* CONFIG_NET_SEND_BUFSIZE */
 
+/****************************************************************************
+ * Name: tcp_gso_out
+ *
+ * Description:
+ *   Split the TCP super-segment in dev->d_iob into segments of
+ *   dev->d_gsosize payload bytes each and queue them on dev->d_gsoout.
+ *   Packets that are not super-segments are left untouched.
+ *
+ * Input Parameters:
+ *   dev - The network device that is about to send the packet
+ *
+ * Returned Value:
+ *   The number of queued segments (zero if the packet was left in place)
+ *   on success; a negated errno value on failure, in which case the packet
+ *   has been dropped.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+int tcp_gso_out(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: tcp_gso_maxsize
+ *
+ * Description:
+ *   Return the largest payload that may be passed to the device in one
+ *   TCP segment: the MSS, or the size of a TCP super-segment if GSO is
+ *   enabled.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   The maximum payload size in bytes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+uint32_t tcp_gso_maxsize(FAR struct tcp_conn_s *conn);
+#else
+#  define tcp_gso_maxsize(conn) ((conn)->mss)
+#endif
+
 /****************************************************************************
  * Name: tcpip_hdrsize
  *
@@ -212,10 +212,11 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   else
     {
       /* The application cannot send more than what is allowed by the
-       * MSS (the minimum of the MSS and the available window).
+       * MSS (the minimum of the MSS and the available window), or by the
+       * size of a TCP super-segment if GSO is enabled.
        */
 
-      DEBUGASSERT(dev->d_sndlen <= conn->mss);
+      DEBUGASSERT(dev->d_sndlen <= tcp_gso_maxsize(conn));
 
 #if !defined(CONFIG_NET_TCP_WRITE_BUFFERS) || defined(CONFIG_NET_SENDFILE)
 
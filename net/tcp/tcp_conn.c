@@ -71,6 +71,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -341,9 +342,24 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Verify or select a local port (network byte order) */
 
-  port = tcp_selectport(PF_INET,
+#ifdef CONFIG_NET_REUSEPORT
+  /* Members of a SO_REUSEPORT group may bind to a port in use */
+
+  if (tcp_reuseport_ok(conn,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
-                       addr->sin_port);
+                       addr->sin_port))
+    {
+      port = addr->sin_port;
+    }
+  else
+#endif
+    {
+      port = tcp_selectport(PF_INET,
+                            (FAR const union ip_addr_u *)
+                            &addr->sin_addr.s_addr,
+                            addr->sin_port);
+    }
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -437,9 +453,24 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* The port number must be unique for this address binding */
 
-  port = tcp_selectport(PF_INET6,
+#ifdef CONFIG_NET_REUSEPORT
+  /* Members of a SO_REUSEPORT group may bind to a port in use */
+
+  if (tcp_reuseport_ok(conn,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
-                addr->sin6_port);
+                addr->sin6_port))
+    {
+      port = addr->sin6_port;
+    }
+  else
+#endif
+    {
+      port = tcp_selectport(PF_INET6,
+                            (FAR const union ip_addr_u *)
+                            addr->sin6_addr.in6_u.u6_addr16,
+                            addr->sin6_port);
+    }
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -1121,6 +1152,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
 #  ifdef CONFIG_NET_BINDTODEVICE
       conn->sconn.s_boundto  = listener->sconn.s_boundto;
 #  endif
+#  ifdef CONFIG_NET_REUSEPORT
+      conn->sconn.s_options |= listener->sconn.s_options & _SO_REUSEPORT;
+#  endif
 #endif
 
       conn->sconn.s_tos      = listener->sconn.s_tos;
@@ -0,0 +1,318 @@
+/****************************************************************************
+ * net/tcp/tcp_gso.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <nuttx/debug.h>
+
+#include <net/if.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_TCP_GSO
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_fixup
+ *
+ * Description:
+ *   Rewrite the L3 length, sequence number, flags and checksums of one
+ *   segment cut out of a super-segment.
+ *
+ * Input Parameters:
+ *   dev      - The network device, dev->d_iob holds the segment
+ *   iphdrlen - Size of the L3 header
+ *   seglen   - Payload size of this segment
+ *   seq      - Sequence number of the first payload byte
+ *   index    - Index of the segment within the super-segment
+ *   last     - True if this is the last segment
+ *
+ ****************************************************************************/
+
+static void tcp_gso_fixup(FAR struct net_driver_s *dev, uint16_t iphdrlen,
+                          uint16_t seglen, uint32_t seq, uint16_t index,
+                          bool last)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iphdrlen);
+  uint16_t tcplen = ((tcp->tcpoffset >> 4) << 2) + seglen;
+
+  tcp_setsequence(tcp->seqno, seq);
+
+  /* PSH and FIN belong to the end of the super-segment only */
+
+  if (!last)
+    {
+      tcp->flags &= ~(TCP_PSH | TCP_FIN);
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      ipv6->len[0] = tcplen >> 8;
+      ipv6->len[1] = tcplen & 0xff;
+
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+        {
+          tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+        }
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      uint16_t totlen = iphdrlen + tcplen;
+      uint16_t ipid;
+
+      /* Consecutive IP ids, the first segment keeps the original one */
+
+      ipid = ((ipv4->ipid[0] << 8) | ipv4->ipid[1]) + index;
+
+      ipv4->len[0]   = totlen >> 8;
+      ipv4->len[1]   = totlen & 0xff;
+      ipv4->ipid[0]  = ipid >> 8;
+      ipv4->ipid[1]  = ipid & 0xff;
+      ipv4->ipchksum = 0;
+
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+#endif
+
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      if ((dev->d_features & NETDEV_TX_CSUM) == 0)
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_gso_maxsize
+ *
+ * Description:
+ *   Return the largest payload that may be passed to the device in one
+ *   TCP super-segment.  This does not depend on the free IOBs, so it
+ *   remains a valid bound after the payload has been copied.
+ *
+ * Input Parameters:
+ *   conn - The TCP connection structure
+ *
+ * Returned Value:
+ *   The maximum payload size in bytes, never less than the MSS.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_gso_maxsize(FAR struct tcp_conn_s *conn)
+{
+  uint32_t size = CONFIG_NET_TCP_GSO_MAXSIZE - tcpip_hdrsize(conn);
+
+  return MAX(size, conn->mss);
+}
+
+/****************************************************************************
+ * Name: tcp_gso_out
+ *
+ * Description:
+ *   Split the TCP super-segment in dev->d_iob into segments of
+ *   dev->d_gsosize payload bytes each and queue them on dev->d_gsoout.
+ *   Packets that are not super-segments are left untouched.
+ *
+ * Input Parameters:
+ *   dev - The network device that is about to send the packet
+ *
+ * Returned Value:
+ *   The number of queued segments (zero if the packet was left in place)
+ *   on success; a negated errno value on failure, in which case the packet
+ *   has been dropped.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+int tcp_gso_out(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *orig = dev->d_iob;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *seg;
+  struct iob_queue_s segq =
+    {
+      NULL, NULL
+    };
+
+  uint16_t gsosize = dev->d_gsosize;
+  uint16_t iphdrlen;
+  uint16_t hdrlen;
+  uint16_t seglen;
+  uint16_t nsegs = 0;
+  uint32_t paylen;
+  uint32_t offset;
+  uint32_t seq;
+  uint8_t proto;
+  int ret;
+
+  /* The segment size only applies to the packet it was set for */
+
+  dev->d_gsosize = 0;
+
+  if (gsosize == 0 || orig == NULL || dev->d_len == 0 ||
+      devif_is_loopback(dev))
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      iphdrlen = IPv6_HDRLEN;
+      proto    = IPv6BUF->proto;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      iphdrlen = (IPv4BUF->vhl & IPv4_HLMASK) << 2;
+      proto    = IPv4BUF->proto;
+    }
+#endif
+
+  if (proto != IP_PROTO_TCP || orig->io_len < iphdrlen + TCP_HDRLEN)
+    {
+      return 0;
+    }
+
+  tcp    = IPBUF(iphdrlen);
+  hdrlen = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  if (orig->io_len < hdrlen || orig->io_pktlen <= hdrlen + gsosize)
+    {
+      return 0;
+    }
+
+  paylen = orig->io_pktlen - hdrlen;
+  seq    = tcp_getsequence(tcp->seqno);
+
+  ninfo("GSO: pktlen=%u gsosize=%u\n", orig->io_pktlen, gsosize);
+
+  for (offset = 0; offset < paylen; offset += seglen)
+    {
+      seglen = MIN(gsosize, paylen - offset);
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          ret = -ENOMEM;
+          goto errout;
+        }
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+
+      /* Copy the payload first, then the headers in front of it */
+
+      ret = iob_clone_partial(orig, seglen, hdrlen + offset, seg, hdrlen,
+                              false, false);
+      if (ret < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      memcpy(IOB_DATA(seg), IOB_DATA(orig), hdrlen);
+
+      /* Borrow the device buffer to reuse the checksum helpers */
+
+      dev->d_iob = seg;
+      tcp_gso_fixup(dev, iphdrlen, seglen, seq + offset, nsegs,
+                    offset + seglen >= paylen);
+      dev->d_iob = orig;
+
+      ret = iob_tryadd_queue(seg, &segq);
+      if (ret < 0)
+        {
+          iob_free_chain(seg);
+          goto errout;
+        }
+
+      nsegs++;
+    }
+
+  iob_concat_queue(&dev->d_gsoout, &segq);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.sent += nsegs - 1;
+#endif
+
+  netdev_iob_release(dev);
+  dev->d_len = 0;
+
+  netdev_txnotify_dev(dev, GSO_POLL);
+  return nsegs;
+
+errout:
+  nerr("ERROR: GSO failed: %d\n", ret);
+  iob_free_queue(&segq);
+  netdev_iob_release(dev);
+  dev->d_len = 0;
+  return ret;
+}
+
+#endif /* CONFIG_NET_TCP_GSO */
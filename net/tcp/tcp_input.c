@@ -615,6 +615,14 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
         {
           conn->flags    |= TCP_SACK;
         }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN)
+        {
+          conn->ts_recent = tcp_getsequence(IPBUF(tcpiplen + 2 + i));
+          conn->flags    |= TCP_TSTAMP;
+        }
 #endif
       else
         {
@@ -634,7 +642,159 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
 
       i += IPDATA(tcpiplen + 1 + i);
     }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  /* Every segment of the connection now carries the Timestamps option,
+   * which must come out of the payload.
+   */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      conn->mss -= TCP_OPT_TS_ALIGNED_LEN;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_parse_timestamp
+ *
+ * Description:
+ *   Find the Timestamps option in an incoming TCP segment
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received TCP packet.
+ *   iplen  - Length of the IP header (IPv4_HDRLEN or IPv6_HDRLEN).
+ *   tsval  - Location to return the TSval field
+ *   tsecr  - Location to return the TSecr field
+ *
+ * Returned Value:
+ *   true if the segment carries a Timestamps option
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+static bool tcp_parse_timestamp(FAR struct net_driver_s *dev,
+                                unsigned int iplen, FAR uint32_t *tsval,
+                                FAR uint32_t *tsecr)
+{
+  FAR struct tcp_hdr_s *tcp = IPBUF(iplen);
+  unsigned int tcpiplen = iplen + TCP_HDRLEN;
+  unsigned int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  unsigned int i;
+  uint8_t opt;
+
+  /* Fast path for the layout recommended by RFC 7323, Appendix A */
+
+  if (optlen >= TCP_OPT_TS_ALIGNED_LEN &&
+      IPDATA(tcpiplen) == TCP_OPT_NOOP &&
+      IPDATA(tcpiplen + 1) == TCP_OPT_NOOP &&
+      IPDATA(tcpiplen + 2) == TCP_OPT_TS &&
+      IPDATA(tcpiplen + 3) == TCP_OPT_TS_LEN)
+    {
+      *tsval = tcp_getsequence(IPBUF(tcpiplen + 4));
+      *tsecr = tcp_getsequence(IPBUF(tcpiplen + 8));
+      return true;
+    }
+
+  for (i = 0; i < optlen; )
+    {
+      opt = IPDATA(tcpiplen + i);
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          ++i;
+          continue;
+        }
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen)
+        {
+          *tsval = tcp_getsequence(IPBUF(tcpiplen + 2 + i));
+          *tsecr = tcp_getsequence(IPBUF(tcpiplen + 6 + i));
+          return true;
+        }
+      else if (IPDATA(tcpiplen + 1 + i) == 0)
+        {
+          /* Malformed options */
+
+          break;
+        }
+
+      i += IPDATA(tcpiplen + 1 + i);
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_update_rtt
+ *
+ * Description:
+ *   Feed one RTT sample, measured with the Timestamps option, into the
+ *   RTO estimator of RFC 6298.  The estimator runs with millisecond
+ *   resolution and the result is rounded up to the half-second units of
+ *   the TCP timer.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   rtt    - The RTT sample (units: milliseconds)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_TCP_FIXED_RTO
+static void tcp_update_rtt(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  uint32_t rto;
+  int32_t delta;
+
+  if (rtt == 0)
+    {
+      rtt = 1;
+    }
+
+  if (conn->srtt == 0)
+    {
+      /* First measurement: SRTT = R, RTTVAR = R/2 */
+
+      conn->srtt   = rtt << 3;
+      conn->rttvar = rtt << 1;
+    }
+  else
+    {
+      /* SRTT = 7/8 SRTT + 1/8 R, RTTVAR = 3/4 RTTVAR + 1/4 |SRTT - R| */
+
+      delta = rtt - (conn->srtt >> 3);
+      conn->srtt += delta;
+      if (delta < 0)
+        {
+          delta = -delta;
+        }
+
+      delta -= conn->rttvar >> 2;
+      conn->rttvar += delta;
+    }
+
+  /* RTO = SRTT + max(G, 4 * RTTVAR), G being the timer granularity */
+
+  rto = (conn->srtt >> 3) + MAX(MSEC_PER_HSEC, conn->rttvar);
+  rto = (rto + MSEC_PER_HSEC - 1) / MSEC_PER_HSEC;
+
+  conn->rto = MIN(MAX(rto, TCP_RTO_MIN), TCP_RTO_MAX);
 }
+#endif /* !CONFIG_NET_TCP_FIXED_RTO */
+#endif /* CONFIG_NET_TCP_TIMESTAMP */
 
 /****************************************************************************
  * Name: tcp_clear_zero_probe
@@ -700,6 +860,10 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   uint16_t tmp16;
   uint16_t result;
   int      len;
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  uint32_t tsval;
+  uint32_t tsecr = 0;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -931,6 +1095,30 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
           goto drop;
         }
 
+#ifdef CONFIG_NET_REUSEPORT
+      /* Spread the connections across the listeners of the group */
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+      if (domain == PF_INET6)
+#  endif
+        {
+          conn = tcp_reuseport_select(conn, IPv6BUF->srcipaddr,
+                                      tcp->srcport);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+      if (domain == PF_INET)
+#  endif
+        {
+          conn = tcp_reuseport_select(conn, IPv4BUF->srcipaddr,
+                                      tcp->srcport);
+        }
+#endif
+#endif /* CONFIG_NET_REUSEPORT */
+
       if (!tcp_backlogavailable(conn))
         {
           nerr("ERROR: no free containers for TCP BACKLOG!\n");
@@ -1064,6 +1252,44 @@ found:
       goto drop;
     }
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  if ((conn->flags & TCP_TSTAMP) != 0 && (tcp->flags & TCP_SYN) == 0 &&
+      tcp_parse_timestamp(dev, iplen, &tsval, &tsecr))
+    {
+      uint32_t seq = tcp_getsequence(tcp->seqno);
+
+      /* PAWS (RFC 7323, section 5.3): an old duplicate segment carries a
+       * TSval older than TS.Recent; acknowledge and drop it.
+       */
+
+      if (TCP_TS_LT(tsval, conn->ts_recent))
+        {
+          nwarn("WARNING: PAWS drop, TSval %" PRIu32 " < %" PRIu32 "\n",
+                tsval, conn->ts_recent);
+          tcp_send(dev, conn, TCP_ACK, tcpiplen);
+          return;
+        }
+
+      /* Remember the TSval to echo, if the segment covers the left edge
+       * of the receive window.
+       */
+
+      if (TCP_SEQ_LTE(seq, tcp_getsequence(conn->rcvseq)))
+        {
+          conn->ts_recent = tsval;
+        }
+
+      if ((tcp->flags & TCP_ACK) != 0)
+        {
+          conn->ts_ecr = tsecr;
+        }
+    }
+  else
+    {
+      tsecr = 0;
+    }
+#endif
+
   /* Calculated the length of the data, if the application has sent
    * any data to us.
    */
@@ -1234,6 +1460,21 @@ found:
 #endif
 
 #ifndef CONFIG_NET_TCP_FIXED_RTO
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+      /* The echoed timestamp gives an unambiguous RTT sample for every ACK
+       * of new data, even after retransmissions (RFC 7323, section 4).
+       */
+
+      if (tsecr != 0)
+        {
+          if (conn->tx_unacked < lasttxunacked)
+            {
+              tcp_update_rtt(conn, TCP_TSCLOCK() - tsecr);
+            }
+        }
+      else
+#endif
+
       /* Do RTT estimation, unless we have done retransmissions. */
 
       if (conn->nrtx == 0)
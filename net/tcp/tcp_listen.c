@@ -55,7 +55,10 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "nat/nat.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
+#include "utils/utils.h"
 
 /****************************************************************************
  * Private Data
@@ -69,6 +72,47 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_reuseport_member
+ *
+ * Description:
+ *   Return true if conn belongs to the same SO_REUSEPORT group as listener:
+ *   both have the option set and are bound to exactly the same local
+ *   address and port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+static bool tcp_reuseport_member(FAR struct tcp_conn_s *listener,
+                                 FAR struct tcp_conn_s *conn)
+{
+  if (conn == NULL || conn->lport != listener->lport ||
+      conn->domain != listener->domain ||
+      !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (listener->domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, listener->u.ipv6.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, listener->u.ipv4.laddr);
+    }
+#endif
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
@@ -180,12 +224,19 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
   /* First, check if there is already a socket listening on this port */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  if (tcp_islistener(&conn->u, conn->lport, conn->domain)
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  if (tcp_islistener(&conn->u, conn->lport)
+#endif
+#ifdef CONFIG_NET_REUSEPORT
+      && !tcp_reuseport_ok(conn, (FAR const union ip_addr_u *)&conn->u,
+                           conn->lport)
 #endif
+     )
     {
-      /* Yes, then we must refuse this request */
+      /* Yes, and it does not share the port with us.  Then we must refuse
+       * this request.
+       */
 
       ret = -EADDRINUSE;
     }
@@ -242,6 +293,156 @@ bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 }
 #endif
 
+/****************************************************************************
+ * Name: tcp_reuseport_ok
+ *
+ * Description:
+ *   Check whether conn may share the local address and port with the
+ *   connections already using them.  That is the case if conn and every
+ *   open connection and listener bound to the address and port have the
+ *   SO_REUSEPORT option set.
+ *
+ * Input Parameters:
+ *   conn   - The connection that wants to use the address and port
+ *   ipaddr - The local IP address
+ *   portno - The local port number in network order
+ *
+ * Returned Value:
+ *   true if the address and port may be shared.
+ *
+ * Assumptions:
+ *   Called from normal user code.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+bool tcp_reuseport_ok(FAR struct tcp_conn_s *conn,
+                      FAR const union ip_addr_u *ipaddr, uint16_t portno)
+{
+  FAR struct tcp_conn_s *other = NULL;
+  bool ret = true;
+  int ndx;
+
+  if (portno == 0 || !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_NAT
+  if (nat_port_inuse(conn->domain, IP_PROTO_TCP, ipaddr, portno))
+    {
+      return false;
+    }
+#endif
+
+  tcp_conn_list_lock();
+
+  for (ndx = 0; ret && ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      other = tcp_listenports[ndx];
+      if (other != NULL && other != conn &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          tcp_conn_cmp(conn->domain, ipaddr, portno, other) &&
+#else
+          tcp_conn_cmp(ipaddr, portno, other) &&
+#endif
+          !_SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+        {
+          ret = false;
+        }
+    }
+
+  other = NULL;
+  while (ret && (other = tcp_nextconn(other)) != NULL)
+    {
+      if (other != conn && other->tcpstateflags != TCP_CLOSED &&
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          tcp_conn_cmp(conn->domain, ipaddr, portno, other) &&
+#else
+          tcp_conn_cmp(ipaddr, portno, other) &&
+#endif
+          !_SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+        {
+          ret = false;
+        }
+    }
+
+  tcp_conn_list_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_select
+ *
+ * Description:
+ *   Pick the listener of a SO_REUSEPORT group that handles the connection
+ *   from the given remote address and port.  The choice only depends on the
+ *   remote end point, so the SYN and the final ACK of the handshake are
+ *   directed to the same listener.
+ *
+ * Input Parameters:
+ *   listener - The listener found by tcp_findlistener()
+ *   raddr    - The remote IP address in network order
+ *   rport    - The remote port number in network order
+ *
+ * Returned Value:
+ *   The selected listener; the listener itself if it is not part of a
+ *   group.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_conn_s *tcp_reuseport_select(FAR struct tcp_conn_s *listener,
+                                            FAR const void *raddr,
+                                            uint16_t rport)
+{
+  FAR struct tcp_conn_s *conn;
+  uint32_t hash;
+  size_t addrlen;
+  int nmembers = 0;
+  int ndx;
+
+  if (!_SO_GETOPT(listener->sconn.s_options, SO_REUSEPORT))
+    {
+      return listener;
+    }
+
+  tcp_conn_list_lock();
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      if (tcp_reuseport_member(listener, tcp_listenports[ndx]))
+        {
+          nmembers++;
+        }
+    }
+
+#ifdef CONFIG_NET_IPv6
+  addrlen = listener->domain == PF_INET6 ? sizeof(net_ipv6addr_t) :
+                                           sizeof(in_addr_t);
+#else
+  addrlen = sizeof(in_addr_t);
+#endif
+
+  hash = net_flowhash(raddr, addrlen, rport) % nmembers;
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      conn = tcp_listenports[ndx];
+      if (tcp_reuseport_member(listener, conn) && hash-- == 0)
+        {
+          listener = conn;
+          break;
+        }
+    }
+
+  tcp_conn_list_unlock();
+  return listener;
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Name: tcp_accept_connection
  *
@@ -269,6 +470,34 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
 #else
   listener = tcp_findlistener(&conn->u, portno);
 #endif
+
+#ifdef CONFIG_NET_REUSEPORT
+  /* Hand the connection to the group member that saw its SYN */
+
+  if (listener != NULL)
+    {
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+      if (conn->domain == PF_INET6)
+#  endif
+        {
+          listener = tcp_reuseport_select(listener, conn->u.ipv6.raddr,
+                                          conn->rport);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+      else
+#  endif
+        {
+          listener = tcp_reuseport_select(listener, &conn->u.ipv4.raddr,
+                                          conn->rport);
+        }
+#endif
+    }
+#endif
+
   if (listener != NULL)
     {
       /* Yes, there is a listener.  Is it accepting connections now? */
@@ -104,6 +104,39 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_set_timestamp
+ *
+ * Description:
+ *   Fill in the (NOOP-aligned) Timestamps option: TSval is taken from the
+ *   local timestamp clock and TSecr echoes the most recent TSval received
+ *   from the peer (RFC 7323, section 3.2).
+ *
+ * Input Parameters:
+ *   conn    - The TCP connection structure holding connection information
+ *   optdata - The location in the TCP header to place the option
+ *
+ * Returned Value:
+ *   The number of option bytes written
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+static uint16_t tcp_set_timestamp(FAR struct tcp_conn_s *conn,
+                                  FAR uint8_t *optdata)
+{
+  optdata[0] = TCP_OPT_NOOP;
+  optdata[1] = TCP_OPT_NOOP;
+  optdata[2] = TCP_OPT_TS;
+  optdata[3] = TCP_OPT_TS_LEN;
+
+  tcp_setsequence(&optdata[4], TCP_TSCLOCK());
+  tcp_setsequence(&optdata[8], conn->ts_recent);
+
+  return TCP_OPT_TS_ALIGNED_LEN;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -289,6 +322,7 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
               uint16_t flags, uint16_t len)
 {
   FAR struct tcp_hdr_s *tcp;
+  uint16_t optlen = 0;
 
   if (dev->d_iob == NULL)
     {
@@ -299,39 +333,69 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags = flags;
   dev->d_len = len;
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      uint16_t hdrlen = tcpip_hdrsize(conn);
+
+      /* Segments carrying data already reserve room for the option in
+       * tcpip_hdrsize().  Header-only segments sent in response to input
+       * may not, so make room here.
+       */
+
+      if (dev->d_len < hdrlen)
+        {
+          dev->d_len = hdrlen;
+        }
+
+      optlen = tcp_set_timestamp(conn, tcp->optdata);
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
   if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      FAR uint8_t *optdata = &tcp->optdata[optlen];
+      int nsacks = conn->nofosegs;
+      int sacklen;
       int i;
 
-      tcp->optdata[0] = TCP_OPT_NOOP;
-      tcp->optdata[1] = TCP_OPT_NOOP;
-      tcp->optdata[2] = TCP_OPT_SACK;
-      tcp->optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
+      /* Only as many SACK blocks as fit in the remaining option space */
+
+      if (nsacks > (TCP_OPT_MAX_LEN - optlen - 4) /
+                   (int)sizeof(struct tcp_sack_s))
+        {
+          nsacks = (TCP_OPT_MAX_LEN - optlen - 4) /
+                   sizeof(struct tcp_sack_s);
+        }
+
+      sacklen = nsacks * sizeof(struct tcp_sack_s);
+
+      optdata[0] = TCP_OPT_NOOP;
+      optdata[1] = TCP_OPT_NOOP;
+      optdata[2] = TCP_OPT_SACK;
+      optdata[3] = TCP_OPT_SACK_PERM_LEN + sacklen;
 
-      optlen += 4;
+      sacklen += 4;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
                 conn->ofosegs[i].left, conn->ofosegs[i].right,
                 TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
-          tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
+          tcp_setsequence(&optdata[4 + i * 2 * sizeof(uint32_t)],
                           conn->ofosegs[i].left);
-          tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
+          tcp_setsequence(&optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
                           conn->ofosegs[i].right);
         }
 
-      dev->d_len += optlen;
-      tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+      dev->d_len += sacklen;
+      optlen     += sacklen;
     }
-  else
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
-    {
-      tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
-    }
+
+  tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   tcp_sendcommon(dev, conn, tcp);
 
@@ -623,9 +687,12 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   tcp = tcp_header(dev);
 
-  /* Set the packet length for the TCP Maximum Segment Size */
+  /* Set the packet length for the TCP Maximum Segment Size.  The options
+   * are appended one by one below, including the Timestamps option that
+   * tcpip_hdrsize() already accounts for once it has been negotiated.
+   */
 
-  dev->d_len = tcpip_hdrsize(conn);
+  dev->d_len = tcpip_hdrsize(conn) - TCP_TS_OPTLEN(conn);
 
   /* Set the packet length for the TCP Maximum Segment Size */
 
@@ -673,6 +740,13 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMP
+  if (tcp->flags == TCP_SYN || (conn->flags & TCP_TSTAMP) != 0)
+    {
+      optlen += tcp_set_timestamp(conn, &tcp->optdata[optlen]);
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -750,7 +824,7 @@ void tcp_send_txnotify(FAR struct socket *psock,
 
 uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn)
 {
-  uint16_t hdrsize = sizeof(struct tcp_hdr_s);
+  uint16_t hdrsize = sizeof(struct tcp_hdr_s) + TCP_TS_OPTLEN(conn);
 
   UNUSED(conn);
   return net_ip_domain_select(conn->domain,
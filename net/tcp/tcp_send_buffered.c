@@ -141,6 +141,39 @@ static void psock_insert_segment(FAR struct tcp_wrbuffer_s *wrb,
     }
 }
 
+/****************************************************************************
+ * Name: tcp_gso_maxlen
+ *
+ * Description:
+ *   Calculate the payload size of the next TCP super-segment.  The result
+ *   is a multiple of the MSS, and leaves enough free IOBs for the copy made
+ *   when the super-segment is split.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_GSO
+static uint32_t tcp_gso_maxlen(FAR struct tcp_conn_s *conn)
+{
+  const uint32_t mss = conn->mss;
+  uint32_t limit;
+  uint32_t size;
+
+  size  = tcp_gso_maxsize(conn);
+  limit = iob_navail(false) * CONFIG_IOB_BUFSIZE / 2;
+  if (size > limit)
+    {
+      size = limit;
+    }
+
+  if (size <= mss)
+    {
+      return mss;
+    }
+
+  return size - size % mss;
+}
+#endif
+
 /****************************************************************************
  * Name: psock_writebuffer_notify
  *
@@ -411,6 +444,168 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+#ifdef CONFIG_NET_TCP_RACK
+/****************************************************************************
+ * Name: psock_rack_update
+ *
+ * Description:
+ *   A write buffer has been delivered (cumulatively ACKed or SACKed).
+ *   Remember the most recently sent delivered write buffer and its RTT
+ *   (RFC 8985, section 6.2).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The delivered write buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void psock_rack_update(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_wrbuffer_s *wrb)
+{
+  uint32_t rtt;
+
+  /* The ACK of a retransmitted write buffer may have been triggered by the
+   * original transmission.  Only use it if the echoed timestamp proves
+   * that the retransmission was delivered.
+   */
+
+  if (TCP_WBNRTX(wrb) > 0 && TCP_TS_LT(conn->ts_ecr, TCP_WBXMIT(wrb)))
+    {
+      return;
+    }
+
+  rtt = MAX(TCP_TSCLOCK() - TCP_WBXMIT(wrb), 1);
+  if (conn->rack_minrtt == 0 || rtt < conn->rack_minrtt)
+    {
+      conn->rack_minrtt = rtt;
+    }
+
+  if (conn->rack_rtt == 0 || TCP_TS_GTE(TCP_WBXMIT(wrb), conn->rack_xmit))
+    {
+      conn->rack_xmit = TCP_WBXMIT(wrb);
+      conn->rack_rtt  = rtt;
+    }
+}
+
+/****************************************************************************
+ * Name: psock_rack_detect_loss
+ *
+ * Description:
+ *   Apply the RACK loss detection (RFC 8985, section 6.2) on receipt of an
+ *   ACK: write buffers covered by the SACK blocks are delivered, and every
+ *   un-ACKed write buffer that was sent before the most recently delivered
+ *   one, and longer than one RTT plus the reordering window ago, is lost
+ *   and is queued for retransmission.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tcp    - Header of the incoming TCP segment
+ *
+ * Returned Value:
+ *   true if any write buffer was queued for retransmission
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static bool psock_rack_detect_loss(FAR struct tcp_conn_s *conn,
+                                   FAR struct tcp_hdr_s *tcp)
+{
+  struct tcp_ofoseg_s segs[TCP_SACK_RANGES_MAX];
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  uint32_t reo_wnd;
+  uint32_t now;
+  uint32_t lastseq;
+  bool lost = false;
+  int nsacks = 0;
+  int i;
+
+  if ((tcp->tcpoffset & 0xf0) > 0x50)
+    {
+      nsacks = parse_sack(conn, tcp, segs);
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+    {
+      wrb     = (FAR struct tcp_wrbuffer_s *)entry;
+      lastseq = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(lastseq, segs[i].right))
+            {
+              psock_rack_update(conn, wrb);
+              break;
+            }
+        }
+    }
+
+  if (conn->rack_rtt == 0)
+    {
+      return false;
+    }
+
+  /* The reordering window defaults to a quarter of the minimum RTT */
+
+  reo_wnd = conn->rack_minrtt >> 2;
+  now     = TCP_TSCLOCK();
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      wrb     = (FAR struct tcp_wrbuffer_s *)entry;
+      next    = sq_next(entry);
+      lastseq = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+
+      /* Write buffers sent in the same millisecond as the most recently
+       * delivered one can't be ordered by time; leave those to the other
+       * recovery mechanisms.
+       */
+
+      if (!TCP_TS_LT(TCP_WBXMIT(wrb), conn->rack_xmit) ||
+          now - TCP_WBXMIT(wrb) < conn->rack_rtt + reo_wnd)
+        {
+          continue;
+        }
+
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(lastseq, segs[i].right))
+            {
+              break;
+            }
+        }
+
+      if (i < nsacks)
+        {
+          /* Already delivered, don't retransmit */
+
+          continue;
+        }
+
+      ninfo("RACK: wrb=%p seqno=%" PRIu32 " lost, xmit=%" PRIu32
+            " rack_xmit=%" PRIu32 "\n", wrb, TCP_WBSEQNO(wrb),
+            TCP_WBXMIT(wrb), conn->rack_xmit);
+
+      sq_rem(entry, &conn->unacked_q);
+      retransmit_segment(conn, wrb);
+      lost = true;
+    }
+
+  return lost;
+}
+#endif /* CONFIG_NET_TCP_RACK */
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -542,6 +737,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   ninfo("ACK: wrb=%p Freeing write buffer\n", wrb);
 
+#ifdef CONFIG_NET_TCP_RACK
+                  psock_rack_update(conn, wrb);
+#endif
+
                   /* Yes... Remove the write buffer from ACK waiting queue */
 
                   sq_rem(entry, &conn->unacked_q);
@@ -700,6 +899,30 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_RACK
+      /* Time-based loss detection needs both timestamps (to validate
+       * deliveries of retransmitted data) and SACK (to learn which of the
+       * later write buffers were delivered).
+       */
+
+      if ((conn->flags & (TCP_TSTAMP | TCP_SACK)) ==
+          (TCP_TSTAMP | TCP_SACK) &&
+          (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+          psock_rack_detect_loss(conn, tcp))
+        {
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+          if (conn->flags & TCP_INFT)
+            {
+              tcp_cc_update(conn, NULL);
+            }
+#endif
+
+          /* Reset the retransmission timer. */
+
+          tcp_update_retrantimer(conn, conn->rto);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -797,6 +1020,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb) = TCP_TSCLOCK();
+#endif
+
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
           /* After Fast retransmitted, set ssthresh to the maximum of
            * the unacked and the 2*SMSS, and enter to Fast Recovery.
@@ -1062,10 +1289,17 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           int ret;
 
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
+#ifdef CONFIG_NET_TCP_GSO
+          if (sndlen > tcp_gso_maxlen(conn))
+            {
+              sndlen = tcp_gso_maxlen(conn);
+            }
+#else
           if (sndlen > conn->mss)
             {
               sndlen = conn->mss;
             }
+#endif
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
           if (sndlen > remaining_snd_wnd)
@@ -1128,10 +1362,21 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NET_TCP_GSO
+          /* A super-segment is split into MSS-sized segments on its way to
+           * the device.
+           */
+
+          dev->d_gsosize = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NET_TCP_GSO
+              dev->d_gsosize = 0;
+#endif
               return flags;
             }
 
@@ -1144,6 +1389,10 @@ static uint32_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
 
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb)   = TCP_TSCLOCK();
+#endif
+
           /* Below prediction will become true,
            * unless retransmission occurrence
            */
@@ -1223,6 +1472,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NET_TCP_GSO
+  /* or enough to fill a whole super-segment */
+
+  if (size < CONFIG_NET_TCP_GSO_MAXSIZE - tcpip_hdrsize(conn))
+    {
+      size = CONFIG_NET_TCP_GSO_MAXSIZE - tcpip_hdrsize(conn);
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1559,6 +1817,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
           TCP_WBSEQNO(wrb) = (unsigned)-1;
           TCP_WBNRTX(wrb)  = 0;
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb)  = 0;
+#endif
 
           off = TCP_WBPKTLEN(wrb);
           if (off + chunk_len > max_wrb_size)
@@ -112,6 +112,8 @@ static dq_queue_t g_active_udp_connections;
  *   portno - The port to use in the lookup
  *   opt    - The option from another conn to match the conflict conn
  *              SO_REUSEADDR: If both sockets have this, they never conflict.
+ *              SO_REUSEPORT: Likewise, the sockets form a load balancing
+ *                            group.
  *
  * Assumptions:
  *   This function must be called with the network locked.
@@ -126,6 +128,9 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 #ifdef CONFIG_NET_SOCKOPTS
   bool skip_reusable = _SO_GETOPT(opt, SO_REUSEADDR);
 #endif
+#ifdef CONFIG_NET_REUSEPORT
+  bool skip_reuseport = _SO_GETOPT(opt, SO_REUSEPORT);
+#endif
 
   /* Now search each connection structure. */
 
@@ -143,6 +148,13 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
         }
 #endif
 
+#ifdef CONFIG_NET_REUSEPORT
+      if (skip_reuseport && _SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+        {
+          continue;
+        }
+#endif
+
       /* If the port local port number assigned to the connections matches
        * AND the IP address of the connection matches, then return a
        * reference to the connection structure.  INADDR_ANY is a special
@@ -680,6 +692,84 @@ FAR struct udp_conn_s *udp_active(FAR struct net_driver_s *dev,
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: udp_reuseport_select
+ *
+ * Description:
+ *   The connection returned by udp_active() is part of a SO_REUSEPORT
+ *   group.  Select the member of the group that receives the datagram by a
+ *   hash of its source address and port, so that all datagrams of a flow
+ *   reach the same socket.
+ *
+ * Input Parameters:
+ *   dev  - The device that received the datagram
+ *   conn - The first connection matching the datagram
+ *   udp  - The UDP header of the datagram
+ *
+ * Returned Value:
+ *   The selected connection; conn itself if it is not part of a group.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+FAR struct udp_conn_s *udp_reuseport_select(FAR struct net_driver_s *dev,
+                                            FAR struct udp_conn_s *conn,
+                                            FAR struct udp_hdr_s *udp)
+{
+  FAR struct udp_conn_s *member = NULL;
+  uint32_t nmembers = 0;
+  uint32_t hash;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
+
+  while ((member = udp_active(dev, member, udp)) != NULL)
+    {
+      if (_SO_GETOPT(member->sconn.s_options, SO_REUSEPORT))
+        {
+          nmembers++;
+        }
+    }
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      hash = net_flowhash(IPv6BUF->srcipaddr, sizeof(net_ipv6addr_t),
+                          udp->srcport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      hash = net_flowhash(IPv4BUF->srcipaddr, sizeof(in_addr_t),
+                          udp->srcport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+  hash %= nmembers;
+
+  while ((member = udp_active(dev, member, udp)) != NULL)
+    {
+      if (_SO_GETOPT(member->sconn.s_options, SO_REUSEPORT) && hash-- == 0)
+        {
+          return member;
+        }
+    }
+
+  return conn;
+}
+#endif /* CONFIG_NET_REUSEPORT */
+
 /****************************************************************************
  * Name: udp_conn_list_lock
  *
@@ -342,6 +342,17 @@ static int udp_input(FAR struct net_driver_s *dev, unsigned int iplen)
             }
 #endif
 
+#ifdef CONFIG_NET_REUSEPORT
+          /* Unicast datagrams go to one member of a SO_REUSEPORT group */
+
+#  ifdef CONFIG_NET_BROADCAST
+          if (!udp_is_broadcast(dev))
+#  endif
+            {
+              conn = udp_reuseport_select(dev, conn, udp);
+            }
+#endif
+
           /* We can deliver the packet directly to the last listener. */
 
           ret = udp_input_conn(dev, conn, udpiplen);
@@ -0,0 +1,92 @@
+/****************************************************************************
+ * net/utils/net_flowhash.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "utils/utils.h"
+
+#ifdef CONFIG_NET_REUSEPORT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* 32-bit FNV-1a parameters */
+
+#define FLOWHASH_BASIS 2166136261u
+#define FLOWHASH_PRIME 16777619u
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Calculate a hash over a remote address and port.  Used to spread the
+ *   flows arriving on a port across the sockets of a SO_REUSEPORT group;
+ *   the same peer always maps to the same value.
+ *
+ * Input Parameters:
+ *   addr    - The remote IP address
+ *   addrlen - Size of the address in bytes
+ *   port    - The remote port number
+ *
+ * Returned Value:
+ *   The 32-bit hash value.
+ *
+ ****************************************************************************/
+
+uint32_t net_flowhash(FAR const void *addr, size_t addrlen, uint16_t port)
+{
+  FAR const uint8_t *ptr = addr;
+  uint32_t hash = FLOWHASH_BASIS;
+  size_t i;
+
+  for (i = 0; i < addrlen; i++)
+    {
+      hash = (hash ^ ptr[i]) * FLOWHASH_PRIME;
+    }
+
+  hash = (hash ^ (port & 0xff)) * FLOWHASH_PRIME;
+  hash = (hash ^ (port >> 8)) * FLOWHASH_PRIME;
+
+  /* Final avalanche so that the low bits used for the modulo depend on
+   * every input byte.
+   */
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+
+  return hash;
+}
+
+#endif /* CONFIG_NET_REUSEPORT */
@@ -642,6 +642,28 @@ uint16_t icmp_chksum_iob(FAR struct iob_s *iob);
 uint16_t icmpv6_chksum(FAR struct net_driver_s *dev, unsigned int iplen);
 #endif
 
+/****************************************************************************
+ * Name: net_flowhash
+ *
+ * Description:
+ *   Calculate a hash over a remote address and port.  Used to spread the
+ *   flows arriving on a port across the sockets of a SO_REUSEPORT group;
+ *   the same peer always maps to the same value.
+ *
+ * Input Parameters:
+ *   addr    - The remote IP address
+ *   addrlen - Size of the address in bytes
+ *   port    - The remote port number
+ *
+ * Returned Value:
+ *   The 32-bit hash value.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_REUSEPORT
+uint32_t net_flowhash(FAR const void *addr, size_t addrlen, uint16_t port);
+#endif
+
 /****************************************************************************
  * Name: cmsg_append
  *
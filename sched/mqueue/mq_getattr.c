@@ -79,6 +79,14 @@ int file_mq_getattr(FAR struct file *mq, FAR struct mq_attr *mq_stat)
   mq_stat->mq_flags   = mq->f_oflags;
   mq_stat->mq_curmsgs = msgq->nmsgs;
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      mq_stat->mq_flags  |= MQ_RING;
+      mq_stat->mq_curmsgs = nxmq_ring_count(msgq);
+    }
+#endif
+
   return 0;
 }
 
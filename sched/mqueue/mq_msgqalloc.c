@@ -104,6 +104,19 @@ int nxmq_alloc_msgq(FAR struct mq_attr *attr,
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
 
+#ifdef CONFIG_MQ_RING
+      if (attr && (attr->mq_flags & MQ_RING) != 0)
+        {
+          int ret = nxmq_ring_alloc(msgq);
+
+          if (ret < 0)
+            {
+              kmm_free(msgq);
+              return ret;
+            }
+        }
+#endif
+
       dq_init(&msgq->cmn.waitfornotempty);
       dq_init(&msgq->cmn.waitfornotfull);
     }
@@ -134,6 +134,19 @@ int mq_notify(mqd_t mqdes, FAR const struct sigevent *notification)
   /* Is there already a notification attached */
 
   msgq = inode->i_private;
+
+#ifdef CONFIG_MQ_RING
+  /* The lock-free ring does not track the empty to non-empty transition
+   * needed for notifications.
+   */
+
+  if (msgq->ring != NULL)
+    {
+      errval = ENOTSUP;
+      goto errout;
+    }
+#endif
+
   if (msgq->ntpid == INVALID_PROCESS_ID)
     {
       /* No... Have we been asked to establish one? */
@@ -35,6 +35,7 @@
 #include <fcntl.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/arch.h>
 #include <nuttx/mqueue.h>
 #include <nuttx/cancelpt.h>
@@ -105,71 +106,36 @@ static int nxmq_verify_receive(FAR struct file *mq,
 #endif
 
 /****************************************************************************
- * Name: file_mq_timedreceive_internal
+ * Name: nxmq_get_msg
  *
  * Description:
- *   This is an internal function of file_mq_timedreceive()/
- *   file_mq_tickreceive(), please refer to the detailed description for
- *   more information.
+ *   Remove the oldest of the highest priority messages from the message
+ *   queue, waiting for one if the queue is empty and O_NONBLOCK is not set.
+ *   The message is owned by the caller and must be released with
+ *   nxmq_free_msg().
  *
  * Input Parameters:
  *   mq      - Message Queue Descriptor
- *   msg     - Buffer to receive the message
- *   msglen  - Size of the buffer in bytes
- *   prio    - If not NULL, the location to store message priority.
+ *   rcvmsg  - The location to return the message
  *   abstime - the absolute time to wait until a timeout is declared.
+ *   ticks   - Ticks to wait, used if abstime is NULL.
+ *   nowait  - Return -EAGAIN if the queue is empty, even without
+ *             O_NONBLOCK.
  *
  * Returned Value:
- *   On success, the length of the selected message in bytes is returned.
- *   On failure, -1 (ERROR) is returned and the errno is set appropriately:
- *
- *   EAGAIN    The queue was empty, and the O_NONBLOCK flag was set
- *             for the message queue description referred to by 'mqdes'.
- *   EPERM     Message queue opened not opened for reading.
- *   EMSGSIZE  'msglen' was less than the maxmsgsize attribute of the
- *             message queue.
- *   EINTR     The call was interrupted by a signal handler.
- *   EINVAL    Invalid 'msg' or 'mqdes' or 'abstime'
- *   ETIMEDOUT The call timed out before a message could be transferred.
+ *   Zero (OK) on success.  A negated errno value on failure.
  *
  ****************************************************************************/
 
-static
-ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
-                                      size_t msglen, FAR unsigned int *prio,
-                                      FAR const struct timespec *abstime,
-                                      clock_t ticks)
+static int nxmq_get_msg(FAR struct file *mq,
+                        FAR struct mqueue_msg_s **rcvmsg,
+                        FAR const struct timespec *abstime, clock_t ticks,
+                        bool nowait)
 {
-  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_inode_s *msgq = mq->f_inode->i_private;
   FAR struct mqueue_msg_s *mqmsg;
   irqstate_t flags;
-  ssize_t ret = 0;
-
-  /* Verify the input parameters */
-
-  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
-    {
-      return -EINVAL;
-    }
-
-  if (mq == NULL)
-    {
-      return -EINVAL;
-    }
-
-#ifdef CONFIG_DEBUG_FEATURES
-  /* Verify the input parameters and, in case of an error, set
-   * errno appropriately.
-   */
-
-  ret = nxmq_verify_receive(mq, msg, msglen);
-  if (ret < 0)
-    {
-      return ret;
-    }
-#endif
-
-  msgq = mq->f_inode->i_private;
+  int ret;
 
   /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
    * because messages can be sent from interrupt level.
@@ -179,10 +145,10 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   /* Get the message from the message queue */
 
-  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+  mqmsg = nxmq_remove_msg(msgq);
   if (mqmsg == NULL)
     {
-      if ((mq->f_oflags & O_NONBLOCK) != 0)
+      if (nowait || (mq->f_oflags & O_NONBLOCK) != 0)
         {
           leave_critical_section(flags);
           return -EAGAIN;
@@ -221,6 +187,27 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
 
   leave_critical_section(flags);
 
+  *rcvmsg = mqmsg;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_copy_msg
+ *
+ * Description:
+ *   Copy a message obtained with nxmq_get_msg() to the caller buffer and
+ *   free it.
+ *
+ * Returned Value:
+ *   The length of the message in bytes.
+ *
+ ****************************************************************************/
+
+static ssize_t nxmq_copy_msg(FAR struct mqueue_msg_s *mqmsg, FAR char *msg,
+                             FAR unsigned int *prio)
+{
+  ssize_t ret;
+
   /* Return the message to the caller */
 
   if (prio)
@@ -238,6 +225,91 @@ ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
   return ret;
 }
 
+/****************************************************************************
+ * Name: file_mq_timedreceive_internal
+ *
+ * Description:
+ *   This is an internal function of file_mq_timedreceive()/
+ *   file_mq_tickreceive(), please refer to the detailed description for
+ *   more information.
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   msg     - Buffer to receive the message
+ *   msglen  - Size of the buffer in bytes
+ *   prio    - If not NULL, the location to store message priority.
+ *   abstime - the absolute time to wait until a timeout is declared.
+ *
+ * Returned Value:
+ *   On success, the length of the selected message in bytes is returned.
+ *   On failure, -1 (ERROR) is returned and the errno is set appropriately:
+ *
+ *   EAGAIN    The queue was empty, and the O_NONBLOCK flag was set
+ *             for the message queue description referred to by 'mqdes'.
+ *   EPERM     Message queue opened not opened for reading.
+ *   EMSGSIZE  'msglen' was less than the maxmsgsize attribute of the
+ *             message queue.
+ *   EINTR     The call was interrupted by a signal handler.
+ *   EINVAL    Invalid 'msg' or 'mqdes' or 'abstime'
+ *   ETIMEDOUT The call timed out before a message could be transferred.
+ *
+ ****************************************************************************/
+
+static
+ssize_t file_mq_timedreceive_internal(FAR struct file *mq, FAR char *msg,
+                                      size_t msglen, FAR unsigned int *prio,
+                                      FAR const struct timespec *abstime,
+                                      clock_t ticks)
+{
+#ifdef CONFIG_MQ_RING
+  FAR struct mqueue_inode_s *msgq;
+#endif
+  FAR struct mqueue_msg_s *mqmsg;
+  ssize_t ret = 0;
+
+  /* Verify the input parameters */
+
+  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
+    {
+      return -EINVAL;
+    }
+
+  if (mq == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_DEBUG_FEATURES
+  /* Verify the input parameters and, in case of an error, set
+   * errno appropriately.
+   */
+
+  ret = nxmq_verify_receive(mq, msg, msglen);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
+#ifdef CONFIG_MQ_RING
+  msgq = mq->f_inode->i_private;
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_receive(msgq, msg, prio, abstime, ticks,
+                               up_interrupt_context() ||
+                               (mq->f_oflags & O_NONBLOCK) != 0);
+    }
+#endif
+
+  ret = nxmq_get_msg(mq, &mqmsg, abstime, ticks, false);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return nxmq_copy_msg(mqmsg, msg, prio);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -388,6 +460,145 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
   return ret;
 }
 
+/****************************************************************************
+ * Name: file_mq_timedreceive_ref
+ *
+ * Description:
+ *   This function receives the oldest of the highest priority messages from
+ *   the message queue specified by "mq" like file_mq_timedreceive(), but
+ *   instead of copying the message into a caller buffer it returns a
+ *   reference to the message data held by the message queue.  The message
+ *   stays valid until it is released with file_mq_release_ref(), which
+ *   must be called exactly once for each message received this way.
+ *
+ *   The message data lives in kernel memory, so this interface is only
+ *   usable from within the OS (or in a FLAT build).
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   msg     - The location to return the reference to the message data
+ *   prio    - If not NULL, the location to store message priority.
+ *   abstime - the absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever.
+ *
+ * Returned Value:
+ *   On success, the length of the selected message in bytes is returned.
+ *   A negated errno value is returned on failure (see
+ *   file_mq_timedreceive() for the list of values).
+ *
+ ****************************************************************************/
+
+ssize_t file_mq_timedreceive_ref(FAR struct file *mq, FAR char **msg,
+                                 FAR unsigned int *prio,
+                                 FAR const struct timespec *abstime)
+{
+#ifdef CONFIG_MQ_RING
+  FAR struct mqueue_inode_s *msgq;
+#endif
+  FAR struct mqueue_msg_s *mqmsg;
+  int ret;
+
+  if (abstime && (abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000))
+    {
+      return -EINVAL;
+    }
+
+  if (mq == NULL || msg == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (mq->f_inode == NULL || mq->f_inode->i_private == NULL ||
+      (mq->f_oflags & O_RDOK) == 0)
+    {
+      return -EBADF;
+    }
+
+#ifdef CONFIG_MQ_RING
+  /* Ring slots are reused as soon as they are received */
+
+  msgq = mq->f_inode->i_private;
+  if (msgq->ring != NULL)
+    {
+      return -ENOTSUP;
+    }
+#endif
+
+  ret = nxmq_get_msg(mq, &mqmsg, abstime, -1, false);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  *msg = mqmsg->mail;
+  return mqmsg->msglen;
+}
+
+/****************************************************************************
+ * Name: nxmq_timedreceive_ref
+ *
+ * Description:
+ *   Same as file_mq_timedreceive_ref(), but takes a message queue
+ *   descriptor.
+ *
+ * Input Parameters:
+ *   mqdes   - Message Queue Descriptor
+ *   msg     - The location to return the reference to the message data
+ *   prio    - If not NULL, the location to store message priority.
+ *   abstime - the absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever.
+ *
+ * Returned Value:
+ *   On success, the length of the selected message in bytes is returned.
+ *   A negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_timedreceive_ref(mqd_t mqdes, FAR char **msg,
+                              FAR unsigned int *prio,
+                              FAR const struct timespec *abstime)
+{
+  FAR struct file *filep;
+  ssize_t ret;
+
+  ret = file_get(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_timedreceive_ref(filep, msg, prio, abstime);
+  file_put(filep);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: file_mq_release_ref
+ *
+ * Description:
+ *   Release a message obtained with file_mq_timedreceive_ref() or
+ *   nxmq_timedreceive_ref().  The message data must not be accessed
+ *   afterwards.
+ *
+ * Input Parameters:
+ *   msg - The message data reference returned on receive
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void file_mq_release_ref(FAR char *msg)
+{
+  DEBUGASSERT(msg != NULL);
+  nxmq_free_msg(container_of(msg, struct mqueue_msg_s, mail));
+}
+
 /****************************************************************************
  * Name: mq_timedreceive
  *
@@ -597,3 +808,186 @@ ssize_t mq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
   leave_cancellation_point();
   return ret;
 }
+
+/****************************************************************************
+ * Name: file_mq_receive_many
+ *
+ * Description:
+ *   Receive up to vlen messages from the message queue specified by "mq".
+ *   This waits (unless O_NONBLOCK is set) only until the first message is
+ *   available and then takes whatever else is already queued.
+ *
+ *   file_mq_receive_many() is an internal OS interface.  It is
+ *   functionally equivalent to mq_receive_many() except that:
+ *
+ *   - It is not a cancellation point, and
+ *   - It does not modify the errno value.
+ *
+ * Input Parameters:
+ *   mq      - Message Queue Descriptor
+ *   vec     - Array of message buffers
+ *   vlen    - Number of entries in vec
+ *   abstime - the absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever.
+ *
+ * Returned Value:
+ *   The number of messages received on success.  A negated errno value
+ *   on failure (see mq_timedreceive() for the list valid return values).
+ *
+ ****************************************************************************/
+
+int file_mq_receive_many(FAR struct file *mq, FAR struct mq_msgbuf *vec,
+                         unsigned int vlen,
+                         FAR const struct timespec *abstime)
+{
+#ifdef CONFIG_MQ_RING
+  FAR struct mqueue_inode_s *msgq;
+#endif
+  FAR struct mqueue_msg_s *mqmsg;
+  unsigned int i;
+  ssize_t ret;
+
+  if (vec == NULL || vlen == 0)
+    {
+      return -EINVAL;
+    }
+
+  /* The first message is received just like with mq_timedreceive() */
+
+  ret = file_mq_timedreceive_internal(mq, vec[0].msg, vec[0].msglen,
+                                      &vec[0].prio, abstime, -1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  vec[0].len = ret;
+
+#ifdef CONFIG_MQ_RING
+  msgq = mq->f_inode->i_private;
+#endif
+
+  /* Then drain the queue without waiting */
+
+  for (i = 1; i < vlen; i++)
+    {
+#ifdef CONFIG_DEBUG_FEATURES
+      if (nxmq_verify_receive(mq, vec[i].msg, vec[i].msglen) < 0)
+        {
+          break;
+        }
+#endif
+
+#ifdef CONFIG_MQ_RING
+      if (msgq->ring != NULL)
+        {
+          ret = nxmq_ring_receive(msgq, vec[i].msg, &vec[i].prio,
+                                  NULL, -1, true);
+        }
+      else
+#endif
+        {
+          ret = nxmq_get_msg(mq, &mqmsg, NULL, -1, true);
+          if (ret >= 0)
+            {
+              ret = nxmq_copy_msg(mqmsg, vec[i].msg, &vec[i].prio);
+            }
+        }
+
+      if (ret < 0)
+        {
+          break;
+        }
+
+      vec[i].len = ret;
+    }
+
+  return i;
+}
+
+/****************************************************************************
+ * Name: nxmq_receive_many
+ *
+ * Description:
+ *   Same as file_mq_receive_many(), but takes a message queue descriptor.
+ *
+ * Input Parameters:
+ *   mqdes   - Message Queue Descriptor
+ *   vec     - Array of message buffers
+ *   vlen    - Number of entries in vec
+ *   abstime - the absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever.
+ *
+ * Returned Value:
+ *   The number of messages received on success.  A negated errno value
+ *   on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_receive_many(mqd_t mqdes, FAR struct mq_msgbuf *vec,
+                      unsigned int vlen, FAR const struct timespec *abstime)
+{
+  FAR struct file *filep;
+  int ret;
+
+  ret = file_get(mqdes, &filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = file_mq_receive_many(filep, vec, vlen, abstime);
+  file_put(filep);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receive_many
+ *
+ * Description:
+ *   This non-standard function receives up to "vlen" messages from the
+ *   message queue specified by "mqdes" with one call.  If the message
+ *   queue is empty and O_NONBLOCK was not set, mq_receive_many() blocks
+ *   until a message is added to the message queue or until the absolute
+ *   time "abstime" (if not NULL) is reached.  Once one message is
+ *   available, it returns with that message and any further messages that
+ *   are already queued, up to "vlen".
+ *
+ *   For each received message, the length and priority are returned in
+ *   the len and prio fields of the corresponding entry of "vec".  The size
+ *   of each buffer (msglen) must not be less than the "mq_msgsize"
+ *   attribute of the message queue.
+ *
+ * Input Parameters:
+ *   mqdes   - Message Queue Descriptor
+ *   vec     - Array of message buffers
+ *   vlen    - Number of entries in vec
+ *   abstime - the absolute time to wait until a timeout is declared, or
+ *             NULL to wait forever.
+ *
+ * Returned Value:
+ *   On success, the number of messages received is returned.
+ *   On failure, -1 (ERROR) is returned and the errno is set appropriately
+ *   (see mq_timedreceive()).
+ *
+ ****************************************************************************/
+
+int mq_receive_many(mqd_t mqdes, FAR struct mq_msgbuf *vec,
+                    unsigned int vlen, FAR const struct timespec *abstime)
+{
+  int ret;
+
+  /* mq_receive_many() is a cancellation point */
+
+  enter_cancellation_point();
+
+  ret = nxmq_receive_many(mqdes, vec, vlen, abstime);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
@@ -86,4 +86,13 @@ void nxmq_recover(FAR struct tcb_s *tcb)
       DEBUGASSERT(msgq && msgq->cmn.nwaitnotfull > 0);
       msgq->cmn.nwaitnotfull--;
     }
+
+#ifdef CONFIG_MQ_RING
+  /* A task sleeping on a message ring waits on one of its semaphores */
+
+  else
+    {
+      nxmq_ring_recover(tcb);
+    }
+#endif
 }
@@ -0,0 +1,640 @@
+/****************************************************************************
+ * sched/mqueue/mq_ring.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/list.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
+#include <nuttx/semaphore.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_RING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The ring size is a power of two and positions are compared as signed
+ * 32-bit differences, so keep well below 2^31 slots.
+ */
+
+#define MQ_RING_MAXSLOTS  16384
+
+#define MQ_RING_SLOT(r, pos) \
+  ((FAR struct mqueue_slot_s *)((FAR uint8_t *)((r) + 1) + \
+                                ((pos) & (r)->mask) * (r)->slotsize))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* All rings, so that nxmq_ring_recover() can find the ring that a deleted
+ * task was sleeping on.  Protected by the critical section.
+ */
+
+static struct list_node g_mq_rings = LIST_INITIAL_VALUE(g_mq_rings);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_put
+ *
+ * Description:
+ *   Claim the slot at head and copy the message into it.  The position of
+ *   the slot is returned in ppos.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, or -EAGAIN if the ring is full.
+ *
+ ****************************************************************************/
+
+static int nxmq_ring_put(FAR struct mqueue_ring_s *ring,
+                         FAR const char *msg, size_t msglen,
+                         unsigned int prio, FAR uint32_t *ppos)
+{
+  FAR struct mqueue_slot_s *slot;
+  uint32_t pos = atomic_read(&ring->head);
+  int32_t diff;
+
+  for (; ; )
+    {
+      slot = MQ_RING_SLOT(ring, pos);
+      diff = (int32_t)(atomic_read_acquire(&slot->seq) - pos);
+      if (diff == 0)
+        {
+          /* The slot is free, try to claim it */
+
+          if (atomic_try_cmpxchg(&ring->head, &pos, pos + 1))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* The slot still holds the message of the previous round */
+
+          return -EAGAIN;
+        }
+      else
+        {
+          /* Another sender claimed the slot first */
+
+          pos = atomic_read(&ring->head);
+        }
+    }
+
+  memcpy(slot->mail, msg, msglen);
+  slot->msglen   = msglen;
+  slot->priority = prio;
+
+  /* Publish the message */
+
+  atomic_set_release(&slot->seq, pos + 1);
+  *ppos = pos;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_get
+ *
+ * Description:
+ *   Claim the slot at tail and copy the message out of it.  The position
+ *   of the slot is returned in ppos.
+ *
+ * Returned Value:
+ *   Zero (OK) on success, or -EAGAIN if the ring is empty.
+ *
+ ****************************************************************************/
+
+static int nxmq_ring_get(FAR struct mqueue_ring_s *ring,
+                         FAR char *msg, FAR size_t *msglen,
+                         FAR unsigned int *prio, FAR uint32_t *ppos)
+{
+  FAR struct mqueue_slot_s *slot;
+  uint32_t pos = atomic_read(&ring->tail);
+  int32_t diff;
+
+  for (; ; )
+    {
+      slot = MQ_RING_SLOT(ring, pos);
+      diff = (int32_t)(atomic_read_acquire(&slot->seq) - (pos + 1));
+      if (diff == 0)
+        {
+          if (atomic_try_cmpxchg(&ring->tail, &pos, pos + 1))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          /* Nothing published in this slot yet */
+
+          return -EAGAIN;
+        }
+      else
+        {
+          pos = atomic_read(&ring->tail);
+        }
+    }
+
+  *msglen = slot->msglen;
+  if (prio)
+    {
+      *prio = slot->priority;
+    }
+
+  memcpy(msg, slot->mail, slot->msglen);
+
+  /* Hand the slot back to the senders for the next round */
+
+  atomic_set_release(&slot->seq, pos + ring->mask + 1);
+  *ppos = pos;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_wake
+ *
+ * Description:
+ *   Wake up one task sleeping in nxmq_ring_sleep(), if any.  The waiter
+ *   count is read with a read-modify-write operation so that it is ordered
+ *   after the slot update that the waiter is waiting for.
+ *
+ ****************************************************************************/
+
+static void nxmq_ring_wake(FAR atomic_t *nwait, FAR sem_t *sem)
+{
+  int32_t n = atomic_fetch_add(nwait, 0);
+
+  while (n > 0)
+    {
+      if (atomic_try_cmpxchg(nwait, &n, n - 1))
+        {
+          nxsem_post(sem);
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_unwait
+ *
+ * Description:
+ *   Withdraw a registration made before sleeping.  If a waker already
+ *   consumed it, the matching post is absorbed so that it does not wake
+ *   the next sleeper for nothing.
+ *
+ * Returned Value:
+ *   true if a wake up was absorbed, i.e. the ring changed state meanwhile.
+ *
+ ****************************************************************************/
+
+static bool nxmq_ring_unwait(FAR atomic_t *nwait, FAR sem_t *sem)
+{
+  int32_t n = atomic_read(nwait);
+
+  while (n > 0)
+    {
+      if (atomic_try_cmpxchg(nwait, &n, n - 1))
+        {
+          return false;
+        }
+    }
+
+  /* The waker has decremented the count and posts right after */
+
+  nxsem_wait_uninterruptible(sem);
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_sleep
+ *
+ * Description:
+ *   Sleep on sem with the timeout of the caller.  For a relative timeout,
+ *   the time already spent since start is deducted.
+ *
+ ****************************************************************************/
+
+static int nxmq_ring_sleep(FAR sem_t *sem,
+                           FAR const struct timespec *abstime,
+                           clock_t ticks, clock_t start)
+{
+  clock_t elapsed;
+
+  if (abstime)
+    {
+      return nxsem_clockwait(sem, CLOCK_REALTIME, abstime);
+    }
+  else if (ticks >= 0)
+    {
+      elapsed = clock_systime_ticks() - start;
+      if (elapsed >= ticks)
+        {
+          return -ETIMEDOUT;
+        }
+
+      return nxsem_tickwait(sem, ticks - elapsed);
+    }
+
+  return nxsem_wait(sem);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_ring_alloc
+ *
+ * Description:
+ *   Allocate the message ring of a message queue created with MQ_RING.
+ *   The number of slots is msgq->maxmsgs rounded up to a power of two,
+ *   msgq->maxmsgs is updated accordingly.
+ *
+ * Input Parameters:
+ *   msgq - The message queue, maxmsgs and maxmsgsize already set.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EINVAL if the queue is too large for a ring,
+ *   -ENOSPC if the ring could not be allocated.
+ *
+ ****************************************************************************/
+
+int nxmq_ring_alloc(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring;
+  FAR struct mqueue_slot_s *slot;
+  irqstate_t flags;
+  size_t slotsize;
+  int32_t nslots;
+  int32_t i;
+
+  if (msgq->maxmsgs > MQ_RING_MAXSLOTS)
+    {
+      return -EINVAL;
+    }
+
+  nslots = 1;
+  while (nslots < msgq->maxmsgs)
+    {
+      nslots <<= 1;
+    }
+
+  slotsize = ALIGN_UP(offsetof(struct mqueue_slot_s, mail) +
+                      msgq->maxmsgsize, sizeof(atomic_t));
+
+  ring = kmm_malloc(sizeof(struct mqueue_ring_s) + nslots * slotsize);
+  if (ring == NULL)
+    {
+      return -ENOSPC;
+    }
+
+  atomic_set(&ring->head, 0);
+  atomic_set(&ring->tail, 0);
+  atomic_set(&ring->nwaitnotempty, 0);
+  atomic_set(&ring->nwaitnotfull, 0);
+  nxsem_init(&ring->notempty, 0, 0);
+  nxsem_init(&ring->notfull, 0, 0);
+  ring->mask     = nslots - 1;
+  ring->slotsize = slotsize;
+
+  for (i = 0; i < nslots; i++)
+    {
+      slot = MQ_RING_SLOT(ring, i);
+      atomic_set(&slot->seq, i);
+    }
+
+  flags = enter_critical_section();
+  list_add_tail(&g_mq_rings, &ring->node);
+  leave_critical_section(flags);
+
+  msgq->maxmsgs = nslots;
+  msgq->ring    = ring;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_free
+ *
+ * Description:
+ *   Free the message ring of a message queue.  Messages still in the ring
+ *   are discarded.
+ *
+ ****************************************************************************/
+
+void nxmq_ring_free(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  list_delete(&ring->node);
+  leave_critical_section(flags);
+
+  nxsem_destroy(&ring->notempty);
+  nxsem_destroy(&ring->notfull);
+  kmm_free(ring);
+  msgq->ring = NULL;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_recover
+ *
+ * Description:
+ *   Called when a task is deleted.  If the task was sleeping on a ring,
+ *   withdraw its registration so that later senders and receivers don't
+ *   post the semaphore for it.  nxsem_recover() has already taken the task
+ *   off the semaphore.  If a waker already consumed the registration, its
+ *   post leaves one spurious wake up, which the next sleeper absorbs.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the terminated task or thread
+ *
+ ****************************************************************************/
+
+void nxmq_ring_recover(FAR struct tcb_s *tcb)
+{
+  FAR struct mqueue_ring_s *ring;
+  FAR atomic_t *nwait = NULL;
+  irqstate_t flags;
+  int32_t n;
+
+  if (tcb->task_state != TSTATE_WAIT_SEM)
+    {
+      return;
+    }
+
+  flags = enter_critical_section();
+  list_for_every_entry(&g_mq_rings, ring, struct mqueue_ring_s, node)
+    {
+      if (tcb->waitobj == &ring->notempty)
+        {
+          nwait = &ring->nwaitnotempty;
+          break;
+        }
+      else if (tcb->waitobj == &ring->notfull)
+        {
+          nwait = &ring->nwaitnotfull;
+          break;
+        }
+    }
+
+  if (nwait != NULL)
+    {
+      n = atomic_read(nwait);
+      while (n > 0)
+        {
+          if (atomic_try_cmpxchg(nwait, &n, n - 1))
+            {
+              break;
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_count
+ ****************************************************************************/
+
+int nxmq_ring_count(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  int32_t count;
+
+  count = (int32_t)((uint32_t)atomic_read(&ring->head) -
+                   (uint32_t)atomic_read(&ring->tail));
+  if (count < 0)
+    {
+      count = 0;
+    }
+  else if (count > (int32_t)ring->mask + 1)
+    {
+      count = ring->mask + 1;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_send
+ *
+ * Description:
+ *   Send a message through the ring of a MQ_RING message queue.  No lock
+ *   is taken unless the ring is full and the caller has to sleep: then it
+ *   first spins CONFIG_MQ_RING_SPINCOUNT times and then waits on the
+ *   notfull semaphore.  This may be called from an interrupt handler with
+ *   nowait set.
+ *
+ * Input Parameters:
+ *   msgq    - The message queue
+ *   msg     - Message to send
+ *   msglen  - The length of the message in bytes
+ *   prio    - The priority of the message, passed to the receiver
+ *   abstime - If not NULL, the absolute time to wait until a timeout is
+ *             declared
+ *   ticks   - The relative timeout if abstime is NULL, -1 means forever
+ *   nowait  - Return -EAGAIN instead of waiting if the ring is full
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int nxmq_ring_send(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                   size_t msglen, unsigned int prio,
+                   FAR const struct timespec *abstime, clock_t ticks,
+                   bool nowait)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  clock_t start = clock_systime_ticks();
+  int spin = CONFIG_MQ_RING_SPINCOUNT;
+  uint32_t pos;
+  int ret;
+
+  if (msg == NULL || msglen > (size_t)msgq->maxmsgsize)
+    {
+      return msg == NULL ? -EINVAL : -EMSGSIZE;
+    }
+
+  while (nxmq_ring_put(ring, msg, msglen, prio, &pos) < 0)
+    {
+      if (nowait)
+        {
+          return -EAGAIN;
+        }
+
+      if (spin-- > 0)
+        {
+          continue;
+        }
+
+      /* Announce the sleep, then look again: a receiver that frees a slot
+       * after this point sees the announcement and posts notfull.
+       */
+
+      atomic_fetch_add(&ring->nwaitnotfull, 1);
+      if (nxmq_ring_put(ring, msg, msglen, prio, &pos) == OK)
+        {
+          nxmq_ring_unwait(&ring->nwaitnotfull, &ring->notfull);
+          break;
+        }
+
+      ret = nxmq_ring_sleep(&ring->notfull, abstime, ticks, start);
+      if (ret < 0)
+        {
+          if (!nxmq_ring_unwait(&ring->nwaitnotfull, &ring->notfull) ||
+              nxmq_ring_put(ring, msg, msglen, prio, &pos) < 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+
+      spin = CONFIG_MQ_RING_SPINCOUNT;
+    }
+
+  nxmq_ring_wake(&ring->nwaitnotempty, &ring->notempty);
+
+#if CONFIG_FS_MQUEUE_NPOLLWAITERS > 0
+  if ((uint32_t)atomic_read(&ring->tail) == pos)
+    {
+      irqstate_t flags = enter_critical_section();
+      nxmq_pollnotify(msgq, POLLIN);
+      leave_critical_section(flags);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxmq_ring_receive
+ *
+ * Description:
+ *   Receive the oldest message from the ring of a MQ_RING message queue.
+ *   Messages are received in FIFO order regardless of their priority.
+ *   Waiting works as in nxmq_ring_send().
+ *
+ * Input Parameters:
+ *   msgq    - The message queue
+ *   msg     - Buffer to receive the message, at least maxmsgsize bytes
+ *   prio    - If not NULL, the location to store message priority.
+ *   abstime - If not NULL, the absolute time to wait until a timeout is
+ *             declared
+ *   ticks   - The relative timeout if abstime is NULL, -1 means forever
+ *   nowait  - Return -EAGAIN instead of waiting if the ring is empty
+ *
+ * Returned Value:
+ *   The length of the message on success.  A negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_ring_receive(FAR struct mqueue_inode_s *msgq, FAR char *msg,
+                          FAR unsigned int *prio,
+                          FAR const struct timespec *abstime,
+                          clock_t ticks, bool nowait)
+{
+  FAR struct mqueue_ring_s *ring = msgq->ring;
+  clock_t start = clock_systime_ticks();
+  int spin = CONFIG_MQ_RING_SPINCOUNT;
+  size_t msglen;
+  uint32_t pos;
+  int ret;
+
+  while (nxmq_ring_get(ring, msg, &msglen, prio, &pos) < 0)
+    {
+      if (nowait)
+        {
+          return -EAGAIN;
+        }
+
+      if (spin-- > 0)
+        {
+          continue;
+        }
+
+      /* Announce the sleep, then look again: a sender that publishes a
+       * message after this point sees the announcement and posts
+       * notempty.
+       */
+
+      atomic_fetch_add(&ring->nwaitnotempty, 1);
+      if (nxmq_ring_get(ring, msg, &msglen, prio, &pos) == OK)
+        {
+          nxmq_ring_unwait(&ring->nwaitnotempty, &ring->notempty);
+          break;
+        }
+
+      ret = nxmq_ring_sleep(&ring->notempty, abstime, ticks, start);
+      if (ret < 0)
+        {
+          if (!nxmq_ring_unwait(&ring->nwaitnotempty, &ring->notempty) ||
+              nxmq_ring_get(ring, msg, &msglen, prio, &pos) < 0)
+            {
+              return ret;
+            }
+
+          break;
+        }
+
+      spin = CONFIG_MQ_RING_SPINCOUNT;
+    }
+
+  nxmq_ring_wake(&ring->nwaitnotfull, &ring->notfull);
+
+#if CONFIG_FS_MQUEUE_NPOLLWAITERS > 0
+  if ((uint32_t)atomic_read(&ring->head) - pos == ring->mask + 1)
+    {
+      irqstate_t flags = enter_critical_section();
+      nxmq_pollnotify(msgq, POLLOUT);
+      leave_critical_section(flags);
+    }
+#endif
+
+  return msglen;
+}
+
+#endif /* CONFIG_MQ_RING */
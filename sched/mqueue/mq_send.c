@@ -30,6 +30,8 @@
 #include <nuttx/debug.h>
 #include <errno.h>
 #include <mqueue.h>
+#include <stdint.h>
+#include <strings.h>
 #include <sys/types.h>
 #include <fcntl.h>
 
@@ -203,6 +205,62 @@ static FAR struct mqueue_msg_s *nxmq_alloc_msg(uint16_t msgsize)
  *
  ****************************************************************************/
 
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
+                           FAR struct mqueue_msg_s *mqmsg,
+                           unsigned int prio)
+{
+  unsigned int bucket = MQ_PRIO_BUCKET(prio);
+  FAR struct list_node *tail = msgq->msgtail[bucket];
+  FAR struct list_node *prev;
+  unsigned int index;
+  uint32_t map;
+
+  if (tail != NULL)
+    {
+      /* Messages of a higher bucket all have a higher priority, so only
+       * the lower priority messages at the end of this bucket are skipped.
+       */
+
+      prev = tail;
+      while (prev != &msgq->msglist &&
+             ((FAR struct mqueue_msg_s *)prev)->priority < prio)
+        {
+          prev = prev->prev;
+        }
+    }
+  else
+    {
+      /* The bucket is empty, insert after the tail of the nearest
+       * non-empty higher bucket, or at the head of the queue.
+       */
+
+      prev  = &msgq->msglist;
+      index = bucket + 1;
+
+      while (index < MQ_PRIO_NBUCKETS)
+        {
+          map = msgq->msgmap[index >> 5] & (UINT32_MAX << (index & 31));
+          if (map != 0)
+            {
+              prev = msgq->msgtail[(index & ~31) + ffs(map) - 1];
+              break;
+            }
+
+          index = (index | 31) + 1;
+        }
+
+      msgq->msgmap[bucket >> 5] |= UINT32_C(1) << (bucket & 31);
+    }
+
+  list_add_after(prev, &mqmsg->node);
+
+  if (prev == tail || tail == NULL)
+    {
+      msgq->msgtail[bucket] = &mqmsg->node;
+    }
+}
+#else
 static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
                            FAR struct mqueue_msg_s *mqmsg,
                            unsigned int prio)
@@ -238,6 +296,7 @@ static void nxmq_add_queue(FAR struct mqueue_inode_s *msgq,
       list_add_head(&msgq->msglist, &mqmsg->node);
     }
 }
+#endif
 
 /****************************************************************************
  * Name: file_mq_timedsend_internal
@@ -306,6 +365,15 @@ int file_mq_timedsend_internal(FAR struct file *mq, FAR const char *msg,
 
   msgq = mq->f_inode->i_private;
 
+#ifdef CONFIG_MQ_RING
+  if (msgq->ring != NULL)
+    {
+      return nxmq_ring_send(msgq, msg, msglen, prio, abstime, ticks,
+                            up_interrupt_context() ||
+                            (mq->f_oflags & O_NONBLOCK) != 0);
+    }
+#endif
+
   /* Pre-allocate a message structure */
 
   mqmsg = nxmq_alloc_msg(msglen);
@@ -37,8 +37,11 @@
 #include <mqueue.h>
 #include <sched.h>
 
+#include <nuttx/atomic.h>
+#include <nuttx/list.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/mqueue.h>
+#include <nuttx/semaphore.h>
 
 #if defined(CONFIG_MQ_MAXMSGSIZE) && CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -78,6 +81,50 @@ struct mqueue_msg_s
   char mail[1];            /* Message data */
 };
 
+#ifdef CONFIG_MQ_RING
+/* One message slot of a MQ_RING message queue.  seq tells whose turn it is:
+ * equal to the position of the slot when it is free for the sender of
+ * that round, position + 1 once the message is published.  After the
+ * message was received it is advanced by the ring size.
+ */
+
+struct mqueue_slot_s
+{
+  atomic_t seq;            /* Sequence number of the slot */
+  uint8_t priority;        /* Priority of message */
+#if MQ_MAX_BYTES < 256
+  uint8_t msglen;          /* Message data length */
+#else
+  uint16_t msglen;         /* Message data length */
+#endif
+  char mail[1];            /* Message data */
+};
+
+/* The lock-free ring of a MQ_RING message queue, followed by the slots.
+ * Any number of senders (including interrupt handlers) and receivers may
+ * use it concurrently.  The semaphores are only used when a task has to
+ * sleep.
+ */
+
+struct mqueue_ring_s
+{
+  struct list_node node;   /* Entry in the list of all rings */
+  atomic_t head;           /* Position of the next slot to send */
+  atomic_t tail;           /* Position of the next slot to receive */
+
+  /* A task deleted while sleeping is withdrawn from these counts by
+   * nxmq_ring_recover().
+   */
+
+  atomic_t nwaitnotempty;  /* Number of receivers sleeping on notempty */
+  atomic_t nwaitnotfull;   /* Number of senders sleeping on notfull */
+  sem_t notempty;          /* Receivers wait here for a message */
+  sem_t notfull;           /* Senders wait here for a free slot */
+  uint32_t mask;           /* Number of slots - 1 */
+  size_t slotsize;         /* Size of one slot */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -142,6 +189,71 @@ void nxmq_notify_send(FAR struct mqueue_inode_s *msgq);
 
 void nxmq_recover(FAR struct tcb_s *tcb);
 
+/* mq_ring.c ****************************************************************/
+
+#ifdef CONFIG_MQ_RING
+int nxmq_ring_alloc(FAR struct mqueue_inode_s *msgq);
+void nxmq_ring_free(FAR struct mqueue_inode_s *msgq);
+int nxmq_ring_send(FAR struct mqueue_inode_s *msgq, FAR const char *msg,
+                   size_t msglen, unsigned int prio,
+                   FAR const struct timespec *abstime, clock_t ticks,
+                   bool nowait);
+ssize_t nxmq_ring_receive(FAR struct mqueue_inode_s *msgq, FAR char *msg,
+                          FAR unsigned int *prio,
+                          FAR const struct timespec *abstime,
+                          clock_t ticks, bool nowait);
+void nxmq_ring_recover(FAR struct tcb_s *tcb);
+#endif
+
+/****************************************************************************
+ * Inline Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_remove_msg
+ *
+ * Description:
+ *   Remove the oldest of the highest priority messages from the message
+ *   queue.
+ *
+ * Input Parameters:
+ *   msgq - Message queue descriptor
+ *
+ * Returned Value:
+ *   The message removed from the queue, or NULL if the queue is empty.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static inline_function FAR struct mqueue_msg_s *
+nxmq_remove_msg(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+
+  mqmsg = (FAR struct mqueue_msg_s *)list_remove_head(&msgq->msglist);
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  if (mqmsg != NULL)
+    {
+      unsigned int bucket = MQ_PRIO_BUCKET(mqmsg->priority);
+
+      /* The message was the first one of its bucket.  If it was also the
+       * last one, the bucket is empty now.
+       */
+
+      if (msgq->msgtail[bucket] == &mqmsg->node)
+        {
+          msgq->msgtail[bucket] = NULL;
+          msgq->msgmap[bucket >> 5] &= ~(UINT32_C(1) << (bucket & 31));
+        }
+    }
+#endif
+
+  return mqmsg;
+}
+
 #undef EXTERN
 #ifdef __cplusplus
 }
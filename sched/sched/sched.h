@@ -418,6 +418,22 @@ void nxsched_process_cpuload_ticks(clock_t ticks);
 #define nxsched_process_cpuload() nxsched_process_cpuload_ticks(1)
 #endif
 
+/* Scheduling latency measurement */
+
+#ifdef CONFIG_SCHED_LATENCY
+#  define nxsched_latency_ready(tcb) ((tcb)->readytime = perf_gettime())
+void nxsched_latency_run(FAR struct tcb_s *tcb);
+#else
+#  define nxsched_latency_ready(tcb)
+#endif
+
+/* Pressure stall information */
+
+#ifdef CONFIG_SCHED_PRESSURE
+void nxsched_release_iowait(FAR struct tcb_s *tcb);
+void nxsched_process_pressure(uint32_t elapsed);
+#endif
+
 /* Critical section monitor */
 
 void nxsched_switch_context(FAR struct tcb_s *from, FAR struct tcb_s *to);
@@ -71,6 +71,15 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
   FAR struct tcb_s *rtcb = this_task();
   bool ret;
 
+#ifdef CONFIG_SCHED_LATENCY
+  /* The wakeup latency is measured from here if the task was blocked */
+
+  if (btcb->task_state >= FIRST_BLOCKED_STATE)
+    {
+      nxsched_latency_ready(btcb);
+    }
+#endif
+
   /* Check if pre-emption is disabled for the current running task and if
    * the new ready-to-run task would cause the current running task to be
    * preempted.  NOTE that IRQs disabled implies that pre-emption is
@@ -257,6 +266,15 @@ bool nxsched_add_readytorun(FAR struct tcb_s *btcb)
     nxsched_select_cpu(btcb->affinity);
   FAR struct tcb_s *tcb = current_task(target_cpu);
 
+#ifdef CONFIG_SCHED_LATENCY
+  /* The wakeup latency is measured from here if the task was blocked */
+
+  if (btcb->task_state >= FIRST_BLOCKED_STATE)
+    {
+      nxsched_latency_ready(btcb);
+    }
+#endif
+
   /* Add the btcb to the ready to run list, and try to run it on the target
    * CPU
    */
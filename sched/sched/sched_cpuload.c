@@ -198,6 +198,11 @@ void nxsched_process_cpuload_ticks(clock_t ticks)
       FAR struct tcb_s *rtcb = current_task(i);
       nxsched_process_taskload_ticks(rtcb, ticks);
     }
+
+#ifdef CONFIG_SCHED_PRESSURE
+  nxsched_process_pressure((uint64_t)ticks * USEC_PER_SEC /
+                           CPULOAD_TICKSPERSEC);
+#endif
 }
 
 /****************************************************************************
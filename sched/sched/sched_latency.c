@@ -0,0 +1,147 @@
+/****************************************************************************
+ * sched/sched/sched_latency.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <sys/param.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of fraction bits of g_latency_mult */
+
+#define LATENCY_FRAC_BITS 20
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+struct schedlat_s g_cpu_schedlat[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Microseconds per perf counter tick, and the longest elapsed time that
+ * can be converted without overflow.  Both are set up on first use.
+ */
+
+static uint64_t g_latency_mult;
+static uint64_t g_latency_limit;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_latency_usec
+ *
+ * Description:
+ *   Convert perf counter ticks to microseconds without a division.
+ *
+ ****************************************************************************/
+
+static uint32_t nxsched_latency_usec(clock_t elapsed)
+{
+  uint64_t usec;
+
+  if (g_latency_mult == 0)
+    {
+      g_latency_mult  = ((uint64_t)USEC_PER_SEC << LATENCY_FRAC_BITS) /
+                        perf_getfreq();
+      g_latency_mult  = MAX(g_latency_mult, 1);
+      g_latency_limit = UINT64_MAX / g_latency_mult;
+    }
+
+  if ((uint64_t)elapsed >= g_latency_limit)
+    {
+      return UINT32_MAX;
+    }
+
+  usec = ((uint64_t)elapsed * g_latency_mult) >> LATENCY_FRAC_BITS;
+  return MIN(usec, UINT32_MAX);
+}
+
+/****************************************************************************
+ * Name: nxsched_latency_add
+ ****************************************************************************/
+
+static void nxsched_latency_add(FAR struct schedlat_s *latency,
+                                uint32_t usec, int bucket)
+{
+  latency->count[bucket]++;
+  if (usec > latency->max)
+    {
+      latency->max = usec;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_latency_run
+ *
+ * Description:
+ *   Called when a thread is switched in.  If the thread was woken up since
+ *   it last ran, account the time since then in the histograms of the
+ *   thread and of this CPU.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread that is about to run.
+ *
+ * Assumptions:
+ *   Called in a critical section, on the CPU that runs the thread.
+ *
+ ****************************************************************************/
+
+void nxsched_latency_run(FAR struct tcb_s *tcb)
+{
+  uint32_t usec;
+  int bucket;
+
+  if (tcb->readytime == 0)
+    {
+      return;
+    }
+
+  usec           = nxsched_latency_usec(perf_gettime() - tcb->readytime);
+  tcb->readytime = 0;
+
+  bucket = usec == 0 ? 0 :
+           MIN(fls((int)usec), CONFIG_SCHED_LATENCY_NBUCKETS - 1);
+  nxsched_latency_add(&tcb->latency, usec, bucket);
+  nxsched_latency_add(&g_cpu_schedlat[this_cpu()], usec, bucket);
+}
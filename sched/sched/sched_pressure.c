@@ -0,0 +1,179 @@
+/****************************************************************************
+ * sched/sched/sched_pressure.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/atomic.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The number of threads between nxsched_iowait_begin() and
+ * nxsched_iowait_end()
+ */
+
+static atomic_t g_iowait;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_iowait_begin
+ ****************************************************************************/
+
+bool nxsched_iowait_begin(void)
+{
+  FAR struct tcb_s *rtcb;
+
+  if (up_interrupt_context())
+    {
+      return false;
+    }
+
+  rtcb = this_task();
+  if (rtcb->iowait)
+    {
+      return false;
+    }
+
+  rtcb->iowait = true;
+  atomic_fetch_add(&g_iowait, 1);
+  return true;
+}
+
+/****************************************************************************
+ * Name: nxsched_iowait_end
+ ****************************************************************************/
+
+void nxsched_iowait_end(bool begun)
+{
+  if (begun)
+    {
+      atomic_fetch_sub(&g_iowait, 1);
+      this_task()->iowait = false;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_release_iowait
+ *
+ * Description:
+ *   Drop the I/O wait of a thread that is deleted before it could call
+ *   nxsched_iowait_end().
+ *
+ ****************************************************************************/
+
+void nxsched_release_iowait(FAR struct tcb_s *tcb)
+{
+  if (tcb->iowait)
+    {
+      tcb->iowait = false;
+      atomic_fetch_sub(&g_iowait, 1);
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_pressure
+ *
+ * Description:
+ *   Sample the stall state of the system.  This is called with the CPU
+ *   load clock; the whole elapsed interval is accounted to the state found
+ *   at the time of the sample.
+ *
+ * Input Parameters:
+ *   elapsed - The time since the last sample in microseconds.
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_process_pressure(uint32_t elapsed)
+{
+  FAR struct tcb_s *rtcb;
+  unsigned int stalled = 0;
+  bool busy = false;
+  int running = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      rtcb = current_task(i);
+      if (!is_idle_task(rtcb))
+        {
+          busy = true;
+        }
+
+      if (rtcb->iowait)
+        {
+          running++;
+        }
+    }
+
+  /* A task is stalled on the CPU if it is ready to run, but not running.
+   * With SMP the ready-to-run list only holds such tasks; otherwise the
+   * running task is at its head and the IDLE task at its tail, and the
+   * tasks held back by a locked scheduler are in the pending list.
+   */
+
+#ifdef CONFIG_SMP
+  if (!dq_empty(list_readytorun()))
+#else
+  rtcb = current_task(0);
+  if ((rtcb->flink != NULL && !is_idle_task(rtcb->flink)) ||
+      !dq_empty(list_pendingtasks()))
+#endif
+    {
+      stalled |= PRESSURE_CPU_SOME;
+    }
+
+  /* A thread waiting for I/O is stalled unless it is running (e.g. doing
+   * programmed I/O).  If all CPUs are idle at the same time, all work is
+   * stalled.
+   */
+
+  if (atomic_read(&g_iowait) > running)
+    {
+      stalled |= PRESSURE_IO_SOME;
+      if (!busy)
+        {
+          stalled |= PRESSURE_IO_FULL;
+        }
+    }
+
+  nxsched_notify_pressure(elapsed, stalled);
+}
@@ -118,6 +118,12 @@ int nxsched_release_tcb(FAR struct tcb_s *tcb, uint8_t ttype)
       timer_deleteall(tcb->pid);
 #endif
 
+#ifdef CONFIG_SCHED_PRESSURE
+      /* The task may have been deleted while waiting for I/O */
+
+      nxsched_release_iowait(tcb);
+#endif
+
       /* Release the task's process ID if one was assigned.  PID
        * zero is reserved for the IDLE task.  The TCB of the IDLE
        * task is never release so a value of zero simply means that
@@ -46,14 +46,14 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxsem_clockwait
+ * Name: nxsem_clockwait_slow
  *
  * Description:
  *   This function will lock the semaphore referenced by sem as in the
- *   sem_wait() function. However, if the semaphore cannot be locked without
- *   waiting for another process or thread to unlock the semaphore by
- *   performing a sem_post() function, this wait will be terminated when the
- *   specified timeout expires.
+ *   sem_wait() function in slow mode. However, if the semaphore cannot be
+ *   locked without waiting for another process or thread to unlock the
+ *   semaphore by performing a sem_post() function, this wait will be
+ *   terminated when the specified timeout expires.
  *
  *   The timeout will expire when the absolute time specified by abstime
  *   passes, as measured by the clock on which timeouts are based (that is,
@@ -89,8 +89,8 @@
  *
  ****************************************************************************/
 
-int nxsem_clockwait(FAR sem_t *sem, clockid_t clockid,
-                    FAR const struct timespec *abstime)
+int nxsem_clockwait_slow(FAR sem_t *sem, clockid_t clockid,
+                         FAR const struct timespec *abstime)
 {
   FAR struct tcb_s *rtcb = this_task();
   irqstate_t flags;
@@ -71,26 +71,26 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 
   /* Check if the "built-in" holder is being used.  We have this built-in
    * holder to optimize for the simplest case where semaphores are only
-   * used to implement mutexes.
+   * used to implement mutexes:  a mutex has only one holder, so it never
+   * needs a holder from the pre-allocated pool.
    */
 
+  if (sem->holder.htcb == NULL)
+    {
+      pholder = &sem->holder;
+    }
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
-  if (pholder != NULL)
+  else if (g_freeholders != NULL)
     {
       /* Remove the holder from the free list and
        * put it into the semaphore's holder list
        */
 
+      pholder        = g_freeholders;
       g_freeholders  = pholder->flink;
       pholder->flink = sem->hhead;
       sem->hhead     = pholder;
     }
-#else
-  if (sem->holder.htcb == NULL)
-    {
-      pholder = &sem->holder;
-    }
 #endif
   else
     {
@@ -106,9 +106,15 @@ nxsem_allocholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
   pholder->htcb   = htcb;
   pholder->counts = 0;
 
-  /* Put it into the task's list */
+  /* Put it at the head of the task's list */
 
   pholder->tlink  = htcb->holdsem;
+  pholder->tprev  = NULL;
+  if (htcb->holdsem != NULL)
+    {
+      htcb->holdsem->tprev = pholder;
+    }
+
   htcb->holdsem   = pholder;
 
   return pholder;
@@ -128,9 +134,22 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 {
   FAR struct semholder_s *pholder;
 
+  /* We have one hard-allocated holder structures in sem_t.  This is the
+   * only holder of a mutex.
+   */
+
+  pholder = &sem->holder;
+
+  if (pholder->htcb == htcb)
+    {
+      /* Got it! */
+
+      return pholder;
+    }
+
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  /* Try to find the holder in the list of holders associated with this
-   * semaphore
+  /* Try to find the holder in the list of further holders associated with
+   * this semaphore
    */
 
   for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
@@ -142,17 +161,6 @@ nxsem_findholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
           return pholder;
         }
     }
-#else
-  /* We have one hard-allocated holder structures in sem_t */
-
-  pholder = &sem->holder;
-
-  if (pholder->htcb == htcb)
-    {
-      /* Got it! */
-
-      return pholder;
-    }
 #endif
 
   /* The holder does not appear in the list */
@@ -183,19 +191,26 @@ nxsem_findorallocateholder(FAR sem_t *sem, FAR struct tcb_s *htcb)
 static inline void nxsem_freeholder(FAR sem_t *sem,
                                     FAR struct semholder_s *pholder)
 {
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
   FAR struct semholder_s * FAR *curr;
+#endif
 
-  /* Remove the holder from the task's list */
+  /* Remove the holder from the task's list.  The list is doubly linked, so
+   * that this does not depend on the number of semaphores the task holds.
+   */
 
-  for (curr = &pholder->htcb->holdsem;
-       *curr != NULL;
-       curr = &(*curr)->tlink)
+  if (pholder->tprev != NULL)
     {
-      if (*curr == pholder)
-        {
-          *curr = pholder->tlink;
-          break;
-        }
+      pholder->tprev->tlink = pholder->tlink;
+    }
+  else
+    {
+      pholder->htcb->holdsem = pholder->tlink;
+    }
+
+  if (pholder->tlink != NULL)
+    {
+      pholder->tlink->tprev = pholder->tprev;
     }
 
 #ifdef CONFIG_MM_KMAP
@@ -205,11 +220,20 @@ static inline void nxsem_freeholder(FAR sem_t *sem,
   /* Release the holder and counts */
 
   pholder->tlink  = NULL;
+  pholder->tprev  = NULL;
   pholder->sem    = NULL;
   pholder->htcb   = NULL;
   pholder->counts = 0;
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
+  /* The built-in holder stays in the semaphore */
+
+  if (pholder < g_holderalloc ||
+      pholder >= &g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS])
+    {
+      return;
+    }
+
   /* Remove the holder from the semaphore's list */
 
   for (curr = &sem->hhead;
@@ -279,7 +303,13 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 
       ret = handler(pholder, sem, arg);
     }
-#else
+
+  if (ret != 0)
+    {
+      return ret;
+    }
+#endif
+
   /* We have one hard-allocated holder structures in sem_t */
 
   pholder = &sem->holder;
@@ -292,7 +322,6 @@ static int nxsem_foreachholder(FAR sem_t *sem, holderhandler_t handler,
 
       ret = handler(pholder, sem, arg);
     }
-#endif
 
   return ret;
 }
@@ -580,21 +609,13 @@ void nxsem_destroyholder(FAR sem_t *sem)
    * any stranded holders and hope the task knows what it is doing.
    */
 
-#if CONFIG_SEM_PREALLOCHOLDERS > 0
-  if (sem->hhead != NULL)
-    {
-      /* There may be an issue if there are multiple holders of
-       * the semaphore.
-       */
-
-      DEBUGASSERT(sem->hhead->flink == NULL);
-    }
-
-#else
   /* There may be an issue if there are multiple holders of the semaphore. */
 
+#if CONFIG_SEM_PREALLOCHOLDERS > 0
+  DEBUGASSERT(sem->hhead == NULL ||
+              (sem->holder.htcb == NULL && sem->hhead->flink == NULL));
+#else
   DEBUGASSERT(sem->holder.htcb == NULL || sem->holder.htcb == this_task());
-
 #endif
 
   nxsem_foreachholder(sem, nxsem_recoverholders, NULL);
@@ -737,19 +758,16 @@ void nxsem_release_holder(FAR sem_t *sem)
       /* Find the container for this holder */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-      for (pholder = sem->hhead; pholder != NULL; pholder = pholder->flink)
+      pholder = nxsem_findholder(sem, rtcb);
+      if (pholder != NULL)
         {
           DEBUGASSERT(pholder->counts > 0);
 
-          if (pholder->htcb == rtcb)
-            {
-              /* Decrement the counts on this holder -- the holder will be
-               * freed later in nxsem_restore_baseprio.
-               */
+          /* Decrement the counts on this holder -- the holder will be
+           * freed later in nxsem_restore_baseprio.
+           */
 
-              pholder->counts--;
-              return;
-            }
+          pholder->counts--;
         }
 #else
       pholder = &sem->holder;
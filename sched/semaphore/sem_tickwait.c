@@ -46,11 +46,11 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: nxsem_tickwait
+ * Name: nxsem_tickwait_slow
  *
  * Description:
- *   This function is a lighter weight version of sem_timedwait().  It is
- *   non-standard and intended only for use within the RTOS.
+ *   This function is a lighter weight version of sem_timedwait() in slow
+ *   mode.  It is non-standard and intended only for use within the RTOS.
  *
  * Input Parameters:
  *   sem     - Semaphore object
@@ -66,7 +66,7 @@
  *
  ****************************************************************************/
 
-int nxsem_tickwait(FAR sem_t *sem, uint32_t delay)
+int nxsem_tickwait_slow(FAR sem_t *sem, uint32_t delay)
 {
   FAR struct tcb_s *rtcb;
   irqstate_t flags;
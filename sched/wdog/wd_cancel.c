@@ -60,7 +60,9 @@
 
 int wd_cancel(FAR struct wdog_s *wdog)
 {
+#ifndef CONFIG_WDOG_TIMER_WHEEL
   FAR struct wdog_s *first;
+#endif
   irqstate_t         flags;
   int                  ret = -EINVAL;
 
@@ -76,6 +78,40 @@ int wd_cancel(FAR struct wdog_s *wdog)
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
+          clock_t prev = 0;
+          clock_t next = 0;
+          bool    active = wd_wheel_next(&g_wdwheel, &prev);
+#  endif
+
+          /* Now, remove the watchdog from the timer wheel */
+
+          wd_wheel_remove(&g_wdwheel, &wdog->node);
+
+          /* Mark the watchdog inactive */
+
+          wdog->func = NULL;
+
+#  if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
+          if (active && !wd_in_callback())
+            {
+              /* If the next wheel event has changed, then we will need to
+               * re-adjust the interval timer that will generate the next
+               * interval event.
+               */
+
+              if (!wd_wheel_next(&g_wdwheel, &next))
+                {
+                  wd_timer_cancel();
+                }
+              else if (next != prev)
+                {
+                  wd_timer_start(next, false);
+                }
+            }
+#  endif
+#else
           first = list_first_entry(&g_wdactivelist, struct wdog_s, node);
 
           /* Now, remove the watchdog from the timer queue */
@@ -102,6 +138,7 @@ int wd_cancel(FAR struct wdog_s *wdog)
                   wd_timer_cancel();
                 }
             }
+#endif
 
           ret = OK;
         }
@@ -34,12 +34,18 @@
  * Public Data
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* The timer wheel holding the active watchdogs */
+
+struct wd_wheel_s g_wdwheel;
+#else
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 struct list_node g_wdactivelist = LIST_INITIAL_VALUE(g_wdactivelist);
+#endif
 
 #ifdef CONFIG_HRTIMER
 struct hrtimer_s g_wdtimer;
@@ -104,6 +104,60 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+static inline_function clock_t wd_expiration(clock_t ticks)
+{
+  FAR struct wdog_s *wdog;
+  struct list_node   expired;
+  irqstate_t         flags;
+  wdentry_t          func;
+  wdparm_t           arg;
+  clock_t     next_ticks = ticks;
+
+  flags = enter_critical_section();
+
+  wd_update_expire(ticks);
+
+  wd_set_nested(true);
+
+  /* Collect all watchdogs that expired up to now.  They are run one at a
+   * time from the local list, so that a callback may still cancel or
+   * restart any of them.
+   */
+
+  list_initialize(&expired);
+  wd_wheel_expire(&g_wdwheel, ticks, &expired, WDOG_WHEEL_KEYOFF);
+
+  while (!list_is_empty(&expired))
+    {
+      wdog = list_first_entry(&expired, struct wdog_s, node);
+
+      list_delete_fast(&wdog->node);
+
+      /* Indicate that the watchdog is no longer active. */
+
+      func = wdog->func;
+      arg  = wdog->arg;
+      wdog->func = NULL;
+
+      /* Execute the watchdog function */
+
+      up_setpicbase(wdog->picbase);
+      CALL_FUNC(func, arg);
+    }
+
+  wd_set_nested(false);
+
+  if (wd_wheel_next(&g_wdwheel, &next_ticks))
+    {
+      wd_timer_start(next_ticks, true);
+    }
+
+  leave_critical_section(flags);
+
+  return next_ticks;
+}
+#else
 static inline_function clock_t wd_expiration(clock_t ticks)
 {
   FAR struct wdog_s *wdog;
@@ -163,6 +217,7 @@ static inline_function clock_t wd_expiration(clock_t ticks)
 
   return next_ticks;
 }
+#endif
 
 /****************************************************************************
  * Name: wd_insert
@@ -189,6 +244,18 @@ static inline_function
 bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
                wdentry_t wdentry, wdparm_t arg)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wd_wheel_insert(&g_wdwheel, &wdog->node, expired, WDOG_WHEEL_KEYOFF);
+
+  wdog->func = wdentry;
+  up_getpicbase(&wdog->picbase);
+  wdog->arg = arg;
+  wdog->expired = expired;
+
+  /* The caller compares the next wheel event instead */
+
+  return false;
+#else
   FAR struct wdog_s *curr;
   FAR struct wdog_s *head;
 
@@ -223,6 +290,7 @@ bool wd_insert(FAR struct wdog_s *wdog, clock_t expired,
   /* Return whether the head of the watchdog list has changed. */
 
   return head == curr;
+#endif
 }
 
 /****************************************************************************
@@ -271,6 +339,10 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
   irqstate_t flags;
   bool       reassess = false;
   int        ret      = -EINVAL;
+#if defined(CONFIG_WDOG_TIMER_WHEEL) && \
+    (defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER))
+  clock_t    next     = 0;
+#endif
 
   /* Verify the wdog and setup parameters */
 
@@ -285,7 +357,28 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       /* If the wdog is canceling, restarting the wdog is not allowed. */
 
-#if defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
+#if defined(CONFIG_WDOG_TIMER_WHEEL) && \
+    (defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER))
+      /* We need to reassess timer if the next wheel event has changed. */
+
+      reassess = !wd_wheel_next(&g_wdwheel, &next);
+
+      if (WDOG_ISACTIVE(wdog))
+        {
+          wd_wheel_remove(&g_wdwheel, &wdog->node);
+        }
+
+      wd_wheel_sync(&g_wdwheel, clock_systime_ticks());
+      wd_insert(wdog, ticks, wdentry, arg);
+
+      reassess |= wd_next_expire() != next;
+      reassess &= !wd_in_callback();
+
+      if (reassess)
+        {
+          wd_timer_start(wd_next_expire(), false);
+        }
+#elif defined(CONFIG_SCHED_TICKLESS) || defined(CONFIG_HRTIMER)
       /* We need to reassess timer if the watchdog
        * list head has changed.
        */
@@ -315,7 +408,11 @@ int wd_start_abstick(FAR struct wdog_s *wdog, clock_t ticks,
 
       if (WDOG_ISACTIVE(wdog))
         {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+          wd_wheel_remove(&g_wdwheel, &wdog->node);
+#else
           list_delete_fast(&wdog->node);
+#endif
         }
 
       wd_insert(wdog, ticks, wdentry, arg);
@@ -0,0 +1,370 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <strings.h>
+
+#include <nuttx/list.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Shift and tick range of one slot of a level */
+
+#define WD_WHEEL_SHIFT(l)    ((l) * WD_WHEEL_BITS)
+#define WD_WHEEL_SPAN(l)     ((uint64_t)1 << WD_WHEEL_SHIFT(l))
+
+/* Range covered by the whole wheel */
+
+#define WD_WHEEL_RANGE       ((clock_t)WD_WHEEL_SPAN(WD_WHEEL_LEVELS))
+
+#define WD_WHEEL_BIT(i)      ((uint64_t)1 << (i))
+
+#define wd_wheel_key(node, keyoff) \
+  (*(FAR const clock_t *)((FAR const char *)(node) + (keyoff)))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_overflow
+ *
+ * Description:
+ *   Return the overflow list, initializing it on first use.
+ *
+ ****************************************************************************/
+
+static FAR struct list_node *
+wd_wheel_overflow(FAR struct wd_wheel_s *wheel)
+{
+  if (list_is_clear(&wheel->overflow))
+    {
+      list_initialize(&wheel->overflow);
+    }
+
+  return &wheel->overflow;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_first
+ *
+ * Description:
+ *   Return the absolute tick at which the first non-empty slot of a level
+ *   is processed.  Slot boundaries of the level are scanned circularly,
+ *   starting from the first boundary at or after base.
+ *
+ ****************************************************************************/
+
+static clock_t wd_wheel_first(FAR const struct wd_wheel_s *wheel,
+                              unsigned int level)
+{
+  unsigned int shift = WD_WHEEL_SHIFT(level);
+  uint64_t     map   = wheel->bitmap[level];
+  uint64_t     block;
+  unsigned int pos;
+
+  block = ((uint64_t)wheel->base + WD_WHEEL_SPAN(level) - 1) >> shift;
+  pos   = block & WD_WHEEL_MASK;
+  if (pos != 0)
+    {
+      map = (map >> pos) | (map << (WD_WHEEL_SIZE - pos));
+    }
+
+  return (clock_t)((block + ffsll((long long)map) - 1) << shift);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_cascade
+ *
+ * Description:
+ *   Redistribute the entries of an upper level slot relative to the
+ *   current base.
+ *
+ ****************************************************************************/
+
+static void wd_wheel_cascade(FAR struct wd_wheel_s *wheel,
+                             unsigned int level, unsigned int index,
+                             size_t keyoff)
+{
+  FAR struct list_node *head = &wheel->slot[level][index];
+  FAR struct list_node *node;
+
+  if ((wheel->bitmap[level] & WD_WHEEL_BIT(index)) == 0)
+    {
+      return;
+    }
+
+  /* All entries of the slot expire within one slot span of base, so they
+   * all go to the lower levels and never back into this slot.
+   */
+
+  while ((node = list_remove_head(head)) != NULL)
+    {
+      wd_wheel_insert(wheel, node, wd_wheel_key(node, keyoff), keyoff);
+    }
+
+  wheel->bitmap[level] &= ~WD_WHEEL_BIT(index);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_step
+ *
+ * Description:
+ *   Process the tick at base: cascade the upper level slots that start at
+ *   this tick and move the entries of the level 0 slot to the expired list.
+ *
+ ****************************************************************************/
+
+static unsigned int wd_wheel_step(FAR struct wd_wheel_s *wheel,
+                                  FAR struct list_node *expired,
+                                  size_t keyoff)
+{
+  FAR struct list_node *head;
+  FAR struct list_node *node;
+  uint64_t      tick  = (uint64_t)wheel->base;
+  unsigned int  count = 0;
+  unsigned int  index;
+  unsigned int  level;
+
+  for (level = 1; level < WD_WHEEL_LEVELS; level++)
+    {
+      if ((tick & (WD_WHEEL_SPAN(level) - 1)) != 0)
+        {
+          break;
+        }
+
+      wd_wheel_cascade(wheel, level, (tick >> WD_WHEEL_SHIFT(level)) &
+                       WD_WHEEL_MASK, keyoff);
+    }
+
+  /* At a boundary of the last level, pull in the overflow entries that
+   * are now within range.
+   */
+
+  if (level == WD_WHEEL_LEVELS)
+    {
+      head = wd_wheel_overflow(wheel);
+      while (!list_is_empty(head) &&
+             wd_wheel_key(head->next, keyoff) - wheel->base < WD_WHEEL_RANGE)
+        {
+          node = list_remove_head(head);
+          wd_wheel_insert(wheel, node, wd_wheel_key(node, keyoff), keyoff);
+        }
+    }
+
+  index = tick & WD_WHEEL_MASK;
+  if ((wheel->bitmap[0] & WD_WHEEL_BIT(index)) != 0)
+    {
+      head = &wheel->slot[0][index];
+      while ((node = list_remove_head(head)) != NULL)
+        {
+          list_add_tail(expired, node);
+          count++;
+        }
+
+      wheel->bitmap[0] &= ~WD_WHEEL_BIT(index);
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wd_wheel_s *wheel,
+                     FAR struct list_node *node, clock_t key,
+                     size_t keyoff)
+{
+  FAR struct list_node *head;
+  FAR struct list_node *curr;
+  clock_t               delta = key - wheel->base;
+  unsigned int          index;
+  unsigned int          level;
+
+  if (delta < 0)
+    {
+      /* Already due, process it with the next tick */
+
+      delta = 0;
+      key   = wheel->base;
+    }
+
+  if (delta >= WD_WHEEL_RANGE)
+    {
+      /* Too far away for the wheel.  Such timeouts are rare, so a sorted
+       * list is good enough.
+       */
+
+      head = wd_wheel_overflow(wheel);
+      list_for_every(head, curr)
+        {
+          if (wd_wheel_key(curr, keyoff) - key > 0)
+            {
+              break;
+            }
+        }
+
+      list_add_before(curr, node);
+      return;
+    }
+
+  level = delta < WD_WHEEL_SIZE ? 0 :
+          (flsll((long long)delta) - 1) / WD_WHEEL_BITS;
+  index = ((uint64_t)key >> WD_WHEEL_SHIFT(level)) & WD_WHEEL_MASK;
+  head  = &wheel->slot[level][index];
+
+  if ((wheel->bitmap[level] & WD_WHEEL_BIT(index)) == 0)
+    {
+      list_initialize(head);
+      wheel->bitmap[level] |= WD_WHEEL_BIT(index);
+    }
+
+  list_add_tail(head, node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wd_wheel_s *wheel,
+                     FAR struct list_node *node)
+{
+  FAR struct list_node *head  = node->prev;
+  FAR struct list_node *first = &wheel->slot[0][0];
+  size_t                index;
+
+  /* If node is the only entry of a wheel slot, the slot becomes empty */
+
+  if (head == node->next && head >= first &&
+      head < first + WD_WHEEL_LEVELS * WD_WHEEL_SIZE)
+    {
+      index = head - first;
+      wheel->bitmap[index / WD_WHEEL_SIZE] &=
+        ~WD_WHEEL_BIT(index % WD_WHEEL_SIZE);
+    }
+
+  list_delete(node);
+}
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR const struct wd_wheel_s *wheel, FAR clock_t *next)
+{
+  bool         found = false;
+  clock_t      tick;
+  unsigned int level;
+
+  for (level = 0; level < WD_WHEEL_LEVELS; level++)
+    {
+      if (wheel->bitmap[level] != 0)
+        {
+          tick = wd_wheel_first(wheel, level);
+          if (!found || tick - *next < 0)
+            {
+              *next = tick;
+              found = true;
+            }
+        }
+    }
+
+  /* The overflow list is looked at on each boundary of the last level */
+
+  if (!list_is_clear(&wheel->overflow) && !list_is_empty(&wheel->overflow))
+    {
+      level = WD_WHEEL_LEVELS - 1;
+      tick  = (clock_t)((((uint64_t)wheel->base + WD_WHEEL_SPAN(level) - 1)
+                         >> WD_WHEEL_SHIFT(level)) << WD_WHEEL_SHIFT(level));
+      if (!found || tick - *next < 0)
+        {
+          *next = tick;
+          found = true;
+        }
+    }
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: wd_wheel_sync
+ ****************************************************************************/
+
+void wd_wheel_sync(FAR struct wd_wheel_s *wheel, clock_t now)
+{
+  clock_t next;
+
+  if (now - wheel->base > 0 &&
+      (!wd_wheel_next(wheel, &next) || next - now > 0))
+    {
+      wheel->base = now;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ ****************************************************************************/
+
+unsigned int wd_wheel_expire(FAR struct wd_wheel_s *wheel, clock_t ticks,
+                             FAR struct list_node *expired, size_t keyoff)
+{
+  unsigned int count = 0;
+  clock_t      next;
+
+  /* Jump from one event to the next, the empty ticks in between need no
+   * processing.
+   */
+
+  while (wd_wheel_next(wheel, &next) && next - ticks <= 0)
+    {
+      wheel->base = next;
+      count += wd_wheel_step(wheel, expired, keyoff);
+      wheel->base++;
+    }
+
+  if (ticks - wheel->base >= 0)
+    {
+      wheel->base = ticks + 1;
+    }
+
+  return count;
+}
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
@@ -29,6 +29,7 @@
 
 #include <nuttx/config.h>
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -46,6 +47,45 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+#  define WD_WHEEL_BITS    6
+#  define WD_WHEEL_SIZE    (1 << WD_WHEEL_BITS)
+#  define WD_WHEEL_MASK    (WD_WHEEL_SIZE - 1)
+#  define WD_WHEEL_LEVELS  CONFIG_WDOG_TIMER_WHEEL_LEVELS
+
+/* Offset of the expiration time relative to the list node of a watchdog */
+
+#  define WDOG_WHEEL_KEYOFF \
+     (offsetof(struct wdog_s, expired) - offsetof(struct wdog_s, node))
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+/* A hierarchical timing wheel.  The entries are list nodes embedded in
+ * some structure that also holds the absolute expiration time (the key) at
+ * a fixed offset from the node.  Level n of the wheel holds the entries
+ * that expire within 64^(n+1) ticks of base, in the slot selected by bits
+ * [6n, 6n+6) of the expiration time.  When base crosses a slot boundary of
+ * an upper level, the entries of that slot are redistributed to the lower
+ * levels, until they eventually reach level 0 and expire.
+ *
+ * A slot list head is only valid while its bit is set in the bitmap of its
+ * level, so an all-zero wheel is a valid empty wheel.
+ */
+
+struct wd_wheel_s
+{
+  clock_t          base;                     /* Next tick to be processed */
+  uint64_t         bitmap[WD_WHEEL_LEVELS];  /* Non-empty slots */
+  struct list_node slot[WD_WHEEL_LEVELS][WD_WHEEL_SIZE];
+  struct list_node overflow;                 /* Beyond the last level,
+                                              * sorted by expiration */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -63,7 +103,11 @@ extern "C"
  * this linked list are removed and the function is called.
  */
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+extern struct wd_wheel_s g_wdwheel;
+#else
 extern struct list_node g_wdactivelist;
+#endif
 
 #ifdef CONFIG_HRTIMER
 extern struct hrtimer_s g_wdtimer;
@@ -110,6 +154,90 @@ void wd_timer(clock_t ticks);
 uint64_t wd_timer(const hrtimer_t *timer, uint64_t expired);
 #endif
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+
+/****************************************************************************
+ * Name: wd_wheel_insert
+ *
+ * Description:
+ *   Add an entry to a timer wheel.  An entry that is already due is added
+ *   to the slot processed next.
+ *
+ * Input Parameters:
+ *   wheel  - The timer wheel
+ *   node   - The list node of the entry
+ *   key    - The absolute expiration time of the entry in clock ticks
+ *   keyoff - Offset of the expiration time relative to the list node
+ *
+ * Assumptions:
+ *   Called with the lock protecting the wheel held.
+ *
+ ****************************************************************************/
+
+void wd_wheel_insert(FAR struct wd_wheel_s *wheel,
+                     FAR struct list_node *node, clock_t key,
+                     size_t keyoff);
+
+/****************************************************************************
+ * Name: wd_wheel_remove
+ *
+ * Description:
+ *   Remove an entry from a timer wheel.  The entry may also have already
+ *   been moved to a list of expired entries by wd_wheel_expire(), in which
+ *   case it is just removed from that list.
+ *
+ ****************************************************************************/
+
+void wd_wheel_remove(FAR struct wd_wheel_s *wheel,
+                     FAR struct list_node *node);
+
+/****************************************************************************
+ * Name: wd_wheel_next
+ *
+ * Description:
+ *   Get the next tick at which the wheel has to be processed.  This is
+ *   either the expiration of the earliest entry or an earlier tick at which
+ *   an upper level slot has to be redistributed.  The cost is bounded by
+ *   the number of levels.
+ *
+ * Returned Value:
+ *   false if the wheel is empty, in which case next is not modified.
+ *
+ ****************************************************************************/
+
+bool wd_wheel_next(FAR const struct wd_wheel_s *wheel, FAR clock_t *next);
+
+/****************************************************************************
+ * Name: wd_wheel_sync
+ *
+ * Description:
+ *   Move the base of an idle wheel forward to the current time.  This is
+ *   only done if no entry is due up to now, so it doesn't change when any
+ *   entry is processed, but it keeps new entries from being placed
+ *   relative to a stale base in tickless mode.
+ *
+ ****************************************************************************/
+
+void wd_wheel_sync(FAR struct wd_wheel_s *wheel, clock_t now);
+
+/****************************************************************************
+ * Name: wd_wheel_expire
+ *
+ * Description:
+ *   Process the wheel up to and including ticks and move the expired
+ *   entries to the tail of the expired list.  Only the ticks at which the
+ *   wheel actually holds entries are visited.
+ *
+ * Returned Value:
+ *   The number of entries moved to the expired list.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheel_expire(FAR struct wd_wheel_s *wheel, clock_t ticks,
+                             FAR struct list_node *expired, size_t keyoff);
+
+#endif /* CONFIG_WDOG_TIMER_WHEEL */
+
 /****************************************************************************
  * Inline functions
  ****************************************************************************/
@@ -196,7 +324,14 @@ static inline_function void wd_timer_cancel(void)
 
 static inline_function clock_t wd_next_expire(void)
 {
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  clock_t next = 0;
+
+  wd_wheel_next(&g_wdwheel, &next);
+  return next;
+#else
   return list_first_entry(&g_wdactivelist, struct wdog_s, node)->expired;
+#endif
 }
 
 /****************************************************************************
@@ -208,10 +343,14 @@ static inline_function clock_t wd_get_next_expire(clock_t curr)
   clock_t     next = curr;
   irqstate_t flags = enter_critical_section();
 
+#ifdef CONFIG_WDOG_TIMER_WHEEL
+  wd_wheel_next(&g_wdwheel, &next);
+#else
   if (!list_is_empty(&g_wdactivelist))
     {
       next = wd_next_expire();
     }
+#endif
 
   leave_critical_section(flags);
   return next - curr <= 0 ? 0 : next;
@@ -72,6 +72,7 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
                        FAR void *arg, clock_t delay)
 {
   irqstate_t flags;
+  bool wakeup = false;
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -95,8 +96,7 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
         {
           /* Start the timer if the work is the earliest expired work. */
 
-          wd_start_abstick(&wqueue->timer, work->qtime,
-                           work_timer_expired, (wdparm_t)wqueue);
+          work_timer_reset(wqueue);
         }
     }
   else
@@ -104,11 +104,12 @@ int work_queue_next_wq(FAR struct kwork_wqueue_s *wqueue,
       /* Insert to the expired list of the wqueue. */
 
       list_add_tail(&wqueue->expired, &work->node);
+      wakeup = work_need_wakeup(wqueue);
     }
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
 
-  if (!delay)
+  if (wakeup)
     {
       /* Immediately wake up the worker thread. */
 
@@ -161,6 +162,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
   irqstate_t flags;
   clock_t expected;
   bool retimer;
+  bool wakeup = false;
 
   if (wqueue == NULL || work == NULL || worker == NULL ||
       delay > WDOG_MAX_DELAY)
@@ -195,8 +197,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
           /* Start the timer if the work is the earliest expired work. */
 
           retimer = false;
-          wd_start_abstick(&wqueue->timer, work->qtime,
-                           work_timer_expired, (wdparm_t)wqueue);
+          work_timer_reset(wqueue);
         }
     }
   else
@@ -204,6 +205,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
       /* Insert to the expired list of the wqueue. */
 
       list_add_tail(&wqueue->expired, &work->node);
+      wakeup = work_need_wakeup(wqueue);
     }
 
   if (retimer)
@@ -213,7 +215,7 @@ int work_queue_wq(FAR struct kwork_wqueue_s *wqueue,
 
   spin_unlock_irqrestore(&wqueue->lock, flags);
 
-  if (!delay)
+  if (wakeup)
     {
       /* Immediately wake up the worker thread. */
 
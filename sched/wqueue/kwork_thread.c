@@ -74,6 +74,18 @@
 #  define CALL_WORKER(worker, arg) worker(arg)
 #endif
 
+/* The threads added to a pool are started from another work queue, so that
+ * the work running on the pool is not delayed by the thread creation.
+ */
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+#  if defined(CONFIG_SCHED_LPWORK)
+#    define WORK_POOL_HELPER LPWORK
+#  elif defined(CONFIG_SCHED_HPWORK)
+#    define WORK_POOL_HELPER HPWORK
+#  endif
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -85,7 +97,9 @@ struct hp_wqueue_s g_hpwork =
 {
   {
     LIST_INITIAL_VALUE(g_hpwork.wq.expired),
+#ifndef CONFIG_WQUEUE_TIMER_WHEEL
     LIST_INITIAL_VALUE(g_hpwork.wq.pending),
+#endif
     SEM_INITIALIZER(0),
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
@@ -102,7 +116,9 @@ struct lp_wqueue_s g_lpwork =
 {
   {
     LIST_INITIAL_VALUE(g_lpwork.wq.expired),
+#ifndef CONFIG_WQUEUE_TIMER_WHEEL
     LIST_INITIAL_VALUE(g_lpwork.wq.pending),
+#endif
     SEM_INITIALIZER(0),
     SEM_INITIALIZER(0),
     SP_UNLOCKED,
@@ -112,10 +128,53 @@ struct lp_wqueue_s g_lpwork =
 
 #endif /* CONFIG_SCHED_LPWORK */
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUWORK
+/* The kernel mode work queue of each CPU */
+
+static FAR struct kwork_wqueue_s *g_cpuwork[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int work_thread(int argc, FAR char *argv[]);
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+static inline_function
+void work_dispatch(FAR struct kwork_wqueue_s *wq)
+{
+  unsigned int count;
+
+  /* Move the expired work to the tail of the expired queue.  The timer
+   * may also fire when the wheel only had to be redistributed, in which
+   * case nothing expires and no worker thread is woken up.
+   */
+
+  count = wd_wheel_expire(&wq->pending, clock_systime_ticks(),
+                          &wq->expired, WORK_WHEEL_KEYOFF);
+
+  /* Note that the thread execution this function is also
+   * a worker thread, which has already been woken up by the timer.
+   * So only `count - 1` semaphore will be posted.
+   */
+
+  while (count-- > 1 && work_need_wakeup(wq))
+    {
+      nxsem_post(&wq->sem);
+    }
+
+  work_timer_reset(wq);
+}
+#else
 static inline_function
 void work_dispatch(FAR struct kwork_wqueue_s *wq)
 {
@@ -154,12 +213,217 @@ void work_dispatch(FAR struct kwork_wqueue_s *wq)
        * So only `count - 1` semaphore will be posted.
        */
 
-      if (count++ > 0)
+      if (count++ > 0 && work_need_wakeup(wq))
         {
           nxsem_post(&wq->sem);
         }
     }
 }
+#endif
+
+/****************************************************************************
+ * Name: work_thread_start
+ *
+ * Description:
+ *   Start the thread of one worker slot.
+ *
+ ****************************************************************************/
+
+static int work_thread_start(FAR const char *name, int priority,
+                             FAR void *stack, int stack_size,
+                             FAR struct kwork_wqueue_s *wqueue,
+                             FAR struct kworker_s *kworker)
+{
+  FAR char *argv[3];
+  char arg0[32];
+  char arg1[32];
+
+  nxsem_init(&kworker->wait, 0, 0);
+
+  snprintf(arg0, sizeof(arg0), "%p", wqueue);
+  snprintf(arg1, sizeof(arg1), "%p", kworker);
+  argv[0] = arg0;
+  argv[1] = arg1;
+  argv[2] = NULL;
+
+  return kthread_create_with_stack(name, priority, stack,
+                                   stack_size, work_thread, argv);
+}
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+
+#ifdef WORK_POOL_HELPER
+/****************************************************************************
+ * Name: work_pool_busy
+ *
+ * Description:
+ *   Return whether no worker of a pool would be available for new work
+ *   while the pool may still grow.  Require the wqueue lock to be held.
+ *
+ ****************************************************************************/
+
+static bool work_pool_busy(FAR struct kwork_wqueue_s *wqueue)
+{
+  return !wqueue->exit && wqueue->nthreads < wqueue->maxthreads &&
+         wqueue->nfree == 0 && wqueue->nidle <= wqueue->nwake;
+}
+
+/****************************************************************************
+ * Name: work_pool_grow
+ *
+ * Description:
+ *   Run on the helper work queue to start a thread in a free worker slot
+ *   of a pool that is still busy.  The new thread gets the CPU affinity of
+ *   the first worker of the pool.
+ *
+ ****************************************************************************/
+
+static void work_pool_grow(FAR void *arg)
+{
+  FAR struct kwork_wqueue_s *wqueue = arg;
+  FAR struct kworker_s *worker = wq_get_worker(wqueue);
+  FAR struct kworker_s *kworker = NULL;
+  irqstate_t flags;
+  int wndx;
+  int pid;
+
+  flags = spin_lock_irqsave_nopreempt(&wqueue->lock);
+  if (work_pool_busy(wqueue))
+    {
+      for (wndx = wqueue->minthreads; wndx < wqueue->maxthreads; wndx++)
+        {
+          if (worker[wndx].pid == 0)
+            {
+              kworker      = &worker[wndx];
+              kworker->pid = -1;
+              wqueue->nthreads++;
+              break;
+            }
+        }
+    }
+
+  spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+
+  if (kworker == NULL)
+    {
+      return;
+    }
+
+  /* Keep the new thread from running before it is bound to the CPUs of
+   * the pool.
+   */
+
+  sched_lock();
+
+  pid = work_thread_start(wqueue->name, wqueue->priority, NULL,
+                          wqueue->stack_size, wqueue, kworker);
+#ifdef CONFIG_SMP
+  if (pid > 0)
+    {
+      FAR struct tcb_s *tcb = nxsched_get_tcb(worker[0].pid);
+
+      if (tcb != NULL)
+        {
+          nxsched_set_affinity(pid, sizeof(cpu_set_t), &tcb->affinity);
+        }
+    }
+#endif
+
+  flags = spin_lock_irqsave_nopreempt(&wqueue->lock);
+  if (pid < 0)
+    {
+      serr("ERROR: Failed to add a worker: %d\n", pid);
+      kworker->pid = 0;
+      wqueue->nthreads--;
+    }
+  else
+    {
+      kworker->pid = pid;
+    }
+
+  spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+  sched_unlock();
+}
+
+/****************************************************************************
+ * Name: work_pool_stalled
+ *
+ * Description:
+ *   The stall timer callback.  If the pool is still busy and one of its
+ *   workers has been running the same work for CONFIG_WQUEUE_STALL_TIMEOUT,
+ *   have the helper work queue add a thread.  Otherwise check again when
+ *   the oldest running work reaches that age.
+ *
+ * Input Parameters:
+ *   arg  - The work queue.
+ *
+ ****************************************************************************/
+
+static void work_pool_stalled(wdparm_t arg)
+{
+  FAR struct kwork_wqueue_s *wqueue = (FAR struct kwork_wqueue_s *)arg;
+  FAR struct kworker_s *worker = wq_get_worker(wqueue);
+  clock_t timeout = MSEC2TICK(CONFIG_WQUEUE_STALL_TIMEOUT);
+  clock_t now = clock_systime_ticks();
+  clock_t oldest = 0;
+  irqstate_t flags;
+  int wndx;
+
+  flags = spin_lock_irqsave(&wqueue->lock);
+  if (work_pool_busy(wqueue))
+    {
+      for (wndx = 0; wndx < wqueue->maxthreads; wndx++)
+        {
+          if (worker[wndx].pid > 0 && worker[wndx].work != NULL &&
+              now - worker[wndx].start > oldest)
+            {
+              oldest = now - worker[wndx].start;
+            }
+        }
+
+      /* Queue the helper work with the lock held, so that
+       * work_queue_free() can't miss it.
+       */
+
+      if (oldest < timeout)
+        {
+          wd_start(&wqueue->stall, timeout - oldest,
+                   work_pool_stalled, (wdparm_t)wqueue);
+        }
+      else if (work_available(&wqueue->grow))
+        {
+          work_queue(WORK_POOL_HELPER, &wqueue->grow, work_pool_grow,
+                     wqueue, 0);
+        }
+    }
+
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+}
+#endif /* WORK_POOL_HELPER */
+
+/****************************************************************************
+ * Name: work_pool_wait
+ *
+ * Description:
+ *   Wait for the semaphore.  The threads that were added on demand only
+ *   wait for a limited time.
+ *
+ ****************************************************************************/
+
+static int work_pool_wait(FAR struct kwork_wqueue_s *wqueue,
+                          FAR struct kworker_s *kworker)
+{
+  if (wqueue->maxthreads > 0 &&
+      kworker - wq_get_worker(wqueue) >= wqueue->minthreads)
+    {
+      return nxsem_tickwait_uninterruptible(&wqueue->sem,
+                                   MSEC2TICK(CONFIG_WQUEUE_IDLE_TIMEOUT));
+    }
+
+  return nxsem_wait_uninterruptible(&wqueue->sem);
+}
+
+#endif /* CONFIG_WQUEUE_CONCURRENCY */
 
 /****************************************************************************
  * Name: work_thread
@@ -191,6 +455,9 @@ static int work_thread(int argc, FAR char *argv[])
   worker_t      worker;
   irqstate_t    flags;
   FAR void     *arg;
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+  int           ret;
+#endif
 
   /* Get the handle from argv */
 
@@ -199,6 +466,14 @@ static int work_thread(int argc, FAR char *argv[])
   kworker = (FAR struct kworker_s *)
             ((uintptr_t)strtoul(argv[2], NULL, 16));
 
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+  /* The new worker is awake and not running any work */
+
+  flags = spin_lock_irqsave_nopreempt(&wqueue->lock);
+  wqueue->nfree++;
+  spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+#endif
+
   /* Loop until wqueue->exit != 0.
    * Since the only way to set wqueue->exit is to call work_queue_free(),
    * there is no need for entering the critical section.
@@ -246,6 +521,28 @@ static int work_thread(int argc, FAR char *argv[])
 
           kworker->work = work;
 
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+          /* Wake up a helper for the remaining work.  If no worker is left
+           * for new work, start checking whether this one stays busy.
+           */
+
+          kworker->start = clock_systime_ticks();
+          wqueue->nfree--;
+          if (!list_is_empty(&wqueue->expired) && work_need_wakeup(wqueue))
+            {
+              nxsem_post(&wqueue->sem);
+            }
+
+#  ifdef WORK_POOL_HELPER
+          if (work_pool_busy(wqueue) && !WDOG_ISACTIVE(&wqueue->stall))
+            {
+              wd_start(&wqueue->stall,
+                       MSEC2TICK(CONFIG_WQUEUE_STALL_TIMEOUT),
+                       work_pool_stalled, (wdparm_t)wqueue);
+            }
+#  endif
+#endif
+
           spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
 
           /* Do the work.  Re-enable interrupts while the work is being
@@ -258,6 +555,9 @@ static int work_thread(int argc, FAR char *argv[])
           /* Mark the thread un-busy */
 
           kworker->work = NULL;
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+          wqueue->nfree++;
+#endif
 
           /* Check if someone is waiting, if so, wakeup it */
 
@@ -266,13 +566,56 @@ static int work_thread(int argc, FAR char *argv[])
               kworker->wait_count--;
               nxsem_post(&kworker->wait);
             }
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+          /* Drain the queue before going to sleep, work queued meanwhile
+           * may not have posted the semaphore.
+           */
+
+          spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+          continue;
+#endif
+        }
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+      wqueue->nfree--;
+      wqueue->nidle++;
+      spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+
+      /* Wait for the semaphore to be posted by new work or the wqueue
+       * timer.
+       */
+
+      ret = work_pool_wait(wqueue, kworker);
+
+      flags = spin_lock_irqsave_nopreempt(&wqueue->lock);
+      wqueue->nidle--;
+      wqueue->nfree++;
+      if (wqueue->nwake > 0)
+        {
+          wqueue->nwake--;
+        }
+
+      /* A thread added on demand exits when it has been idle too long */
+
+      if (ret == -ETIMEDOUT && !wqueue->exit &&
+          list_is_empty(&wqueue->expired))
+        {
+          wqueue->nfree--;
+          wqueue->nthreads--;
+          kworker->pid = 0;
+          spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+          return OK;
         }
 
       spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
+#else
+      spin_unlock_irqrestore_nopreempt(&wqueue->lock, flags);
 
       /* Wait for the semaphore to be posted by the wqueue timer. */
 
       nxsem_wait_uninterruptible(&wqueue->sem);
+#endif
     }
 
   nxsem_post(&wqueue->exsem);
@@ -303,9 +646,6 @@ static int work_thread_create(FAR const char *name, int priority,
                               FAR struct kwork_wqueue_s *wqueue)
 {
   FAR struct kworker_s *worker = wq_get_worker(wqueue);
-  FAR char *argv[3];
-  char arg0[32];
-  char arg1[32];
   int wndx;
   int pid;
   FAR void *stack = NULL;
@@ -318,14 +658,6 @@ static int work_thread_create(FAR const char *name, int priority,
 
   for (wndx = 0; wndx < wqueue->nthreads; wndx++)
     {
-      nxsem_init(&worker[wndx].wait, 0, 0);
-
-      snprintf(arg0, sizeof(arg0), "%p", wqueue);
-      snprintf(arg1, sizeof(arg1), "%p", &worker[wndx]);
-      argv[0] = arg0;
-      argv[1] = arg1;
-      argv[2] = NULL;
-
       /* In case of the stack_addr is NULL */
 
       if (stack_addr)
@@ -333,8 +665,8 @@ static int work_thread_create(FAR const char *name, int priority,
           stack = (FAR void *)((uintptr_t)stack_addr + wndx * stack_size);
         }
 
-      pid = kthread_create_with_stack(name, priority, stack,
-                                      stack_size, work_thread, argv);
+      pid = work_thread_start(name, priority, stack, stack_size,
+                              wqueue, &worker[wndx]);
 
       DEBUGASSERT(pid > 0);
       if (pid < 0)
@@ -423,7 +755,9 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
   /* Initialize the work queue structure */
 
   list_initialize(&wqueue->expired);
+#ifndef CONFIG_WQUEUE_TIMER_WHEEL
   list_initialize(&wqueue->pending);
+#endif
   wqueue->timer.func = NULL;
   nxsem_init(&wqueue->sem, 0, 0);
   nxsem_init(&wqueue->exsem, 0, 0);
@@ -442,6 +776,79 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
   return wqueue;
 }
 
+/****************************************************************************
+ * Name: work_queue_create_pool
+ *
+ * Description:
+ *   Create a new work queue whose thread pool grows on demand, between
+ *   minthreads and maxthreads threads.
+ *
+ * Input Parameters:
+ *   name       - Name of the new tasks
+ *   priority   - Priority of the new tasks
+ *   stack_size - size (in bytes) of the stack of each task
+ *   minthreads - Number of work threads created up front
+ *   maxthreads - Maximum number of work threads
+ *
+ * Returned Value:
+ *   The work queue handle returned on success.  Otherwise, NULL
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+FAR struct kwork_wqueue_s *work_queue_create_pool(FAR const char *name,
+                                                  int priority,
+                                                  int stack_size,
+                                                  int minthreads,
+                                                  int maxthreads)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  int ret;
+
+  if (minthreads < 1 || maxthreads < minthreads || maxthreads > UINT8_MAX)
+    {
+      return NULL;
+    }
+
+  /* Allocate a new work queue with a slot for each possible thread */
+
+  wqueue = kmm_zalloc(sizeof(struct kwork_wqueue_s) +
+                      maxthreads * sizeof(struct kworker_s));
+  if (wqueue == NULL)
+    {
+      return NULL;
+    }
+
+  /* Initialize the work queue structure */
+
+  list_initialize(&wqueue->expired);
+#ifndef CONFIG_WQUEUE_TIMER_WHEEL
+  list_initialize(&wqueue->pending);
+#endif
+  wqueue->timer.func = NULL;
+  nxsem_init(&wqueue->sem, 0, 0);
+  nxsem_init(&wqueue->exsem, 0, 0);
+  wqueue->nthreads   = minthreads;
+  wqueue->minthreads = minthreads;
+  wqueue->maxthreads = maxthreads;
+  wqueue->priority   = priority;
+  wqueue->stack_size = stack_size;
+  wqueue->name       = name;
+  spin_lock_init(&wqueue->lock);
+
+  /* Create the initial threads of the pool */
+
+  ret = work_thread_create(name, priority, NULL, stack_size, wqueue);
+  if (ret < 0)
+    {
+      kmm_free(wqueue);
+      return NULL;
+    }
+
+  return wqueue;
+}
+#endif
+
 /****************************************************************************
  * Name: work_queue_free
  *
@@ -460,6 +867,8 @@ FAR struct kwork_wqueue_s *work_queue_create(FAR const char *name,
 
 int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 {
+  irqstate_t flags;
+  int nthreads;
   int wndx;
 
   if (wqueue == NULL)
@@ -469,18 +878,35 @@ int work_queue_free(FAR struct kwork_wqueue_s *wqueue)
 
   wd_cancel(&wqueue->timer);
 
-  /* Mark the work queue as exiting */
+  /* Mark the work queue as exiting.  The lock keeps the number of threads
+   * stable if the pool can grow or shrink.
+   */
 
+  flags = spin_lock_irqsave(&wqueue->lock);
   wqueue->exit = true;
+  spin_unlock_irqrestore(&wqueue->lock, flags);
+
+#ifdef WORK_POOL_HELPER
+  /* No thread can be added once exit is set.  Wait for one that is being
+   * added.
+   */
+
+  wd_cancel(&wqueue->stall);
+  work_cancel_sync(WORK_POOL_HELPER, &wqueue->grow);
+#endif
+
+  flags = spin_lock_irqsave(&wqueue->lock);
+  nthreads = wqueue->nthreads;
+  spin_unlock_irqrestore(&wqueue->lock, flags);
 
   /* Queue a exit work for all threads */
 
-  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+  for (wndx = 0; wndx < nthreads; wndx++)
     {
       nxsem_post(&wqueue->sem);
     }
 
-  for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+  for (wndx = 0; wndx < nthreads; wndx++)
     {
       nxsem_wait_uninterruptible(&wqueue->exsem);
     }
@@ -617,4 +1043,87 @@ int work_start_lowpri(void)
 }
 #endif /* CONFIG_SCHED_LPWORK */
 
+/****************************************************************************
+ * Name: work_start_cpu
+ *
+ * Description:
+ *   Start the per-CPU, kernel-mode work queues.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUWORK
+int work_start_cpu(void)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  FAR struct kworker_s *worker;
+  cpu_set_t cpuset;
+  int wndx;
+  int cpu;
+
+  sinfo("Starting per-CPU kernel worker thread(s)\n");
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS; cpu++)
+    {
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+      wqueue = work_queue_create_pool(CPUWORKNAME,
+                                      CONFIG_SCHED_CPUWORKPRIORITY,
+                                      CONFIG_SCHED_CPUWORKSTACKSIZE,
+                                      1, CONFIG_SCHED_CPUNTHREADS);
+#else
+      wqueue = work_queue_create(CPUWORKNAME, CONFIG_SCHED_CPUWORKPRIORITY,
+                                 NULL, CONFIG_SCHED_CPUWORKSTACKSIZE,
+                                 CONFIG_SCHED_CPUNTHREADS);
+#endif
+      if (wqueue == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      /* Bind the workers to the CPU.  Threads added to the pool later
+       * get the affinity of the first worker.
+       */
+
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+
+      worker = wq_get_worker(wqueue);
+      for (wndx = 0; wndx < wqueue->nthreads; wndx++)
+        {
+          nxsched_set_affinity(worker[wndx].pid, sizeof(cpuset), &cpuset);
+        }
+
+      g_cpuwork[cpu] = wqueue;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_queue_cpu
+ *
+ * Description:
+ *   Return the kernel work queue of a CPU.
+ *
+ * Input Parameters:
+ *   cpu - The CPU index
+ *
+ * Returned Value:
+ *   The work queue handle, NULL if the CPU work queues are not started.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_queue_cpu(int cpu)
+{
+  DEBUGASSERT(cpu >= 0 && cpu < CONFIG_SMP_NCPUS);
+  return g_cpuwork[cpu];
+}
+#endif /* CONFIG_SCHED_CPUWORK */
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
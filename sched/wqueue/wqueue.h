@@ -37,6 +37,10 @@
 #include <nuttx/wqueue.h>
 #include <nuttx/spinlock.h>
 
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+#  include "wdog/wdog.h"
+#endif
+
 #ifdef CONFIG_SCHED_WORKQUEUE
 
 /****************************************************************************
@@ -47,6 +51,7 @@
 
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
+#define CPUWORKNAME "cpuwork"
 
 /* Get the worker structure from the work queue.
  * This function requires the workers are located next to the wqueue.
@@ -55,6 +60,24 @@
 #define wq_get_worker(wq) \
   (FAR struct kworker_s *)((FAR char *)(wq) + sizeof(struct kwork_wqueue_s))
 
+/* The number of worker slots following the wqueue.  A pool that grows on
+ * demand has a slot for each of its possible threads.
+ */
+
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+#  define wq_nworkers(wq) \
+     ((wq)->maxthreads > 0 ? (wq)->maxthreads : (wq)->nthreads)
+#else
+#  define wq_nworkers(wq) ((wq)->nthreads)
+#endif
+
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+/* Offset of the due time relative to the list node of a work */
+
+#  define WORK_WHEEL_KEYOFF \
+     (offsetof(struct work_s, qtime) - offsetof(struct work_s, node))
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -67,6 +90,9 @@ struct kworker_s
   FAR struct work_s *work;     /* The work structure */
   sem_t             wait;      /* Sync waiting for worker done */
   int16_t           wait_count;
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+  clock_t           start;     /* Time when the work was started */
+#endif
 };
 
 /* This structure defines the state of one kernel-mode work queue */
@@ -74,13 +100,30 @@ struct kworker_s
 struct kwork_wqueue_s
 {
   struct list_node expired;   /* The queue of expired work. */
+#ifndef CONFIG_WQUEUE_TIMER_WHEEL
   struct list_node pending;   /* The queue of pending work. */
+#endif
   sem_t            sem;       /* The counting semaphore of the wqueue */
   sem_t            exsem;     /* Sync waiting for thread exit */
   spinlock_t       lock;      /* Spinlock */
   uint8_t          nthreads;  /* Number of worker threads */
   bool             exit;      /* A flag to request the thread to exit */
   struct wdog_s    timer;     /* Timer to pending. */
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+  struct wd_wheel_s pending;  /* The wheel of pending work. */
+#endif
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+  uint8_t          nidle;      /* Workers waiting for the semaphore */
+  uint8_t          nfree;      /* Workers awake and not running work */
+  uint8_t          nwake;      /* Wake-ups posted and not yet taken */
+  uint8_t          minthreads; /* Workers that never exit */
+  uint8_t          maxthreads; /* Maximum workers, 0 if fixed */
+  int              priority;   /* Priority of added workers */
+  int              stack_size; /* Stack size of added workers */
+  FAR const char  *name;       /* Name of added workers */
+  struct wdog_s    stall;      /* Checks for workers busy for too long */
+  struct work_s    grow;       /* Adds a worker from the helper queue */
+#endif
 };
 
 /* This structure defines the state of one high-priority work queue.  This
@@ -174,11 +217,20 @@ static inline_function
 bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
                          FAR struct work_s         *work)
 {
+  DEBUGASSERT(wqueue != NULL && work != NULL);
+
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+  wd_wheel_sync(&wqueue->pending, clock_systime_ticks());
+  wd_wheel_insert(&wqueue->pending, &work->node, work->qtime,
+                  WORK_WHEEL_KEYOFF);
+
+  /* Let work_timer_reset() check whether the next wheel event changed */
+
+  return true;
+#else
   FAR struct work_s *curr;
   FAR struct work_s *head;
 
-  DEBUGASSERT(wqueue != NULL && work != NULL);
-
   /* Insert the work into the wait queue sorted by the expired time. */
 
   head = list_first_entry(&wqueue->pending, struct work_s, node);
@@ -207,6 +259,7 @@ bool work_insert_pending(FAR struct kwork_wqueue_s *wqueue,
    */
 
   return curr == head;
+#endif
 }
 
 /****************************************************************************
@@ -229,6 +282,17 @@ static inline_function
 bool work_remove(FAR struct kwork_wqueue_s *wqueue,
                  FAR struct work_s         *work)
 {
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+  /* Seize the ownership from the work thread. */
+
+  work->worker = NULL;
+
+  /* The work may be either in the wheel or already in the expired list */
+
+  wd_wheel_remove(&wqueue->pending, &work->node);
+
+  return true;
+#else
   FAR struct work_s *head;
 
   head = list_first_entry(&wqueue->pending, struct work_s, node);
@@ -240,6 +304,41 @@ bool work_remove(FAR struct kwork_wqueue_s *wqueue,
   list_delete(&work->node);
 
   return head == work;
+#endif
+}
+
+/****************************************************************************
+ * Name: work_need_wakeup
+ *
+ * Description:
+ *   Internal public function to decide whether the semaphore must be
+ *   posted for newly expired work.  Without concurrency management this
+ *   is always the case.  Otherwise, no worker needs to be woken up if one
+ *   is already awake and not running work, since it will find the work
+ *   before going to sleep, or if every sleeping worker already has a
+ *   wake-up pending.  Require the wqueue lock to be held.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue.
+ *
+ * Returned Value:
+ *   Return whether the caller has to post the semaphore.
+ *
+ ****************************************************************************/
+
+static inline_function
+bool work_need_wakeup(FAR struct kwork_wqueue_s *wqueue)
+{
+#ifdef CONFIG_WQUEUE_CONCURRENCY
+  if (wqueue->nfree > 0 || wqueue->nidle <= wqueue->nwake)
+    {
+      return false;
+    }
+
+  wqueue->nwake++;
+#endif
+
+  return true;
 }
 
 /****************************************************************************
@@ -273,6 +372,24 @@ void work_timer_expired(wdparm_t arg);
 static inline_function
 void work_timer_reset(FAR struct kwork_wqueue_s *wqueue)
 {
+#ifdef CONFIG_WQUEUE_TIMER_WHEEL
+  clock_t next;
+
+  if (wd_wheel_next(&wqueue->pending, &next))
+    {
+      /* Restart the timer only if the next wheel event has changed */
+
+      if (!WDOG_ISACTIVE(&wqueue->timer) || wqueue->timer.expired != next)
+        {
+          wd_start_abstick(&wqueue->timer, next,
+                           work_timer_expired, (wdparm_t)wqueue);
+        }
+    }
+  else
+    {
+      wd_cancel(&wqueue->timer);
+    }
+#else
   if (!list_is_empty(&wqueue->pending))
     {
       FAR struct work_s *work;
@@ -286,6 +403,7 @@ void work_timer_reset(FAR struct kwork_wqueue_s *wqueue)
     {
       wd_cancel(&wqueue->timer);
     }
+#endif
 }
 
 /****************************************************************************
@@ -326,6 +444,25 @@ int work_start_highpri(void);
 int work_start_lowpri(void);
 #endif
 
+/****************************************************************************
+ * Name: work_start_cpu
+ *
+ * Description:
+ *   Start the per-CPU, kernel-mode work queues.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   Return zero (OK) on success.  A negated errno value is returned on
+ *   errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPUWORK
+int work_start_cpu(void);
+#endif
+
 /****************************************************************************
  * Name: work_initialize_notifier
  *
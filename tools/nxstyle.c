@@ -670,6 +670,18 @@ static const char *g_white_content_list[] =
   "unzGetCurrentFileInfo64",
   "unzGoToNextFile",
   "unzGoToFirstFile",
+  "unzGetGlobalInfo64",
+  "unzGetFilePos64",
+  "unzGoToFilePos64",
+  "unzStringFileNameCompare",
+  "unzOpenCurrentFile2",
+  "unzGetCurrentFileZStreamPos64",
+  "uInt",
+  "inflateInit2",
+  "inflateReset",
+  "inflatePrime",
+  "inflateGetDictionary",
+  "inflateSetDictionary",
 
   /* Ref:
    * apps/netutils/telnetc/telnetc.c
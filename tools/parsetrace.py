@@ -153,6 +153,19 @@ class SymbolTables(object):
                         return size
         raise ValueError("not found type")
 
+    def get_enumvalue(self, enum_name):
+        if not self.elffile.has_dwarf_info():
+            raise ValueError("not found dwarf info!")
+
+        dwarfinfo = self.elffile.get_dwarf_info()
+        for CU in dwarfinfo.iter_CUs():
+            for DIE in CU.iter_DIEs():
+                if DIE.tag == "DW_TAG_enumerator":
+                    name = DIE.attributes["DW_AT_name"].value.decode("utf-8")
+                    if name == enum_name:
+                        return DIE.attributes["DW_AT_const_value"].value
+        raise ValueError("not found enumerator")
+
     def readstring(self, addr):
         data = b""
         while True:
@@ -404,10 +417,28 @@ class ParseBinaryLogTool:
 
 
 class TraceDecoder(SymbolTables):
-    def __init__(self, elffile):
+    # NOTE_DUMP_PRINTF in enum note_type_e, used if the ELF file does not
+    # describe the enumeration
+
+    NOTE_DUMP_PRINTF = 30
+
+    # NOTE_TAG_LOG in enum note_tag_e, followed by one tag per priority
+
+    NOTE_TAG_LOG = 1
+    LOG_PRIORITIES = [
+        "EMERG", "ALERT", "CRIT", "ERROR", "WARN", "NOTICE", "INFO", "DEBUG"
+    ]
+
+    def __init__(self, elffile, freq=None):
         super().__init__(elffile)
         self.data = b""
-        self.typeinfo["time_t"] = "int%d" % (self.get_typesize("time_t") * 8)
+        self.freq = freq
+        self.skip_others = False
+        self.typeinfo["clock_t"] = "uint%d" % (self.get_typesize("clock_t") * 8)
+        try:
+            self.NOTE_DUMP_PRINTF = self.get_enumvalue("NOTE_DUMP_PRINTF")
+        except ValueError:
+            pass
 
     def note_common_define(self):
         note_common = pycstruct.StructDef(alignment=4)
@@ -416,8 +447,7 @@ class TraceDecoder(SymbolTables):
         note_common.add("uint8", "nc_priority")
         note_common.add("uint8", "nc_cpu")
         note_common.add(self.typeinfo["pid_t"], "nc_pid")
-        note_common.add(self.typeinfo["time_t"], "nc_systime_sec")
-        note_common.add(self.typeinfo["long"], "nc_systime_nsec")
+        note_common.add(self.typeinfo["clock_t"], "nc_systime")
         return note_common
 
     def note_printf_define(self, length):
@@ -425,6 +455,7 @@ class TraceDecoder(SymbolTables):
         struct_def.add(self.note_common_define(), "npt_cmn")
         struct_def.add(self.typeinfo["size_t"], "npt_ip")
         struct_def.add(self.typeinfo["size_t"], "npt_fmt")
+        struct_def.add("uint32", "npt_tag")
         struct_def.add("uint32", "npt_type")
         if length > 0:
             struct_def.add("uint8", "npt_data", length=length)
@@ -568,16 +599,22 @@ class TraceDecoder(SymbolTables):
 
     def print_format(self, note):
         payload = dict()
-        payload["time"] = (
-            note["npt_cmn"]["nc_systime_sec"]
-            + note["npt_cmn"]["nc_systime_nsec"] / 1000000000
-        )
+        payload["time"] = note["npt_cmn"]["nc_systime"]
+        if self.freq:
+            payload["time"] = "%.9f" % (payload["time"] / self.freq)
         payload["pid"] = note["npt_cmn"]["nc_pid"]
         payload["cpu"] = (
             0 if "nc_cpu" not in note["npt_cmn"] else note["npt_cmn"]["nc_cpu"]
         )
         payload["format"] = self.readstring(note["npt_fmt"])
-        prefix = "[{time:.9f}] [{pid}] [CPU{cpu}]: ".format(**payload)
+        prefix = "[{time}] [{pid}] [CPU{cpu}]: ".format(**payload)
+
+        # Messages from syslog carry their priority in the tag
+
+        priority = note["npt_tag"] - self.NOTE_TAG_LOG
+        if 0 <= priority < len(self.LOG_PRIORITIES):
+            prefix += "[%6s] " % self.LOG_PRIORITIES[priority]
+
         string = self.printf(payload["format"], note["npt_data"]).rstrip("\n")
         logger.info(prefix + string)
 
@@ -593,7 +630,7 @@ class TraceDecoder(SymbolTables):
                 if nc_length < common_struct.size():
                     raise ValueError("Invalid note length")
 
-                if common_note["nc_type"] == 24:
+                if common_note["nc_type"] == self.NOTE_DUMP_PRINTF:
                     note_struct = self.note_printf_define(0)
                     length = nc_length - note_struct.size()
                     note = note_struct.deserialize(data)
@@ -601,7 +638,7 @@ class TraceDecoder(SymbolTables):
                         note_struct.size() : note_struct.size() + length
                     ]
                     self.print_format(note)
-                else:
+                elif not self.skip_others:
                     raise ValueError("Invalid note type")
             except Exception as e:
                 logger.debug(f"skip one byte, data: {hex(self.data[0])} {e}")
@@ -625,6 +662,17 @@ def parse_arguments():
     parser.add_argument("-t", "--trace", help="original trace file")
     parser.add_argument("-e", "--elf", help="elf file")
     parser.add_argument("-d", "--device", help="Physical serial device name")
+    parser.add_argument(
+        "-l",
+        "--log",
+        help="binary note dump with printf notes, e.g. from CONFIG_SYSLOG_BINARY",
+    )
+    parser.add_argument(
+        "-f",
+        "--freq",
+        help="perf counter frequency in Hz, to show note times in seconds",
+        type=int,
+    )
     parser.add_argument(
         "-b", "--baudrate", help="Physical serial device baud rate", default=115200
     )
@@ -643,13 +691,27 @@ if __name__ == "__main__":
     out_path = args.output if args.output else "trace.systrace"
     logger.setLevel(logging.DEBUG if args.verbose else logging.INFO)
 
-    if args.trace is None and args.device is None:
-        print("error, please add trace file path or device name")
+    if args.trace is None and args.device is None and args.log is None:
+        print("error, please add trace file path, log file path or device name")
         print(
-            "usage: parsetrace.py [-h] [-t TRACE] [-e ELF] [-d DEVICE] [-b BAUDRATE] [-v] [-o OUTPUT]"
+            "usage: parsetrace.py [-h] [-t TRACE] [-e ELF] [-d DEVICE] [-l LOG] "
+            "[-f FREQ] [-b BAUDRATE] [-v] [-o OUTPUT]"
         )
         exit(1)
 
+    if args.log:
+        if args.elf is None:
+            print("error, please add elf file path")
+            exit(1)
+
+        # A dump of the note buffer also holds the other notes, skip them
+
+        decode = TraceDecoder(args.elf, args.freq)
+        decode.skip_others = True
+        with open(args.log, "rb") as f:
+            decode.data = f.read()
+        decode.parse_note()
+
     if args.trace:
         file_type = subprocess.check_output(f"file -b {args.trace}", shell=True)
         file_type = str(file_type, "utf-8").lower()
@@ -692,7 +754,7 @@ if __name__ == "__main__":
             print("error, please add elf file path")
             exit(1)
 
-        decode = TraceDecoder(args.elf)
+        decode = TraceDecoder(args.elf, args.freq)
         with serial.Serial(args.device, baudrate=args.baudrate) as ser:
             ser.timeout = 0
             decode.tty_received()